@@ -0,0 +1,98 @@
+#ifndef _HARD_SIGMOID_FUNC_H_
+#define _HARD_SIGMOID_FUNC_H_
+
+#include "activationFunctions/activationFuncBase.h"
+#include "activationFunctions/lambdaParamFunc.h"
+#include "activationFunctions/piecewiseLinear.h"
+
+namespace NNLib
+{
+
+	/**
+	Hard sigmoid activation function - piecewise linear approximation of the
+	sigmoid with the same value and slope in zero.
+	f(x) = 0                    ... for x < -2 / lambda
+	       lambda * x / 4 + 0.5 ... for -2 / lambda <= x <= 2 / lambda
+	       1                    ... for x > 2 / lambda
+	*/
+	template <typename T>
+	class HardSigmoidFunc :
+		public ActivationFuncBase<T>,
+		public LambdaParamFunc<T, 1>
+	{
+	private:
+		typedef ActivationFuncBase<T> _ActivationFuncBase;
+		typedef LambdaParamFunc<T, 1> _LambdaParamFunc;
+		
+	public:
+		typedef typename _ActivationFuncBase::ValueType ValueType;
+		typedef typename _ActivationFuncBase::ResultType ResultType;
+		typedef typename _LambdaParamFunc::ParamType ParamType;
+		
+		HardSigmoidFunc(ParamType lambda = _LambdaParamFunc::DEF_LAMBDA_VAL) :
+		_LambdaParamFunc(lambda)
+		{}
+
+		// interface ActivationFunc:
+
+		ResultType function(ValueType x) const
+		{
+			const ResultType y = static_cast<ResultType>( getSlope() * x + 0.5 );
+			return (y < 0) ? 0 : ( (y > 1) ? 1 : y );
+		}
+
+		inline ResultType operator()(ValueType x) const
+		{
+			return function(x);
+		}
+
+		/** Evaluate the function for an array of values. */
+		void function(const ValueType x[], ResultType y[], size_t len) const
+		{
+			evalClampedLinear( x, y, len, getSlope(), HALF, ZERO, ONE );
+		}
+
+		// interface DerivableActivationFunc:
+
+		ResultType derivation(ValueType x) const
+		{
+			return valDerivation( function(x) );
+		}
+
+		// interface ValDerivableActivationFunc:
+
+		ResultType valDerivation(ResultType y) const
+		{
+			return (y > 0 && y < 1) ? getSlope() : 0;
+		}
+
+		/** Evaluate derivations for an array of functional values. */
+		void valDerivation(const ResultType y[], ResultType d[], size_t len) const
+		{
+			evalClampedLinearValDerivation(y, d, len, getSlope(), ZERO, ONE);
+		}
+
+	protected:
+		static const ResultType ZERO, HALF, ONE;
+
+		inline ResultType getSlope() const
+		{
+			return static_cast<ResultType>( 0.25 * this->m_lambda );
+		}
+	};
+
+	template <typename T>
+	const typename HardSigmoidFunc<T>::ResultType HardSigmoidFunc<T>::ZERO =
+		static_cast<typename HardSigmoidFunc<T>::ResultType>( 0 );
+
+	template <typename T>
+	const typename HardSigmoidFunc<T>::ResultType HardSigmoidFunc<T>::HALF =
+		static_cast<typename HardSigmoidFunc<T>::ResultType>( 0.5f );
+
+	template <typename T>
+	const typename HardSigmoidFunc<T>::ResultType HardSigmoidFunc<T>::ONE =
+		static_cast<typename HardSigmoidFunc<T>::ResultType>( 1 );
+
+}
+
+#endif
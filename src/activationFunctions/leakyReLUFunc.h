@@ -0,0 +1,86 @@
+#ifndef _LEAKY_RELU_FUNC_H_
+#define _LEAKY_RELU_FUNC_H_
+
+#include "activationFunctions/activationFuncBase.h"
+#include "activationFunctions/piecewiseLinear.h"
+
+namespace NNLib
+{
+
+	/**
+	Leaky rectified linear activation function. The leak has to be positive
+	so the derivation can be found from the functional value.
+	f(x) = leak * x ... for x < 0
+	       x        ... for x >= 0
+	*/
+	template <typename T>
+	class LeakyReLUFunc :
+		public ActivationFuncBase<T>
+	{
+	private:
+		typedef ActivationFuncBase<T> _ActivationFuncBase;
+		
+	public:
+		typedef typename _ActivationFuncBase::ValueType ValueType;
+		typedef typename _ActivationFuncBase::ResultType ResultType;
+		typedef T ParamType;
+
+		static const ParamType DEF_LEAK;
+
+		LeakyReLUFunc(ParamType leak = DEF_LEAK) :
+		m_leak(leak)
+		{}
+
+		inline ParamType getLeak() const { return m_leak; }
+		inline void setLeak(ParamType leak) { m_leak = leak; }
+
+		// interface ActivationFunc:
+
+		ResultType function(ValueType x) const
+		{
+			return static_cast<ResultType>( (x < 0) ? m_leak * x : x );
+		}
+
+		inline ResultType operator()(ValueType x) const
+		{
+			return function(x);
+		}
+
+		/** Evaluate the function for an array of values. */
+		void function(const ValueType x[], ResultType y[], size_t len) const
+		{
+			evalLeakyLinear(x, y, len, m_leak);
+		}
+
+		// interface DerivableActivationFunc:
+
+		ResultType derivation(ValueType x) const
+		{
+			return valDerivation( function(x) );
+		}
+
+		// interface ValDerivableActivationFunc:
+
+		ResultType valDerivation(ResultType y) const
+		{
+			return static_cast<ResultType>( (y < 0) ? m_leak : 1 );
+		}
+
+		/** Evaluate derivations for an array of functional values. */
+		void valDerivation(const ResultType y[], ResultType d[], size_t len) const
+		{
+			evalLeakyLinearValDerivation(y, d, len, m_leak);
+		}
+
+	protected:
+		/** Slope of the function for negative values. */
+		ParamType m_leak;
+	};
+
+	template <typename T>
+	const typename LeakyReLUFunc<T>::ParamType LeakyReLUFunc<T>::DEF_LEAK =
+		static_cast<typename LeakyReLUFunc<T>::ParamType>( 0.01f );
+
+}
+
+#endif
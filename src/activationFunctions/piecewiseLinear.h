@@ -0,0 +1,113 @@
+#ifndef _PIECEWISE_LINEAR_H_
+#define _PIECEWISE_LINEAR_H_
+
+#include "common/simd.h"
+
+namespace NNLib
+{
+
+	/**
+	Bulk kernels of the piecewise linear activation functions. Generic versions
+	are plain loops, the float versions use SSE (if available) - four values at
+	once without any branches. The arrays don't have to be aligned.
+
+	They are standalone helpers behind the array overloads of function() and
+	valDerivation() of the functions (e.g. ReLUFunc) for code working on whole
+	arrays of values of one function object. FeedForwardLayer and the gradient
+	evaluators don't use them - every neuron has its own function object, so
+	they call the scalar versions neuron by neuron.
+	*/
+
+	/** y = min(max(slope * x + offset, lo), hi) */
+	template <typename T>
+	void evalClampedLinear(const T x[], T y[], size_t len, T slope, T offset, T lo, T hi)
+	{
+		for (size_t i = 0; i < len; ++i) {
+			const T val = slope * x[i] + offset;
+			y[i] = (val < lo) ? lo : ( (val > hi) ? hi : val );
+		}
+	}
+
+	/** d = slope for lo < y < hi, 0 otherwise */
+	template <typename T>
+	void evalClampedLinearValDerivation(const T y[], T d[], size_t len, T slope, T lo, T hi)
+	{
+		for (size_t i = 0; i < len; ++i)
+			d[i] = (y[i] > lo && y[i] < hi) ? slope : 0;
+	}
+
+	/** y = x for x >= 0, leak * x otherwise */
+	template <typename T>
+	void evalLeakyLinear(const T x[], T y[], size_t len, T leak)
+	{
+		for (size_t i = 0; i < len; ++i)
+			y[i] = (x[i] >= 0) ? x[i] : leak * x[i];
+	}
+
+	/** d = 1 for y >= 0, leak otherwise (for a positive leak) */
+	template <typename T>
+	void evalLeakyLinearValDerivation(const T y[], T d[], size_t len, T leak)
+	{
+		for (size_t i = 0; i < len; ++i)
+			d[i] = (y[i] >= 0) ? 1 : leak;
+	}
+
+
+	#ifdef NNLIB_HAS_SSE
+
+	inline void evalClampedLinear(const float x[], float y[], size_t len,
+		float slope, float offset, float lo, float hi)
+	{
+		const __m128 mslope = _mm_set1_ps(slope), moffset = _mm_set1_ps(offset);
+		const __m128 mlo = _mm_set1_ps(lo), mhi = _mm_set1_ps(hi);
+		const size_t vecLen = len - len % SSE_FLOATS;
+		for (size_t i = 0; i < vecLen; i += SSE_FLOATS) {
+			__m128 val = _mm_add_ps( _mm_mul_ps(mslope, _mm_loadu_ps(x + i)), moffset );
+			_mm_storeu_ps( y + i, _mm_min_ps(_mm_max_ps(val, mlo), mhi) );
+		}
+		evalClampedLinear<float>(x + vecLen, y + vecLen, len - vecLen, slope, offset, lo, hi);
+	}
+
+	inline void evalClampedLinearValDerivation(const float y[], float d[], size_t len,
+		float slope, float lo, float hi)
+	{
+		const __m128 mslope = _mm_set1_ps(slope);
+		const __m128 mlo = _mm_set1_ps(lo), mhi = _mm_set1_ps(hi);
+		const size_t vecLen = len - len % SSE_FLOATS;
+		for (size_t i = 0; i < vecLen; i += SSE_FLOATS) {
+			const __m128 my = _mm_loadu_ps(y + i);
+			const __m128 inside = _mm_and_ps( _mm_cmpgt_ps(my, mlo), _mm_cmplt_ps(my, mhi) );
+			_mm_storeu_ps( d + i, _mm_and_ps(inside, mslope) );
+		}
+		evalClampedLinearValDerivation<float>(y + vecLen, d + vecLen, len - vecLen, slope, lo, hi);
+	}
+
+	inline void evalLeakyLinear(const float x[], float y[], size_t len, float leak)
+	{
+		const __m128 mleak = _mm_set1_ps(leak), mzero = _mm_setzero_ps();
+		const size_t vecLen = len - len % SSE_FLOATS;
+		for (size_t i = 0; i < vecLen; i += SSE_FLOATS) {
+			const __m128 mx = _mm_loadu_ps(x + i);
+			const __m128 positive = _mm_cmpge_ps(mx, mzero);
+			_mm_storeu_ps( y + i, _mm_or_ps( _mm_and_ps(positive, mx),
+				_mm_andnot_ps(positive, _mm_mul_ps(mleak, mx)) ) );
+		}
+		evalLeakyLinear<float>(x + vecLen, y + vecLen, len - vecLen, leak);
+	}
+
+	inline void evalLeakyLinearValDerivation(const float y[], float d[], size_t len, float leak)
+	{
+		const __m128 mleak = _mm_set1_ps(leak), mone = _mm_set1_ps(1), mzero = _mm_setzero_ps();
+		const size_t vecLen = len - len % SSE_FLOATS;
+		for (size_t i = 0; i < vecLen; i += SSE_FLOATS) {
+			const __m128 positive = _mm_cmpge_ps(_mm_loadu_ps(y + i), mzero);
+			_mm_storeu_ps( d + i, _mm_or_ps( _mm_and_ps(positive, mone), _mm_andnot_ps(positive, mleak) ) );
+		}
+		evalLeakyLinearValDerivation<float>(y + vecLen, d + vecLen, len - vecLen, leak);
+	}
+
+	#endif
+
+}
+
+#endif
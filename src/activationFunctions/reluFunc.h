@@ -0,0 +1,79 @@
+#ifndef _RELU_FUNC_H_
+#define _RELU_FUNC_H_
+
+#include <limits>
+#include "activationFunctions/activationFuncBase.h"
+#include "activationFunctions/piecewiseLinear.h"
+
+namespace NNLib
+{
+
+	/**
+	Rectified linear activation function.
+	f(x) = 0 ... for x < 0
+	       x ... for x >= 0
+	*/
+	template <typename T>
+	class ReLUFunc :
+		public ActivationFuncBase<T>
+	{
+	private:
+		typedef ActivationFuncBase<T> _ActivationFuncBase;
+		
+	public:
+		typedef typename _ActivationFuncBase::ValueType ValueType;
+		typedef typename _ActivationFuncBase::ResultType ResultType;
+
+		// interface ActivationFunc:
+
+		ResultType function(ValueType x) const
+		{
+			return static_cast<ResultType>( (x < 0) ? 0 : x );
+		}
+
+		inline ResultType operator()(ValueType x) const
+		{
+			return function(x);
+		}
+
+		/** Evaluate the function for an array of values. */
+		void function(const ValueType x[], ResultType y[], size_t len) const
+		{
+			evalClampedLinear( x, y, len, ONE, ZERO, ZERO, std::numeric_limits<ResultType>::max() );
+		}
+
+		// interface DerivableActivationFunc:
+
+		ResultType derivation(ValueType x) const
+		{
+			return valDerivation( function(x) );
+		}
+
+		// interface ValDerivableActivationFunc:
+
+		ResultType valDerivation(ResultType y) const
+		{
+			return static_cast<ResultType>( (y > 0) ? 1 : 0 );
+		}
+
+		/** Evaluate derivations for an array of functional values. */
+		void valDerivation(const ResultType y[], ResultType d[], size_t len) const
+		{
+			evalClampedLinearValDerivation( y, d, len, ONE, ZERO, std::numeric_limits<ResultType>::max() );
+		}
+
+	protected:
+		static const ResultType ZERO, ONE;
+	};
+
+	template <typename T>
+	const typename ReLUFunc<T>::ResultType ReLUFunc<T>::ZERO =
+		static_cast<typename ReLUFunc<T>::ResultType>( 0 );
+
+	template <typename T>
+	const typename ReLUFunc<T>::ResultType ReLUFunc<T>::ONE =
+		static_cast<typename ReLUFunc<T>::ResultType>( 1 );
+
+}
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef _SYMMETRIC_HARD_SIGMOID_FUNC_H_
+#define _SYMMETRIC_HARD_SIGMOID_FUNC_H_
+
+#include "activationFunctions/activationFuncBase.h"
+#include "activationFunctions/lambdaParamFunc.h"
+#include "activationFunctions/piecewiseLinear.h"
+
+namespace NNLib
+{
+
+	/**
+	Symmetric hard sigmoid activation function (hard tanh for lambda = 2) -
+	piecewise linear approximation of the symmetric sigmoid with the same
+	slope in zero.
+	f(x) = -1             ... for x < -2 / lambda
+	       lambda * x / 2 ... for -2 / lambda <= x <= 2 / lambda
+	       1              ... for x > 2 / lambda
+	*/
+	template <typename T>
+	class SymmetricHardSigmoidFunc :
+		public ActivationFuncBase<T>,
+		public LambdaParamFunc<T, 1>
+	{
+	private:
+		typedef ActivationFuncBase<T> _ActivationFuncBase;
+		typedef LambdaParamFunc<T, 1> _LambdaParamFunc;
+		
+	public:
+		typedef typename _ActivationFuncBase::ValueType ValueType;
+		typedef typename _ActivationFuncBase::ResultType ResultType;
+		typedef typename _LambdaParamFunc::ParamType ParamType;
+		
+		SymmetricHardSigmoidFunc(ParamType lambda = _LambdaParamFunc::DEF_LAMBDA_VAL) :
+		_LambdaParamFunc(lambda)
+		{}
+
+		// interface ActivationFunc:
+
+		ResultType function(ValueType x) const
+		{
+			const ResultType y = getSlope() * x;
+			return (y < -1) ? -1 : ( (y > 1) ? 1 : y );
+		}
+
+		inline ResultType operator()(ValueType x) const
+		{
+			return function(x);
+		}
+
+		/** Evaluate the function for an array of values. */
+		void function(const ValueType x[], ResultType y[], size_t len) const
+		{
+			evalClampedLinear(x, y, len, getSlope(), ZERO, -ONE, ONE);
+		}
+
+		// interface DerivableActivationFunc:
+
+		ResultType derivation(ValueType x) const
+		{
+			return valDerivation( function(x) );
+		}
+
+		// interface ValDerivableActivationFunc:
+
+		ResultType valDerivation(ResultType y) const
+		{
+			return (y > -1 && y < 1) ? getSlope() : 0;
+		}
+
+		/** Evaluate derivations for an array of functional values. */
+		void valDerivation(const ResultType y[], ResultType d[], size_t len) const
+		{
+			evalClampedLinearValDerivation(y, d, len, getSlope(), -ONE, ONE);
+		}
+
+	protected:
+		static const ResultType ZERO, ONE;
+
+		inline ResultType getSlope() const
+		{
+			return static_cast<ResultType>( 0.5 * this->m_lambda );
+		}
+	};
+
+	template <typename T>
+	const typename SymmetricHardSigmoidFunc<T>::ResultType SymmetricHardSigmoidFunc<T>::ZERO =
+		static_cast<typename SymmetricHardSigmoidFunc<T>::ResultType>( 0 );
+
+	template <typename T>
+	const typename SymmetricHardSigmoidFunc<T>::ResultType SymmetricHardSigmoidFunc<T>::ONE =
+		static_cast<typename SymmetricHardSigmoidFunc<T>::ResultType>( 1 );
+
+}
+
+#endif
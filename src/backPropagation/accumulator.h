@@ -1,7 +1,11 @@
 #ifndef _ACCUMULATOR_H_
 #define	_ACCUMULATOR_H_
 
+#include <cmath>
+#include <cassert>
 #include <limits>
+#include <vector>
+#include <functional>
 #include "initializers/constantInitializer.h"
 
 namespace NNLib
@@ -40,9 +44,24 @@ namespace NNLib
 			m_pos = getCapacity() - 1;
 		}
 		
+		/** Add values accumulated by another accumulator as if they came
+		after the values accumulated by this one. */
+		inline void merge(const MemoryAccumulator& other)
+		{
+			for (size_t i = 0; i < other.getSize(); ++i)
+				accum( other.getMemorized(i) );
+		}
+		
 		inline size_t getCapacity() const
 		{ return CAPACITY; }
 		
+		inline size_t getSize() const
+		{ return m_size; }
+		
+		/** Get the memorized value with the given index (0 is the oldest one). */
+		inline ValueType getMemorized(size_t index) const
+		{ return m_memory[ (m_pos + 1 + getCapacity() - m_size + index) % getCapacity() ]; }
+		
 	protected:
 		ValueType m_memory[CAPACITY];
 		size_t m_size;
@@ -76,6 +95,14 @@ namespace NNLib
 		inline void accum(ValueType val)
 		{ m_lastValue = val; }
 		
+		/** Add values accumulated by another accumulator as if they came
+		after the values accumulated by this one. */
+		inline void merge(const LastAccumulator& other)
+		{
+			if (other.m_lastValue == other.m_lastValue)   // not NaN
+				m_lastValue = other.m_lastValue;
+		}
+		
 		inline ValueType getAccumVal() const
 		{ return m_lastValue; }
 		
@@ -103,6 +130,10 @@ namespace NNLib
 		inline void accum(ValueType val)
 		{ m_sum += val; }
 		
+		/** Add values accumulated by another accumulator. */
+		inline void merge(const SumAccumulator& other)
+		{ m_sum += other.m_sum; }
+		
 		inline ValueType getAccumVal() const
 		{ return m_sum; }
 		
@@ -131,11 +162,19 @@ namespace NNLib
 		inline void accum(ValueType val)
 		{
 			this->next();
-			m_sum -= this->m_memory[this->m_pos];
-			m_sum += val;
+			addToSum( -this->m_memory[this->m_pos] );
+			addToSum(val);
 			this->add(val);
 		}
 		
+		/** Add values accumulated by another accumulator as if they came
+		after the values accumulated by this one. */
+		inline void merge(const MeanAccumulator& other)
+		{
+			for (size_t i = 0; i < other.getSize(); ++i)
+				accum( other.getMemorized(i) );
+		}
+		
 		inline ValueType getAccumVal() const
 		{ return m_sum / static_cast<ValueType>(this->m_size); }
 		
@@ -144,10 +183,23 @@ namespace NNLib
 			_AccumulatorBase::reset();
 			ConstantInitializer<ValueType>(0)(this->m_memory, this->getCapacity());
 			m_sum = 0;
+			m_compensation = 0;
 		}
 		
 	protected:
 		ValueType m_sum;
+		
+		/** Lost low-order bits of the sum (Kahan summation) - without them the
+		sum would drift away as values are being added and subtracted. */
+		ValueType m_compensation;
+		
+		inline void addToSum(ValueType val)
+		{
+			ValueType corrected = val - m_compensation;
+			ValueType sum = m_sum + corrected;
+			m_compensation = (sum - m_sum) - corrected;
+			m_sum = sum;
+		}
 	};
 	
 	template <typename T>
@@ -167,6 +219,13 @@ namespace NNLib
 			++m_size;
 		}
 		
+		/** Add values accumulated by another accumulator. */
+		inline void merge(const MeanAccumulator& other)
+		{
+			m_sum += other.m_sum;
+			m_size += other.m_size;
+		}
+		
 		inline ValueType getAccumVal() const
 		{ return m_sum / static_cast<ValueType>(m_size); }
 		
@@ -182,28 +241,105 @@ namespace NNLib
 	};
 	
 	
-// MIN
+// MONOTONIC
 	
+	/**
+	Extreme (min or max according to the comparator) of the last CAPACITY values.
+	Candidates for the extreme are kept in a deque ordered by the comparator so
+	accumulating a value costs amortized O(1) and the extreme is its front.
+	*/
 	template <typename T,
-		size_t CAPACITY = 0>
-	class MinAccumulator :
+		size_t CAPACITY,
+		typename CompareT>
+	class MonotonicAccumulator :
 		public MemoryAccumulator<T, CAPACITY>
-	{	
+	{
 	public:
 		typedef MemoryAccumulator<T, CAPACITY> _AccumulatorBase;
 		typedef typename _AccumulatorBase::ValueType ValueType;
 		
-		MinAccumulator()
-		{ this->reset(); }
+		MonotonicAccumulator(ValueType emptyVal) :
+		m_emptyVal(emptyVal)
+		{ reset(); }
+		
+		inline void accum(ValueType val)
+		{
+			++m_count;
+			
+			// the oldest candidate has just left the window
+			if ( (m_dequeSize > 0) && (m_dequeIndices[m_dequeFront] + CAPACITY <= m_count) )
+				popFront();
+			
+			// candidates which aren't better than the new value will never be the extreme
+			while ( (m_dequeSize > 0) && !m_compare(m_dequeValues[back()], val) )
+				--m_dequeSize;
+			
+			size_t pos = (m_dequeFront + m_dequeSize) % CAPACITY;
+			m_dequeValues[pos] = val;
+			m_dequeIndices[pos] = m_count;
+			++m_dequeSize;
+			
+			_AccumulatorBase::accum(val);
+		}
+		
+		/** Add values accumulated by another accumulator as if they came
+		after the values accumulated by this one. */
+		inline void merge(const MonotonicAccumulator& other)
+		{
+			for (size_t i = 0; i < other.getSize(); ++i)
+				accum( other.getMemorized(i) );
+		}
+		
+		inline ValueType getAccumVal() const
+		{ return (m_dequeSize > 0) ? m_dequeValues[m_dequeFront] : m_emptyVal; }
 		
-		ValueType getAccumVal() const
+		inline void reset()
 		{
-			ValueType min = std::numeric_limits<ValueType>::max();
-			for (size_t i = 0; i < this->m_size; ++i)
-				if (this->m_memory[i] < min)
-					min = this->m_memory[i];
-			return min;
+			_AccumulatorBase::reset();
+			m_dequeFront = m_dequeSize = 0;
+			m_count = 0;
 		}
+		
+	protected:
+		/** Values of the candidates and their positions in the stream of values. */
+		ValueType m_dequeValues[CAPACITY];
+		size_t m_dequeIndices[CAPACITY];
+		size_t m_dequeFront;
+		size_t m_dequeSize;
+		
+		/** Count of all the accumulated values. */
+		size_t m_count;
+		
+		/** Value returned if nothing has been accumulated. */
+		ValueType m_emptyVal;
+		
+		CompareT m_compare;
+		
+		inline size_t back() const
+		{ return (m_dequeFront + m_dequeSize - 1) % CAPACITY; }
+		
+		inline void popFront()
+		{
+			m_dequeFront = (m_dequeFront + 1) % CAPACITY;
+			--m_dequeSize;
+		}
+	};
+	
+	
+// MIN
+	
+	template <typename T,
+		size_t CAPACITY = 0>
+	class MinAccumulator :
+		public MonotonicAccumulator< T, CAPACITY, std::less<T> >
+	{	
+	public:
+		typedef MonotonicAccumulator< T, CAPACITY, std::less<T> > _AccumulatorBase;
+		typedef typename _AccumulatorBase::ValueType ValueType;
+		
+		MinAccumulator() :
+		_AccumulatorBase( std::numeric_limits<ValueType>::max() )
+		{ }
 	};
 	
 	template <typename T>
@@ -219,6 +355,10 @@ namespace NNLib
 		inline void accum(ValueType val)
 		{ if (val < m_min) m_min = val; }
 		
+		/** Add values accumulated by another accumulator. */
+		inline void merge(const MinAccumulator& other)
+		{ accum(other.m_min); }
+		
 		inline ValueType getAccumVal() const
 		{ return m_min; }
 		
@@ -235,23 +375,15 @@ namespace NNLib
 	template <typename T,
 		size_t CAPACITY = 0>
 	class MaxAccumulator :
-		public MemoryAccumulator<T, CAPACITY>
+		public MonotonicAccumulator< T, CAPACITY, std::greater<T> >
 	{	
 	public:
-		typedef MemoryAccumulator<T, CAPACITY> _AccumulatorBase;
+		typedef MonotonicAccumulator< T, CAPACITY, std::greater<T> > _AccumulatorBase;
 		typedef typename _AccumulatorBase::ValueType ValueType;
 		
-		MaxAccumulator()
-		{ this->reset(); }
-		
-		ValueType getAccumVal() const
-		{
-			ValueType max = std::numeric_limits<ValueType>::min();
-			for (size_t i = 0; i < this->m_size; ++i)
-				if (this->m_memory[i] > max)
-					max = this->m_memory[i];
-			return max;
-		}
+		MaxAccumulator() :
+		_AccumulatorBase( std::numeric_limits<ValueType>::lowest() )
+		{ }
 	};
 
 	template <typename T>
@@ -268,17 +400,263 @@ namespace NNLib
 		inline void accum(ValueType val)
 		{ if (val > m_max) m_max = val; }
 		
+		/** Add values accumulated by another accumulator. */
+		inline void merge(const MaxAccumulator& other)
+		{ accum(other.m_max); }
+		
 		inline ValueType getAccumVal() const
 		{ return m_max; }
 		
 		inline void reset()
-		{ m_max = std::numeric_limits<ValueType>::min(); }
+		{ m_max = std::numeric_limits<ValueType>::lowest(); }
 		
 	protected:
 		ValueType m_max;
 	};
 	
+	
+// VARIANCE
+	
+	/**
+	Variance of all the accumulated values computed by Welford's algorithm.
+	Partial results are merged by Chan's formula so no precision is lost.
+	*/
+	template <typename T>
+	class VarianceAccumulator :
+		public AccumulatorBase<T>
+	{
+	public:
+		typedef AccumulatorBase<T> _AccumulatorBase;
+		typedef typename _AccumulatorBase::ValueType ValueType;
+		
+		VarianceAccumulator()
+		{ reset(); }
+		
+		inline void accum(ValueType val)
+		{
+			++m_count;
+			ValueType delta = val - m_mean;
+			m_mean += delta / static_cast<ValueType>(m_count);
+			m_m2 += delta * (val - m_mean);
+		}
+		
+		/** Add values accumulated by another accumulator. */
+		inline void merge(const VarianceAccumulator& other)
+		{
+			if (other.m_count == 0)
+				return;
+			
+			const size_t count = m_count + other.m_count;
+			const ValueType delta = other.m_mean - m_mean;
+			const ValueType weight = static_cast<ValueType>(other.m_count) / static_cast<ValueType>(count);
+			
+			m_mean += delta * weight;
+			m_m2 += other.m_m2 + delta * delta * static_cast<ValueType>(m_count) * weight;
+			m_count = count;
+		}
+		
+		/** Get the population variance of the accumulated values. */
+		inline ValueType getAccumVal() const
+		{ return (m_count > 0) ? m_m2 / static_cast<ValueType>(m_count) : static_cast<ValueType>(0); }
+		
+		inline ValueType getStdDev() const
+		{ return static_cast<ValueType>( ::sqrt( getAccumVal() ) ); }
+		
+		inline ValueType getMean() const
+		{ return m_mean; }
+		
+		inline size_t getCount() const
+		{ return m_count; }
+		
+		inline void reset()
+		{
+			m_count = 0;
+			m_mean = m_m2 = static_cast<ValueType>(0);
+		}
+		
+	protected:
+		size_t m_count;
+		ValueType m_mean;
+		
+		/** Sum of squared differences from the mean. */
+		ValueType m_m2;
+	};
+	
+	
+// QUANTILE
+	
+	/**
+	Quantile of all the accumulated values estimated by a sketch with the given
+	relative accuracy. Values are counted in buckets with exponentially growing
+	bounds, so the sketch stays small and two sketches with the same accuracy
+	are merged exactly by adding their counts. Infinite values are counted
+	apart as the extreme ones and NaNs aren't ranked at all (only counted).
+	*/
+	template <typename T>
+	class QuantileAccumulator :
+		public AccumulatorBase<T>
+	{
+	public:
+		typedef AccumulatorBase<T> _AccumulatorBase;
+		typedef typename _AccumulatorBase::ValueType ValueType;
+		
+		QuantileAccumulator(double fraction = DEF_FRACTION, double accuracy = DEF_ACCURACY) :
+		m_fraction(fraction),
+		m_gamma( (1 + accuracy) / (1 - accuracy) ),
+		m_logGamma( ::log(m_gamma) )
+		{ reset(); }
+		
+		inline void accum(ValueType val)
+		{
+			if (val != val) {
+				++m_nans;
+				return;
+			}
+			
+			if (val > std::numeric_limits<ValueType>::max())
+				++m_positiveInfs;
+			else if (val < -std::numeric_limits<ValueType>::max())
+				++m_negativeInfs;
+			else if (val > 0)
+				m_positive.add( getBucket(val), 1 );
+			else if (val < 0)
+				m_negative.add( getBucket(-val), 1 );
+			else
+				++m_zeros;
+			++m_count;
+		}
+		
+		/** Add values accumulated by another accumulator (the accuracy of both
+		accumulators has to be the same). */
+		void merge(const QuantileAccumulator& other)
+		{
+			assert(m_gamma == other.m_gamma);
+			m_positive.merge(other.m_positive);
+			m_negative.merge(other.m_negative);
+			m_zeros += other.m_zeros;
+			m_negativeInfs += other.m_negativeInfs;
+			m_positiveInfs += other.m_positiveInfs;
+			m_nans += other.m_nans;
+			m_count += other.m_count;
+		}
+		
+		/** Get the quantile given in the constructor. */
+		inline ValueType getAccumVal() const
+		{ return getQuantile(m_fraction); }
+		
+		/** Get the value which is greater or equal to the given fraction (0..1)
+		of all the accumulated values. */
+		ValueType getQuantile(double fraction) const
+		{
+			if (m_count == 0)
+				return static_cast<ValueType>(0);
+			
+			size_t rank = static_cast<size_t>( fraction * (m_count - 1) + 0.5 );
+			if (rank >= m_count)
+				rank = m_count - 1;
+			
+			if (rank < m_negativeInfs)
+				return -std::numeric_limits<ValueType>::infinity();
+			rank -= m_negativeInfs;
+			
+			// negative values starting by the one with the greatest absolute value
+			for (size_t i = m_negative.counts.size(); i > 0; --i) {
+				if ( rank < m_negative.counts[i-1] )
+					return -getBucketValue( m_negative.offset + static_cast<int>(i-1) );
+				rank -= m_negative.counts[i-1];
+			}
+			
+			if (rank < m_zeros)
+				return static_cast<ValueType>(0);
+			rank -= m_zeros;
+			
+			for (size_t i = 0; i < m_positive.counts.size(); ++i) {
+				if ( rank < m_positive.counts[i] )
+					return getBucketValue( m_positive.offset + static_cast<int>(i) );
+				rank -= m_positive.counts[i];
+			}
+			
+			return std::numeric_limits<ValueType>::infinity();
+		}
+		
+		/** Get count of the ranked values (NaNs aren't included). */
+		inline size_t getCount() const
+		{ return m_count; }
+		
+		inline size_t getNaNCount() const
+		{ return m_nans; }
+		
+		inline void reset()
+		{
+			m_positive.clear();
+			m_negative.clear();
+			m_zeros = m_negativeInfs = m_positiveInfs = m_nans = m_count = 0;
+		}
+		
+	protected:
+		/** Counts of values in consecutive buckets starting by the given one. */
+		struct Buckets
+		{
+			std::vector<size_t> counts;
+			int offset;
+			
+			inline void clear()
+			{
+				counts.clear();
+				offset = 0;
+			}
+			
+			void add(int bucket, size_t count)
+			{
+				if ( counts.empty() )
+					offset = bucket;
+				if (bucket < offset) {
+					counts.insert( counts.begin(), static_cast<size_t>(offset - bucket), 0 );
+					offset = bucket;
+				}
+				size_t index = static_cast<size_t>(bucket - offset);
+				if ( index >= counts.size() )
+					counts.resize(index + 1, 0);
+				counts[index] += count;
+			}
+			
+			void merge(const Buckets& other)
+			{
+				for (size_t i = 0; i < other.counts.size(); ++i)
+					if (other.counts[i] > 0)
+						add( other.offset + static_cast<int>(i), other.counts[i] );
+			}
+		};
+		
+		double m_fraction;
+		double m_gamma;
+		double m_logGamma;
+		
+		Buckets m_positive;
+		Buckets m_negative;
+		size_t m_zeros;
+		size_t m_negativeInfs, m_positiveInfs;
+		size_t m_nans;
+		size_t m_count;
+		
+		static const double DEF_FRACTION;
+		static const double DEF_ACCURACY;
+		
+		/** Bucket i contains values from (gamma^(i-1), gamma^i]. */
+		inline int getBucket(ValueType absVal) const
+		{ return static_cast<int>( ::ceil( ::log( static_cast<double>(absVal) ) / m_logGamma ) ); }
+		
+		/** Value with the smallest relative error to all the values in the bucket. */
+		inline ValueType getBucketValue(int bucket) const
+		{ return static_cast<ValueType>( 2 * ::pow(m_gamma, bucket) / (m_gamma + 1) ); }
+	};
+	
+	template <typename T>
+	const double QuantileAccumulator<T>::DEF_FRACTION = 0.5;
+	
+	template <typename T>
+	const double QuantileAccumulator<T>::DEF_ACCURACY = 0.01;
+	
 }
 
 #endif
-
@@ -0,0 +1,127 @@
+#ifndef _ASYNC_MONITOR_H_
+#define _ASYNC_MONITOR_H_
+
+#include <string>
+#include <ostream>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include "common/spscQueue.h"
+#include "backPropagation/monitor.h"
+
+namespace NNLib
+{
+
+	/**
+	This monitor prints out the given parameter's value the same way as the
+	ParamMonitor but off the training thread. The training thread only copies
+	a snapshot of the parameter to a lock-free queue, a background thread
+	formats and writes the snapshots and flushes the stream only when the queue
+	gets empty, then it sleeps until the next snapshot comes. The snapshot type
+	has to be constructible from the parameter, copy constructible and has to
+	have operator << overloaded - by default it's the nested SnapshotType of
+	the parameter (the continuators have ones holding just the printed values),
+	otherwise the whole parameter is copied. If the queue is full the snapshot
+	is dropped rather than stalling the training. The remaining snapshots are
+	written when the monitor is destroyed.
+	*/
+	template <typename ParamT, typename SnapshotT = typename ParamSnapshot<ParamT>::Type>
+	class AsyncParamMonitor final :
+		public Monitor
+	{
+	public:
+		typedef ParamT ParamType;
+		typedef SnapshotT SnapshotType;
+
+		static const size_t DEF_CAPACITY = 1024;
+
+		AsyncParamMonitor(std::ostream& os, const ParamType& param,
+			unsigned timer = DEF_TIMER, const std::string& delim = "",
+			size_t capacity = DEF_CAPACITY) :
+		Monitor(timer), m_ostream(os), m_param(param), m_delim(delim),
+		m_queue(capacity), m_droppedCount(0), m_running(true), m_waiting(false)
+		{
+			m_writer = std::thread(&AsyncParamMonitor::write, this);
+		}
+
+		virtual ~AsyncParamMonitor()
+		{
+			m_running.store(false, std::memory_order_release);
+			wakeWriter();
+			m_writer.join();
+		}
+
+		virtual void execute()
+		{
+			if ( !m_queue.push( SnapshotType(m_param) ) ) {
+				++m_droppedCount;
+				return;
+			}
+
+			// the mutex is locked only if the writer sleeps (pairs with the fence in write())
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if ( m_waiting.load(std::memory_order_relaxed) )
+				wakeWriter();
+		}
+
+		/** Get count of snapshots dropped because the queue was full. */
+		inline size_t getDroppedCount() const { return m_droppedCount; }
+
+	protected:
+		std::ostream& m_ostream;
+		const ParamType& m_param;
+		const std::string m_delim;
+
+		SPSCQueue<SnapshotType> m_queue;
+		size_t m_droppedCount;
+
+		std::atomic<bool> m_running;
+		std::thread m_writer;
+
+		/** Whether the writer sleeps (or is going to) on the empty queue. */
+		std::atomic<bool> m_waiting;
+		std::mutex m_mutex;
+		std::condition_variable m_wakeUp;
+
+		void wakeWriter()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_wakeUp.notify_one();
+		}
+
+		/** Body of the writer thread. */
+		void write()
+		{
+			for (;;)
+			{
+				// read the flag before draining so nothing pushed before the stop is lost
+				const bool running = m_running.load(std::memory_order_acquire);
+				bool written = false;
+				for (const SnapshotType *snapshot; (snapshot = m_queue.front()) != NULL; m_queue.pop()) {
+					m_ostream << *snapshot << "\n" << m_delim;
+					written = true;
+				}
+				if (written)
+					m_ostream.flush();
+				if (!running)
+					break;
+
+				// either the producer sees the flag or this thread sees the new snapshot
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_waiting.store(true, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				while ( m_queue.front() == NULL && m_running.load(std::memory_order_acquire) )
+					m_wakeUp.wait(lock);
+				m_waiting.store(false, std::memory_order_relaxed);
+			}
+		}
+
+	private:
+		AsyncParamMonitor(const AsyncParamMonitor&);
+		AsyncParamMonitor& operator=(const AsyncParamMonitor&);
+	};
+
+}
+
+#endif
@@ -1,15 +1,21 @@
 #ifndef _BACK_PROP_BASE_H_
 #define	_BACK_PROP_BASE_H_
 
+#include "common/sparseVector.h"
 #include "feedForward/networkBufferAllocator.h"
 #include "backPropagation/continuator.h"
+#include "backPropagation/frozenPrefixCache.h"
 #include "backPropagation/monitor.h"
+#include "backPropagation/profiler.h"
 
 namespace NNLib
 {
 
 	/**
-	Back-propagation algorithm for a feed-forward layered network.
+	Back-propagation algorithm for a feed-forward layered network. Frozen layers
+	of the network aren't trained, outputs of the frozen layers at its beginning
+	can be cached for every pattern (see setFrozenPrefixCaching()). The gradient
+	can be evaluated and applied layer by layer (see setFusedUpdate()).
 	*/
 	template <typename NetworkT,
 		template <typename> class WeightsStepsEvalT,
@@ -30,15 +36,29 @@ namespace NNLib
 		BackPropBase(NetworkType& network) :
 		WeightsStepsEvalType(network),
 		WeightsUpdaterType(network),
-		m_network(network)
-		{
-			m_gradient = createWeightsBuffer<WeightType>(m_network);
-		}
+		m_network(network), m_gradient(network), m_cachePrefix(false), m_fusedUpdate(false)
+		{ }
 
-		~BackPropBase()
-		{
-			deleteWeightsBuffer(m_gradient);
-		}
+		/** Update weights of every layer tile by tile of its rows as soon as their
+		gradient is evaluated (while it's in the cache) instead of evaluating the
+		whole gradient first and updating all the weights after it. Deltas are
+		always evaluated with the old weights so the result is the same. It's used
+		only for patterns with dense inputs, the layer profiles of PHASE_UPDATE
+		then include the gradient of the layer and they are measured inside
+		PHASE_GRADIENT. */
+		inline void setFusedUpdate(bool fused) { m_fusedUpdate = fused; }
+		inline bool isFusedUpdate() const { return m_fusedUpdate; }
+
+		/** Evaluate the frozen layers at the beginning of the network only once
+		per pattern and start the later evaluations of the pattern from their
+		cached outputs. The cache has to be cleared by clearFrozenPrefixCache()
+		if the weights of the frozen layers or the patterns change (change of
+		the frozen layers clears it automatically). */
+		inline void setFrozenPrefixCaching(bool cache) { m_cachePrefix = cache; }
+		inline bool isFrozenPrefixCaching() const { return m_cachePrefix; }
+
+		inline void clearFrozenPrefixCache() { m_prefixCache.clear(); }
+		inline const FrozenPrefixCache<OutputType>& getFrozenPrefixCache() const { return m_prefixCache; }
 
 		template <typename DataAccessT>
 		inline void run(DataAccessT& accessor)
@@ -48,26 +68,44 @@ namespace NNLib
 			return run(accessor, continuator, monitor);
 		}
 
-		template <typename DataAccessT, typename ContinuatorT>
-		void run(DataAccessT& accessor, ContinuatorT& continuator, Monitor& monitor)
+		template <typename DataAccessT, typename ContinuatorT, typename MonitorT>
+		inline void run(DataAccessT& accessor, ContinuatorT& continuator, MonitorT& monitor)
+		{
+			EmptyProfiler profiler;
+			run(accessor, continuator, monitor, profiler);
+		}
+
+		/** Run the algorithm and measure its single phases by the given profiler.
+		The monitor is called through its static type (see callMonitor()). */
+		template <typename DataAccessT, typename ContinuatorT, typename MonitorT, typename ProfilerT>
+		void run(DataAccessT& accessor, ContinuatorT& continuator, MonitorT& monitor, ProfilerT& profiler)
 		{
 			for ( accessor.begin(); !accessor.isEnd(); accessor.next() )
 			{
 				const typename DataAccessT::DataType& pattern = accessor.current();
 
 				// get output for the given input
-				m_network.eval( pattern.getInput() );
+				profiler.begin(PHASE_EVAL);
+				if (m_cachePrefix)
+					evalNetworkCached( pattern, profiler );
+				else
+					evalNetwork( pattern.getInput(), profiler );
+				profiler.end(PHASE_EVAL);
 
 				// check the continuation condition
-				if ( !continuator() )
+				profiler.begin(PHASE_CONTINUATOR);
+				const bool cont = continuator();
+				profiler.end(PHASE_CONTINUATOR);
+				if (!cont)
 					break;
 
 				// run one step of the back-propagation algorithm
-				evalGradient( pattern.getInput(), pattern.getOutput(), m_gradient );
-				updateWeights( m_gradient );
+				trainPattern( pattern.getInput(), pattern.getOutput(), profiler );
 
 				// monitor run of the back-propagation algorithm
-				monitor();
+				profiler.begin(PHASE_MONITOR);
+				callMonitor(monitor);
+				profiler.end(PHASE_MONITOR);
 			}
 		}
 
@@ -83,7 +121,189 @@ namespace NNLib
 		NetworkType& m_network;
 
 		/** Gradient of the error function (partial derivations of weights). */
-		WeightType ***m_gradient;
+		WeightsBuffer<WeightType> m_gradient;
+
+		/** Whether outputs of the frozen prefix are cached. */
+		bool m_cachePrefix;
+		FrozenPrefixCache<OutputType> m_prefixCache;
+
+		/** Whether the weights are updated layer by layer with the gradient. */
+		bool m_fusedUpdate;
+
+		/** Functor updating rows of weights of a single layer by the gradient. */
+		struct LayerUpdater
+		{
+			BackPropBase& backProp;
+
+			inline void operator()(size_t layer, size_t firstRow, size_t rowsCount)
+			{
+				backProp.forLayerWeightsRows( static_cast<WeightsUpdaterType&>(backProp),
+					layer, firstRow, rowsCount );
+			}
+		};
+
+		/** Eval the gradient for a dense input and update the weights by it. */
+		template <typename InputT, typename ProfilerT>
+		void trainPattern(const InputT *input, const OutputType *expectedOutput, ProfilerT& profiler)
+		{
+			if (m_fusedUpdate) {
+				LayerUpdater updater = { *this };
+				profiler.begin(PHASE_GRADIENT);
+				this->beginUpdate( m_gradient );
+				this->evalFusedGradient( input, expectedOutput, m_gradient, updater, profiler );
+				profiler.end(PHASE_GRADIENT);
+				return;
+			}
+
+			profiler.begin(PHASE_GRADIENT);
+			this->evalGradient( input, expectedOutput, m_gradient, profiler );
+			profiler.end(PHASE_GRADIENT);
+
+			profiler.begin(PHASE_UPDATE);
+			updateNetworkWeights(input);
+			profiler.end(PHASE_UPDATE);
+		}
+
+		/** Eval the gradient for a sparse input and update the weights by it. */
+		template <typename InputT, typename ProfilerT>
+		void trainPattern(const SparseVector<InputT>& input, const OutputType *expectedOutput, ProfilerT& profiler)
+		{
+			profiler.begin(PHASE_GRADIENT);
+			this->evalGradient( input, expectedOutput, m_gradient, profiler );
+			profiler.end(PHASE_GRADIENT);
+
+			profiler.begin(PHASE_UPDATE);
+			updateNetworkWeights(input);
+			profiler.end(PHASE_UPDATE);
+		}
+
+		/** Functor evaluating the single layers of the network. */
+		template <typename InputT, typename ProfilerT>
+		struct LayerEvaluator
+		{
+			const InputT *input;
+			ProfilerT& profiler;
+
+			template <typename LayerT>
+			inline void operator()(LayerT& layer, size_t index)
+			{
+				profiler.beginLayer(PHASE_EVAL, index);
+				input = layer.eval(input);
+				profiler.endLayer(PHASE_EVAL, index);
+			}
+		};
+
+		/** Functor evaluating the single layers of the network for a sparse
+		input of the first layer. */
+		template <typename InputT, typename ProfilerT>
+		struct SparseLayerEvaluator
+		{
+			const SparseVector<InputT>& firstInput;
+			const InputT *input;
+			ProfilerT& profiler;
+
+			template <typename LayerT>
+			inline void operator()(LayerT& layer, size_t index)
+			{
+				profiler.beginLayer(PHASE_EVAL, index);
+				input = (index == 0) ? layer.eval(firstInput) : layer.eval(input);
+				profiler.endLayer(PHASE_EVAL, index);
+			}
+		};
+
+		/** Eval the network layer by layer so every layer can be profiled. */
+		template <typename InputT, typename ProfilerT>
+		inline void evalNetwork(const InputT *input, ProfilerT& profiler)
+		{
+			LayerEvaluator<InputT, ProfilerT> evaluator = { input, profiler };
+			m_network.forEachLayer(evaluator);
+		}
+
+		template <typename InputT, typename ProfilerT>
+		inline void evalNetwork(const SparseVector<InputT>& input, ProfilerT& profiler)
+		{
+			SparseLayerEvaluator<InputT, ProfilerT> evaluator = { input, NULL, profiler };
+			m_network.forEachLayer(evaluator);
+		}
+
+		/** Functor evaluating the layers after the frozen prefix, the last layer
+		of the prefix gets its cached outputs. */
+		template <typename ProfilerT>
+		struct CachedLayerEvaluator
+		{
+			const OutputType *cached;
+			size_t prefixLength;
+			const OutputType *input;
+			ProfilerT& profiler;
+
+			template <typename LayerT>
+			inline void operator()(LayerT& layer, size_t index)
+			{
+				if (index + 1 == prefixLength) {
+					layer.restoreOutputCache(cached);
+					input = layer.getOutputCache();
+				}
+				else if (index >= prefixLength) {
+					profiler.beginLayer(PHASE_EVAL, index);
+					input = layer.eval(input);
+					profiler.endLayer(PHASE_EVAL, index);
+				}
+			}
+		};
+
+		/** Functor storing outputs of the last layer of the frozen prefix. */
+		struct PrefixOutputsStore
+		{
+			FrozenPrefixCache<OutputType>& cache;
+			const void *pattern;
+
+			template <typename LayerT>
+			inline void operator()(const LayerT& layer, size_t index)
+			{
+				if (index + 1 == cache.getPrefixLength())
+					cache.store( pattern, layer.getOutputCache(), layer.getNeuronsCount() );
+			}
+		};
+
+		/** Eval the network for the given pattern using the cached outputs of the
+		frozen prefix (they are evaluated and cached if the pattern is new). */
+		template <typename PatternT, typename ProfilerT>
+		void evalNetworkCached(const PatternT& pattern, ProfilerT& profiler)
+		{
+			const size_t prefixLength = m_network.getFrozenPrefixLength();
+			if ( prefixLength != m_prefixCache.getPrefixLength() )
+				m_prefixCache.reset(prefixLength);
+			if (prefixLength == 0 || prefixLength == m_network.getLayersCount()) {
+				evalNetwork( pattern.getInput(), profiler );
+				return;
+			}
+
+			const OutputType *cached = m_prefixCache.find(&pattern);
+			if (cached == NULL) {
+				evalNetwork( pattern.getInput(), profiler );
+				PrefixOutputsStore store = { m_prefixCache, &pattern };
+				m_network.forEachLayer(store);
+				return;
+			}
+
+			CachedLayerEvaluator<ProfilerT> evaluator = { cached, prefixLength, NULL, profiler };
+			m_network.forEachLayer(evaluator);
+		}
+
+		/** Update all the weights by the gradient of a dense input. */
+		template <typename InputT>
+		inline void updateNetworkWeights(const InputT *)
+		{
+			this->updateWeights( m_gradient );
+		}
+
+		/** Update the weights by the gradient of a sparse input - only the weights
+		of its non-zero values in the first layer. */
+		template <typename InputT>
+		inline void updateNetworkWeights(const SparseVector<InputT>& input)
+		{
+			this->updateWeights( m_gradient, input );
+		}
 
 	private:
 		BackPropBase& operator=(const BackPropBase&);
@@ -0,0 +1,197 @@
+#ifndef _BATCH_GRADIENT_EVALUATOR_H_
+#define _BATCH_GRADIENT_EVALUATOR_H_
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include "common/threads.h"
+#include "common/utils.h"
+#include "feedForward/networkBufferAllocator.h"
+#include "feedForward/softmaxLayer.h"
+#include "backPropagation/gradientEvaluator.h"
+
+namespace NNLib
+{
+
+	/**
+	Evaluator of the error function and its exact gradient over the whole data
+	container (an epoch) for the batch trainers. The data are split among more
+	threads, every thread works on its own copy of the network by its own
+	DeltaGradientEvaluator and sums gradients of its patterns to its own buffer,
+	the buffers are summed at the end.
+
+	The error function matches the one of DeltaGradientEvaluator - half of the
+	squared error, or the cross-entropy for a SoftmaxLayer on the output - summed
+	over all the patterns. The network has to be copyable (FeedForwardNetwork)
+	and the patterns have to have dense inputs.
+	*/
+	template <typename NetworkT, typename ContT>
+	class BatchGradientEvaluator
+	{
+	public:
+		typedef NetworkT NetworkType;
+		typedef typename NetworkType::WeightType WeightType;
+		typedef typename NetworkType::InputType InputType;
+		typedef typename NetworkType::OutputType OutputType;
+		typedef typename NetworkType::OutputType ErrorType;
+		typedef ContT ContainerType;
+		typedef typename ContainerType::value_type DataType;
+		typedef WeightsBuffer<WeightType> GradientType;
+
+		/** Zero count of threads means to use all the hardware threads. */
+		BatchGradientEvaluator(const NetworkType& network, const ContainerType& data, size_t threadsCount = 0) :
+		m_data(data), m_weights(NULL), m_evalGradient(false)
+		{
+			const size_t usedCount = getUsedThreadsCount(data.size(), threadsCount);
+			for (size_t thread = 0; thread < usedCount; ++thread)
+				m_workers.push_back( new Worker(network) );
+		}
+
+		~BatchGradientEvaluator()
+		{
+			deleteRange( m_workers.begin(), m_workers.end() );
+		}
+
+		/** Eval the error of the given weights (getWeightsSize() values in the
+		layout of saveWeights()) and its gradient to the given buffer. */
+		ErrorType evalGradient(const WeightType weights[], GradientType& gradient)
+		{
+			evalEpoch(weights, true);
+
+			// sum the gradients of the threads
+			gradient.copyFrom( m_workers[0]->gradient );
+			WeightType *sum = gradient.getData();
+			for (size_t thread = 1; thread < m_workers.size(); ++thread) {
+				const WeightType *part = m_workers[thread]->gradient.getData();
+				for (size_t i = 0; i < gradient.getSize(); ++i)
+					sum[i] += part[i];
+			}
+			return getEpochError();
+		}
+
+		/** Eval only the error of the given weights. */
+		ErrorType evalError(const WeightType weights[])
+		{
+			evalEpoch(weights, false);
+			return getEpochError();
+		}
+
+		inline size_t getThreadsCount() const { return m_workers.size(); }
+
+		/** Get copy of the network of the given thread (for other evaluators
+		working in the same threads, it gets the weights of every epoch). */
+		inline NetworkType& getNetwork(size_t thread) { return m_workers[thread]->network; }
+		inline const ContainerType& getData() const { return m_data; }
+
+		/** Evaluate patterns [begin, end) in the given thread (used by parallelFor). */
+		void operator()(size_t thread, size_t begin, size_t end)
+		{
+			Worker& worker = *m_workers[thread];
+			worker.network.restoreWeights(m_weights);
+			worker.gradient.fill(0);
+			worker.error = 0;
+
+			WeightType *sum = worker.gradient.getData();
+			const WeightType *patternGradient = worker.patternGradient.getData();
+			const size_t size = worker.gradient.getSize();
+
+			for (size_t p = begin; p < end; ++p)
+			{
+				const DataType& pattern = m_data[p];
+				worker.network.eval( pattern.getInput() );
+
+				OutputErrorEvaluator errorEvaluator = { pattern.getOutput(), worker.network.getLayersCount(), 0 };
+				worker.network.forEachLayerBackward(errorEvaluator);
+				worker.error += errorEvaluator.error;
+
+				if (m_evalGradient) {
+					worker.evaluator.evalGradient( pattern.getInput(), pattern.getOutput(), worker.patternGradient );
+					for (size_t i = 0; i < size; ++i)
+						sum[i] += patternGradient[i];
+				}
+			}
+		}
+
+	protected:
+		/** Copy of the network and buffers of one thread. */
+		struct Worker
+		{
+			NetworkType network;
+			DeltaGradientEvaluator<NetworkType> evaluator;
+			GradientType patternGradient, gradient;
+			ErrorType error;
+
+			Worker(const NetworkType& original) :
+			network(original), evaluator(network), patternGradient(network), gradient(network), error(0)
+			{ }
+		};
+
+		/** Functor evaluating error of the output layer for the expected output. */
+		struct OutputErrorEvaluator
+		{
+			const OutputType *expectedOutput;
+			size_t layersCount;
+			ErrorType error;
+
+			template <typename LayerT>
+			inline void operator()(const LayerT& layer, size_t index)
+			{
+				if (index + 1 == layersCount)
+					error = evalPatternError(layer, expectedOutput);
+			}
+		};
+
+		const ContainerType& m_data;
+		std::vector<Worker*> m_workers;
+
+		/** Weights of the evaluated epoch. */
+		const WeightType *m_weights;
+		bool m_evalGradient;
+
+		void evalEpoch(const WeightType weights[], bool evalGradient)
+		{
+			m_weights = weights;
+			m_evalGradient = evalGradient;
+			parallelFor( m_data.size(), m_workers.size(), *this );
+		}
+
+		ErrorType getEpochError() const
+		{
+			ErrorType error = 0;
+			for (size_t thread = 0; thread < m_workers.size(); ++thread)
+				error += m_workers[thread]->error;
+			return error;
+		}
+
+		/** Half of the squared error of the output cached in the layer. */
+		template <typename LayerT>
+		static ErrorType evalPatternError(const LayerT& layer, const OutputType expectedOutput[])
+		{
+			const OutputType *realOutput = layer.getOutputCache();
+			ErrorType error = 0;
+			for (size_t i = 0; i < layer.getNeuronsCount(); ++i)
+				error += ( realOutput[i] - expectedOutput[i] ) * ( realOutput[i] - expectedOutput[i] );
+			return error / 2;
+		}
+
+		/** Cross-entropy of the output cached in the softmax layer. */
+		template <typename NeuronT>
+		static ErrorType evalPatternError(const SoftmaxLayer<NeuronT>& layer, const OutputType expectedOutput[])
+		{
+			static const OutputType MIN_OUTPUT = static_cast<OutputType>(1e-30);
+			const OutputType *realOutput = layer.getOutputCache();
+			ErrorType error = 0;
+			for (size_t i = 0; i < layer.getNeuronsCount(); ++i)
+				if (expectedOutput[i] != 0)
+					error -= expectedOutput[i] * std::log( std::max(realOutput[i], MIN_OUTPUT) );
+			return error;
+		}
+
+	private:
+		BatchGradientEvaluator(const BatchGradientEvaluator&);
+		BatchGradientEvaluator& operator=(const BatchGradientEvaluator&);
+	};
+
+}
+
+#endif
@@ -0,0 +1,525 @@
+#ifndef _BATCH_TRAINER_H_
+#define _BATCH_TRAINER_H_
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include "common/utils.h"
+#include "feedForward/networkBufferAllocator.h"
+#include "backPropagation/batchGradientEvaluator.h"
+#include "backPropagation/continuator.h"
+#include "backPropagation/monitor.h"
+
+namespace NNLib
+{
+
+	/**
+	Base class for the batch (second-order) trainers of a feed-forward network.
+	Every epoch of the trainers evaluates the exact gradient of the error over
+	all the data by BatchGradientEvaluator (in more threads). The weights, the
+	gradient and all the other vectors of the trainers are WeightsBuffers in
+	the layout of the weights of the network, the network gets the current
+	weights after every epoch.
+
+	The state of a trainer is kept between the runs, reset() has to be called
+	if the weights of the network were changed meanwhile.
+	*/
+	template <typename NetworkT, typename ContT>
+	class BatchTrainerBase
+	{
+	public:
+		typedef NetworkT NetworkType;
+		typedef typename NetworkType::WeightType WeightType;
+		typedef typename NetworkType::OutputType ErrorType;
+		typedef ContT ContainerType;
+		typedef BatchGradientEvaluator<NetworkType, ContainerType> EvaluatorType;
+		typedef typename EvaluatorType::GradientType GradientType;
+
+		/** Default norm of the gradient the training stops at. */
+		static const double DEF_GRADIENT_TOLERANCE;
+
+		/** Zero count of threads means to use all the hardware threads. */
+		BatchTrainerBase(NetworkType& network, const ContainerType& data, size_t threadsCount = 0) :
+		m_network(network), m_evaluator(network, data, threadsCount),
+		m_weights(network), m_gradient(network), m_trial(network), m_trialGradient(network),
+		m_error(0), m_gradientNorm(0), m_tolerance(DEF_GRADIENT_TOLERANCE),
+		m_epochsCount(0), m_evalsCount(0), m_started(false)
+		{ }
+
+		virtual ~BatchTrainerBase() { }
+
+		/** Run at most the given count of epochs. Return count of the performed ones. */
+		inline size_t run(size_t epochsCount)
+		{
+			AlwaysContinue continuator;
+			EmptyMonitor monitor;
+			return run(epochsCount, continuator, monitor);
+		}
+
+		/** Run at most the given count of epochs while the continuator (checked
+		before every epoch) allows it, the gradient is greater than the tolerance
+		and the trainer makes progress. The monitor is called after every epoch.
+		Return count of the performed epochs. */
+		template <typename ContinuatorT, typename MonitorT>
+		size_t run(size_t epochsCount, ContinuatorT& continuator, MonitorT& monitor)
+		{
+			if (!m_started)
+				start();
+
+			size_t epoch = 0;
+			while ( epoch < epochsCount && !isConverged() && continuator() )
+			{
+				const bool progress = step();
+				m_network.restoreWeights(m_weights);
+				++m_epochsCount;
+				++epoch;
+				callMonitor(monitor);
+				if (!progress)
+					break;
+			}
+			return epoch;
+		}
+
+		/** Start the next run from the current weights of the network. */
+		virtual void reset()
+		{
+			m_started = false;
+		}
+
+		/** Get the error (summed over all the patterns) of the current weights. */
+		inline ErrorType getError() const { return m_error; }
+
+		/** Get Euclidean norm of the gradient of the current weights. */
+		inline double getGradientNorm() const { return m_gradientNorm; }
+
+		inline double getGradientTolerance() const { return m_tolerance; }
+		inline void setGradientTolerance(double tolerance) { m_tolerance = tolerance; }
+
+		inline bool isConverged() const { return m_started && m_gradientNorm <= m_tolerance; }
+
+		/** Get count of the performed epochs (iterations of the method). */
+		inline size_t getEpochsCount() const { return m_epochsCount; }
+
+		/** Get count of the passes over all the data. */
+		inline size_t getEvalsCount() const { return m_evalsCount; }
+
+		inline const EvaluatorType& getEvaluator() const { return m_evaluator; }
+
+	protected:
+		NetworkType& m_network;
+		EvaluatorType m_evaluator;
+
+		/** The current weights and their gradient. */
+		GradientType m_weights, m_gradient;
+
+		/** Weights evaluated during an epoch and their gradient. */
+		GradientType m_trial, m_trialGradient;
+
+		ErrorType m_error;
+		double m_gradientNorm;
+		double m_tolerance;
+		size_t m_epochsCount, m_evalsCount;
+		bool m_started;
+
+		/** Perform one epoch. Return false if the method can't make any progress. */
+		virtual bool step() = 0;
+
+		/** Load weights of the network and eval their error and gradient. */
+		virtual void start()
+		{
+			m_network.saveWeights(m_weights);
+			m_error = evalGradient(m_weights, m_gradient);
+			m_gradientNorm = std::sqrt( dot(m_gradient, m_gradient) );
+			m_started = true;
+		}
+
+		inline ErrorType evalGradient(const GradientType& weights, GradientType& gradient)
+		{
+			++m_evalsCount;
+			return m_evaluator.evalGradient(weights.getData(), gradient);
+		}
+
+		/** Make the trial weights (and their gradient) the current ones. */
+		void acceptTrial(ErrorType error)
+		{
+			m_weights.copyFrom(m_trial);
+			m_gradient.copyFrom(m_trialGradient);
+			m_error = error;
+			m_gradientNorm = std::sqrt( dot(m_gradient, m_gradient) );
+		}
+
+		static double dot(const GradientType& x, const GradientType& y)
+		{
+			const WeightType *a = x.getData(), *b = y.getData();
+			double sum = 0;
+			for (size_t i = 0; i < x.getSize(); ++i)
+				sum += a[i] * b[i];
+			return sum;
+		}
+
+		/** z = x + alpha * y */
+		static void addScaled(GradientType& z, const GradientType& x, double alpha, const GradientType& y)
+		{
+			WeightType *c = z.getData();
+			const WeightType *a = x.getData(), *b = y.getData();
+			const WeightType scale = static_cast<WeightType>(alpha);
+			for (size_t i = 0; i < z.getSize(); ++i)
+				c[i] = a[i] + scale * b[i];
+		}
+
+		/** x = alpha * x + beta * y */
+		static void combine(GradientType& x, double alpha, double beta, const GradientType& y)
+		{
+			WeightType *a = x.getData();
+			const WeightType *b = y.getData();
+			const WeightType scaleX = static_cast<WeightType>(alpha), scaleY = static_cast<WeightType>(beta);
+			for (size_t i = 0; i < x.getSize(); ++i)
+				a[i] = scaleX * a[i] + scaleY * b[i];
+		}
+
+	private:
+		BatchTrainerBase(const BatchTrainerBase&);
+		BatchTrainerBase& operator=(const BatchTrainerBase&);
+	};
+
+	template <typename NetworkT, typename ContT>
+	const double BatchTrainerBase<NetworkT, ContT>::DEF_GRADIENT_TOLERANCE = 1e-6;
+
+
+// SCALED CONJUGATE GRADIENT //////////////////////////////////////////////////
+
+	/**
+	Scaled conjugate gradient (Moller) - conjugate directions without a line
+	search, the step along a direction is given by the curvature of the error
+	estimated by a finite difference of gradients and regularized by a scale
+	(a Levenberg-Marquardt like parameter) adapted by the ratio of the real and
+	the predicted decrease of the error. One epoch costs two evaluations of the
+	gradient (one if the last step failed). The direction is restarted to the
+	steepest descent after every getWeightsSize() successful steps.
+	*/
+	template <typename NetworkT, typename ContT>
+	class ScaledConjugateGradient :
+		public BatchTrainerBase<NetworkT, ContT>
+	{
+	private:
+		typedef BatchTrainerBase<NetworkT, ContT> _TrainerBase;
+
+	public:
+		typedef typename _TrainerBase::NetworkType NetworkType;
+		typedef typename _TrainerBase::ContainerType ContainerType;
+		typedef typename _TrainerBase::ErrorType ErrorType;
+		typedef typename _TrainerBase::GradientType GradientType;
+
+		/** Default relative step of the finite difference of gradients. */
+		static const double DEF_SIGMA;
+
+		ScaledConjugateGradient(NetworkType& network, const ContainerType& data, size_t threadsCount = 0) :
+		_TrainerBase(network, data, threadsCount),
+		m_direction(network), m_sigma(DEF_SIGMA)
+		{
+			resetState();
+		}
+
+		virtual void reset()
+		{
+			_TrainerBase::reset();
+			resetState();
+		}
+
+		inline double getSigma() const { return m_sigma; }
+		inline void setSigma(double sigma) { m_sigma = sigma; }
+
+		/** Get the current scale of the curvature. */
+		inline double getLambda() const { return m_lambda; }
+
+	protected:
+		/** The current search direction. */
+		GradientType m_direction;
+
+		double m_sigma, m_lambda;
+
+		/** Slope and squared norm of the direction and the estimated curvature along it. */
+		double m_slope, m_dirNorm2, m_curvature;
+
+		bool m_success;
+		size_t m_successCount;
+
+		static const double MIN_LAMBDA, MAX_LAMBDA, INIT_LAMBDA;
+
+		void resetState()
+		{
+			m_lambda = INIT_LAMBDA;
+			m_success = true;
+			m_successCount = 0;
+		}
+
+		virtual void start()
+		{
+			_TrainerBase::start();
+			restartDirection();
+		}
+
+		/** Set the direction to the steepest descent. */
+		void restartDirection()
+		{
+			this->combine(m_direction, 0, -1, this->m_gradient);
+			m_successCount = 0;
+		}
+
+		virtual bool step()
+		{
+			// estimate curvature along the direction by a finite difference of gradients
+			if (m_success)
+			{
+				m_slope = this->dot(m_direction, this->m_gradient);
+				if (m_slope >= 0) {
+					restartDirection();
+					m_slope = this->dot(m_direction, this->m_gradient);
+				}
+				m_dirNorm2 = this->dot(m_direction, m_direction);
+				if (m_dirNorm2 == 0)
+					return false;
+
+				const double sigma = m_sigma / std::sqrt(m_dirNorm2);
+				this->addScaled(this->m_trial, this->m_weights, sigma, m_direction);
+				this->evalGradient(this->m_trial, this->m_trialGradient);
+				m_curvature = ( this->dot(m_direction, this->m_trialGradient) - m_slope ) / sigma;
+			}
+
+			// make the curvature positive by the scale
+			double delta = m_curvature + m_lambda * m_dirNorm2;
+			if (delta <= 0) {
+				delta = m_lambda * m_dirNorm2;
+				m_lambda -= m_curvature / m_dirNorm2;
+			}
+
+			// step to the minimum of the quadratic model and compare the decrease
+			const double alpha = -m_slope / delta;
+			this->addScaled(this->m_trial, this->m_weights, alpha, m_direction);
+			const ErrorType error = this->evalGradient(this->m_trial, this->m_trialGradient);
+			const double ratio = 2 * (error - this->m_error) / (alpha * m_slope);
+
+			m_success = (ratio >= 0);
+			if (m_success)
+			{
+				// conjugate direction from the old and new gradient (before they're replaced)
+				const double beta = ( this->dot(this->m_trialGradient, this->m_gradient) -
+					this->dot(this->m_trialGradient, this->m_trialGradient) ) / m_slope;
+				this->acceptTrial(error);
+
+				if (++m_successCount >= this->m_weights.getSize())
+					restartDirection();
+				else
+					this->combine(m_direction, beta, -1, this->m_gradient);
+			}
+
+			if (ratio < 0.25)
+				m_lambda = std::min(4 * m_lambda, MAX_LAMBDA);
+			else if (ratio > 0.75)
+				m_lambda = std::max(m_lambda / 2, MIN_LAMBDA);
+
+			return m_success || m_lambda < MAX_LAMBDA;
+		}
+	};
+
+	template <typename NetworkT, typename ContT>
+	const double ScaledConjugateGradient<NetworkT, ContT>::DEF_SIGMA = 1e-4;
+
+	template <typename NetworkT, typename ContT>
+	const double ScaledConjugateGradient<NetworkT, ContT>::MIN_LAMBDA = 1e-15;
+
+	template <typename NetworkT, typename ContT>
+	const double ScaledConjugateGradient<NetworkT, ContT>::MAX_LAMBDA = 1e100;
+
+	template <typename NetworkT, typename ContT>
+	const double ScaledConjugateGradient<NetworkT, ContT>::INIT_LAMBDA = 1e-6;
+
+
+// L-BFGS /////////////////////////////////////////////////////////////////////
+
+	/**
+	Limited-memory BFGS - quasi-Newton method approximating the inverse Hessian
+	by the given count of the last steps and changes of the gradient (the
+	history is a ring of WeightsBuffers). The step along the quasi-Newton
+	direction is found by a backtracking line search satisfying the Armijo
+	condition, every trial point costs one evaluation of the gradient. Pairs
+	with a non-positive curvature aren't stored and the history is cleared if
+	the direction isn't a descent one or the line search fails.
+	*/
+	template <typename NetworkT, typename ContT>
+	class LBFGS :
+		public BatchTrainerBase<NetworkT, ContT>
+	{
+	private:
+		typedef BatchTrainerBase<NetworkT, ContT> _TrainerBase;
+
+	public:
+		typedef typename _TrainerBase::NetworkType NetworkType;
+		typedef typename _TrainerBase::ContainerType ContainerType;
+		typedef typename _TrainerBase::ErrorType ErrorType;
+		typedef typename _TrainerBase::GradientType GradientType;
+
+		/** Default count of the stored steps. */
+		static const size_t DEF_HISTORY_SIZE;
+
+		/** Default maximal count of the trial points of one line search. */
+		static const size_t DEF_MAX_LINE_SEARCH;
+
+		LBFGS(NetworkType& network, const ContainerType& data, size_t historySize = DEF_HISTORY_SIZE,
+			size_t threadsCount = 0) :
+		_TrainerBase(network, data, threadsCount),
+		m_direction(network), m_newStep( new GradientType(network) ), m_newChange( new GradientType(network) ),
+		m_rhos( std::max<size_t>(historySize, 1) ), m_alphas( m_rhos.size() ), m_newest(0), m_storedCount(0), m_maxLineSearch(DEF_MAX_LINE_SEARCH)
+		{
+			for (size_t i = 0; i < m_rhos.size(); ++i) {
+				m_steps.push_back( new GradientType(network) );
+				m_changes.push_back( new GradientType(network) );
+			}
+		}
+
+		~LBFGS()
+		{
+			deleteRange( m_steps.begin(), m_steps.end() );
+			deleteRange( m_changes.begin(), m_changes.end() );
+			delete m_newStep;
+			delete m_newChange;
+		}
+
+		virtual void reset()
+		{
+			_TrainerBase::reset();
+			clearHistory();
+		}
+
+		inline size_t getHistorySize() const { return m_rhos.size(); }
+
+		/** Get count of the steps stored in the history. */
+		inline size_t getStoredCount() const { return m_storedCount; }
+
+		inline size_t getMaxLineSearch() const { return m_maxLineSearch; }
+		inline void setMaxLineSearch(size_t count) { m_maxLineSearch = std::max<size_t>(count, 1); }
+
+	protected:
+		GradientType m_direction;
+
+		/** Ring of the last steps of the weights and changes of the gradient. */
+		std::vector<GradientType*> m_steps, m_changes;
+
+		/** The newest pair, swapped into the ring only if it's accepted. */
+		GradientType *m_newStep, *m_newChange;
+		std::vector<double> m_rhos, m_alphas;
+		size_t m_newest, m_storedCount;
+
+		size_t m_maxLineSearch;
+
+		/** Constant of the sufficient decrease (Armijo) condition. */
+		static const double ARMIJO_CONST;
+
+		inline void clearHistory()
+		{
+			m_storedCount = 0;
+		}
+
+		/** Index of the i-th newest stored pair. */
+		inline size_t getStored(size_t i) const
+		{
+			return (m_newest + m_rhos.size() - i) % m_rhos.size();
+		}
+
+		/** Eval the quasi-Newton direction by the two-loop recursion. */
+		void evalDirection()
+		{
+			m_direction.copyFrom(this->m_gradient);
+			for (size_t i = 0; i < m_storedCount; ++i) {
+				const size_t k = getStored(i);
+				m_alphas[k] = m_rhos[k] * this->dot(*m_steps[k], m_direction);
+				this->combine(m_direction, 1, -m_alphas[k], *m_changes[k]);
+			}
+
+			// the initial inverse Hessian is scaled by the newest pair
+			double gamma;
+			if (m_storedCount > 0) {
+				const GradientType& change = *m_changes[m_newest];
+				gamma = 1 / ( m_rhos[m_newest] * this->dot(change, change) );
+			}
+			else
+				gamma = 1 / this->m_gradientNorm;
+			this->combine(m_direction, gamma, 0, m_direction);
+
+			for (size_t i = m_storedCount; i > 0; --i) {
+				const size_t k = getStored(i - 1);
+				const double beta = m_rhos[k] * this->dot(*m_changes[k], m_direction);
+				this->combine(m_direction, 1, m_alphas[k] - beta, *m_steps[k]);
+			}
+
+			this->combine(m_direction, -1, 0, m_direction);
+		}
+
+		virtual bool step()
+		{
+			evalDirection();
+			double slope = this->dot(m_direction, this->m_gradient);
+			if (slope >= 0) {
+				clearHistory();
+				evalDirection();
+				slope = this->dot(m_direction, this->m_gradient);
+			}
+
+			// backtracking line search with a safeguarded quadratic interpolation
+			double rate = 1;
+			ErrorType error = 0;
+			bool accepted = false;
+			for (size_t trial = 0; trial < m_maxLineSearch && !accepted; ++trial)
+			{
+				this->addScaled(this->m_trial, this->m_weights, rate, m_direction);
+				error = this->evalGradient(this->m_trial, this->m_trialGradient);
+				accepted = ( error <= this->m_error + ARMIJO_CONST * rate * slope );
+				if (!accepted) {
+					const double decrease = error - this->m_error - slope * rate;
+					const double minimum = (decrease > 0) ? -slope * rate * rate / (2 * decrease) : rate / 2;
+					rate = std::min( std::max(minimum, rate / 10), rate / 2 );
+				}
+			}
+
+			if (!accepted) {
+				const bool hadHistory = (m_storedCount > 0);
+				clearHistory();
+				return hadHistory;
+			}
+
+			// store the step and change of the gradient if the curvature is positive
+			GradientType& stepVec = *m_newStep;
+			GradientType& change = *m_newChange;
+			this->combine(stepVec, 0, rate, m_direction);
+			this->addScaled(change, this->m_trialGradient, -1, this->m_gradient);
+			const double curvature = this->dot(stepVec, change);
+			if ( curvature > 1e-10 * std::sqrt( this->dot(stepVec, stepVec) * this->dot(change, change) ) ) {
+				const size_t next = (m_newest + 1) % m_rhos.size();
+				std::swap( m_steps[next], m_newStep );
+				std::swap( m_changes[next], m_newChange );
+				m_rhos[next] = 1 / curvature;
+				m_newest = next;
+				m_storedCount = std::min(m_storedCount + 1, m_rhos.size());
+			}
+
+			this->acceptTrial(error);
+			return true;
+		}
+
+	private:
+		LBFGS(const LBFGS&);
+		LBFGS& operator=(const LBFGS&);
+	};
+
+	template <typename NetworkT, typename ContT>
+	const size_t LBFGS<NetworkT, ContT>::DEF_HISTORY_SIZE = 10;
+
+	template <typename NetworkT, typename ContT>
+	const size_t LBFGS<NetworkT, ContT>::DEF_MAX_LINE_SEARCH = 20;
+
+	template <typename NetworkT, typename ContT>
+	const double LBFGS<NetworkT, ContT>::ARMIJO_CONST = 1e-4;
+
+}
+
+#endif
@@ -5,4 +5,6 @@ namespace NNLib
 	
 	bool ConsoleInterruptionContinuator::s_continue;
 	
+	const unsigned DeadlineContinuator::DEF_CHECK_PERIOD = 64;
+	
 }
\ No newline at end of file
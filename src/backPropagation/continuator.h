@@ -1,125 +1,413 @@
-#ifndef _CONTINUATOR_H_
-#define _CONTINUATOR_H_
-
-#include <cstdlib>
-#include <ostream>
-
-#ifdef UNIX
-#	include <signal.h>
-#endif
-
-namespace NNLib
-{
-
-	/**
-	Base class for every class representing a continuator - a functor that returns
-	whether the algorithm should continue (whatever it means).
-	*/
-	class ContinuatorBase
-	{
-	};
-
-
-	/**
-	This continuator always returns true so the algorithm should always continue.
-	*/
-	class AlwaysContinue :
-		public ContinuatorBase
-	{
-	public:
-		inline bool operator()() const { return true; }
-	private:
-		operator bool();
-	};
-
-
-	/**
-	This continuator computes the average error on the network's output. If this
-	error is smaller than the given error it tells that no continuation is needed.
-	*/
-	template <typename NetworkT,
-		typename DataAccessT,
-		template <typename> class DistanceT,
-		typename ErrorAccumT>
-	class ErrorContinuator :
-		public ContinuatorBase,
-		protected DistanceT<typename NetworkT::OutputType>,
-		protected ErrorAccumT
-	{
-	public:
-		typedef NetworkT NetworkType;
-		typedef typename NetworkType::OutputType ErrorType;
-		typedef DataAccessT DataAccessType;
-
-		/** Create continuator for the given network and given data accessor. */
-		ErrorContinuator(const NetworkType& network, const DataAccessType& accessor, ErrorType maxError) :
-		m_network(network), m_accessor(accessor), m_maxError(maxError)
-		{ }
-
-		bool operator()()
-		{
-			m_lastError = distance( m_network.getOutputCache(),
-				m_accessor.current().getOutput(), m_network.getOutputsCount() );
-			this->accum(m_lastError);
-			return ( this->getAccumVal() > m_maxError );
-		}
-
-		inline ErrorType getMaxError() const { return m_maxError; }
-		inline ErrorType getLastError() const { return m_lastError; }
-		inline ErrorType getError() const { return this->getAccumVal(); }
-
-	protected:
-		const NetworkType& m_network;
-		const DataAccessType& m_accessor;
-
-		/** If an error is smaller than this value the continuation stops. */
-		const ErrorType m_maxError;
-
-		ErrorType m_lastError;
-
-	private:
-		ErrorContinuator& operator=(const ErrorContinuator&);
-	};
-	
-	
-	/** Print the error and the maximal error. */
-	template <typename A, typename B, template <typename> class C, typename D>
-	std::ostream& operator<<(std::ostream& os, const ErrorContinuator<A,B,C,D>& error)
-	{
-		os << "last=" << error.getLastError() << " overall=" << error.getError();
-		return os;
-	}
-	
-	
-	/**
-	Console input continuator which fails if exit sequence Ctrl+C was entered.
-	*/
-	class ConsoleInterruptionContinuator :
-		public ContinuatorBase
-	{
-	public:
-		ConsoleInterruptionContinuator()
-		{
-			#ifdef UNIX
-				signal(SIGINT, signalHandler);
-			#endif
-			s_continue = true;
-		}
-		
-		inline bool operator()() const
-		{
-			return s_continue;
-		}
-		
-		static void signalHandler(int)
-		{
-			s_continue = false;
-		}
-		
-	protected:
-		static bool s_continue;
-	};
-
-}
-
+#ifndef _CONTINUATOR_H_
+#define _CONTINUATOR_H_
+
+#include <cstdlib>
+#include <ostream>
+#include "common/cycleCounter.h"
+#include "backPropagation/monitor.h"
+
+#ifdef UNIX
+#	include <signal.h>
+#endif
+
+namespace NNLib
+{
+
+	/**
+	Base class for every class representing a continuator - a functor that returns
+	whether the algorithm should continue (whatever it means).
+	*/
+	class ContinuatorBase
+	{
+	};
+
+
+	/**
+	This continuator always returns true so the algorithm should always continue.
+	*/
+	class AlwaysContinue :
+		public ContinuatorBase
+	{
+	public:
+		inline bool operator()() const { return true; }
+	private:
+		operator bool();
+	};
+
+
+	/** Copy of the errors of an ErrorContinuator for the asynchronous monitors. */
+	template <typename ErrorT>
+	struct ErrorSnapshot
+	{
+		ErrorT lastError, error;
+
+		template <typename ContinuatorT>
+		ErrorSnapshot(const ContinuatorT& continuator) :
+		lastError( continuator.getLastError() ), error( continuator.getError() )
+		{ }
+	};
+
+	/** Print the last and the overall error. */
+	template <typename ErrorT>
+	std::ostream& operator<<(std::ostream& os, const ErrorSnapshot<ErrorT>& snapshot)
+	{
+		os << "last=" << snapshot.lastError << " overall=" << snapshot.error;
+		return os;
+	}
+
+
+	/**
+	This continuator computes the average error on the network's output. If this
+	error is smaller than the given error it tells that no continuation is needed.
+	*/
+	template <typename NetworkT,
+		typename DataAccessT,
+		template <typename> class DistanceT,
+		typename ErrorAccumT>
+	class ErrorContinuator :
+		public ContinuatorBase,
+		protected DistanceT<typename NetworkT::OutputType>,
+		protected ErrorAccumT
+	{
+	public:
+		typedef NetworkT NetworkType;
+		typedef typename NetworkType::OutputType ErrorType;
+		typedef DataAccessT DataAccessType;
+		typedef ErrorSnapshot<ErrorType> SnapshotType;
+
+		/** Create continuator for the given network and given data accessor. */
+		ErrorContinuator(const NetworkType& network, const DataAccessType& accessor, ErrorType maxError) :
+		m_network(network), m_accessor(accessor), m_maxError(maxError)
+		{ }
+
+		bool operator()()
+		{
+			m_lastError = this->distance( m_network.getOutputCache(),
+				m_accessor.current().getOutput(), m_network.getOutputsCount() );
+			this->accum(m_lastError);
+			return ( this->getAccumVal() > m_maxError );
+		}
+
+		inline ErrorType getMaxError() const { return m_maxError; }
+		inline ErrorType getLastError() const { return m_lastError; }
+		inline ErrorType getError() const { return this->getAccumVal(); }
+
+	protected:
+		const NetworkType& m_network;
+		const DataAccessType& m_accessor;
+
+		/** If an error is smaller than this value the continuation stops. */
+		const ErrorType m_maxError;
+
+		ErrorType m_lastError;
+
+	private:
+		ErrorContinuator& operator=(const ErrorContinuator&);
+	};
+	
+	
+	/** Print the error and the maximal error. */
+	template <typename A, typename B, template <typename> class C, typename D>
+	std::ostream& operator<<(std::ostream& os, const ErrorContinuator<A,B,C,D>& error)
+	{
+		os << typename ErrorContinuator<A,B,C,D>::SnapshotType(error);
+		return os;
+	}
+	
+	
+	/**
+	Console input continuator which fails if exit sequence Ctrl+C was entered.
+	*/
+	class ConsoleInterruptionContinuator :
+		public ContinuatorBase
+	{
+	public:
+		ConsoleInterruptionContinuator()
+		{
+			#ifdef UNIX
+				signal(SIGINT, signalHandler);
+			#endif
+			s_continue = true;
+		}
+		
+		inline bool operator()() const
+		{
+			return s_continue;
+		}
+		
+		static void signalHandler(int)
+		{
+			s_continue = false;
+		}
+		
+	protected:
+		static bool s_continue;
+	};
+	
+	
+	struct DeadlineSnapshot;
+	
+	/**
+	Continuator which stops the algorithm when the given wall-clock time from its
+	creation (or restart) elapses. The time is read by the cycle counter only at
+	every checkPeriod-th call (and at the first one), so the check costs just a
+	decrement for the other calls. The period should be about the count of calls
+	(patterns) per millisecond in the online training; for the batch trainers,
+	which call the continuator once per epoch, it should be 1.
+	*/
+	class DeadlineContinuator :
+		public ContinuatorBase
+	{
+	public:
+		typedef DeadlineSnapshot SnapshotType;
+
+		DeadlineContinuator(double seconds, unsigned checkPeriod = DEF_CHECK_PERIOD) :
+		m_seconds(seconds), m_checkPeriod(checkPeriod > 0 ? checkPeriod : 1)
+		{
+			restart();
+		}
+		
+		/** Start measuring the time again from now. */
+		void restart()
+		{
+			m_start = readCycleCounter();
+			m_deadline = m_start + static_cast<CycleType>( m_seconds * getCyclesPerSecond() );
+			m_countdown = 0;
+			m_expired = false;
+		}
+		
+		inline bool operator()()
+		{
+			if (m_expired)
+				return false;
+			if (m_countdown > 0) {
+				--m_countdown;
+				return true;
+			}
+			
+			m_countdown = m_checkPeriod - 1;
+			m_expired = ( readCycleCounter() >= m_deadline );
+			return !m_expired;
+		}
+		
+		inline double getSeconds() const { return m_seconds; }
+		inline unsigned getCheckPeriod() const { return m_checkPeriod; }
+		inline bool isExpired() const { return m_expired; }
+		
+		/** Get the seconds elapsed from the start (reads the counter). */
+		inline double getElapsedSeconds() const
+		{
+			return ( readCycleCounter() - m_start ) / getCyclesPerSecond();
+		}
+		
+		static const unsigned DEF_CHECK_PERIOD;
+		
+	protected:
+		double m_seconds;
+		unsigned m_checkPeriod;
+		
+		CycleType m_start, m_deadline;
+		
+		/** Count of calls left to the next reading of the counter. */
+		unsigned m_countdown;
+		bool m_expired;
+	};
+	
+	
+	/** Times of a DeadlineContinuator taken when the snapshot is created. */
+	struct DeadlineSnapshot
+	{
+		double elapsed, seconds;
+
+		DeadlineSnapshot(const DeadlineContinuator& deadline) :
+		elapsed( deadline.getElapsedSeconds() ), seconds( deadline.getSeconds() )
+		{ }
+	};
+
+	/** Print the elapsed and the available seconds. */
+	inline std::ostream& operator<<(std::ostream& os, const DeadlineSnapshot& snapshot)
+	{
+		os << "elapsed=" << snapshot.elapsed << "s limit=" << snapshot.seconds << "s";
+		return os;
+	}
+
+	inline std::ostream& operator<<(std::ostream& os, const DeadlineContinuator& deadline)
+	{
+		os << DeadlineSnapshot(deadline);
+		return os;
+	}
+	
+	
+	/**
+	Continuator with a budget of work - every call which allows the continuation
+	consumes the given cost and the algorithm stops when the rest of the budget
+	doesn't cover the next call. With the cost 1 the budget is the count of the
+	trained patterns in the online training (or of epochs in the batch trainers,
+	the cost data.size() makes it the count of patterns again). With the cost
+	of the count of the trained weights the budget limits the weight updates.
+	*/
+	class BudgetContinuator :
+		public ContinuatorBase
+	{
+	public:
+		typedef unsigned long long CountType;
+		
+		BudgetContinuator(CountType budget, CountType cost = 1) :
+		m_budget(budget), m_cost(cost), m_used(0)
+		{ }
+		
+		inline bool operator()()
+		{
+			if (m_budget - m_used < m_cost)
+				return false;
+			m_used += m_cost;
+			return true;
+		}
+		
+		/** Renew the whole budget. */
+		inline void reset() { m_used = 0; }
+		
+		inline CountType getBudget() const { return m_budget; }
+		inline CountType getCost() const { return m_cost; }
+		inline CountType getUsed() const { return m_used; }
+		inline CountType getRemaining() const { return m_budget - m_used; }
+		
+	protected:
+		CountType m_budget, m_cost, m_used;
+	};
+	
+	
+	/** Print the used and the whole budget. */
+	inline std::ostream& operator<<(std::ostream& os, const BudgetContinuator& budget)
+	{
+		os << "used=" << budget.getUsed() << " budget=" << budget.getBudget();
+		return os;
+	}
+	
+	
+	/** Snapshots of both the combined continuators. */
+	template <typename FirstT, typename SecondT>
+	struct PairSnapshot
+	{
+		typename ParamSnapshot<FirstT>::Type first;
+		typename ParamSnapshot<SecondT>::Type second;
+
+		template <typename CombinedT>
+		PairSnapshot(const CombinedT& combined) :
+		first( combined.getFirst() ), second( combined.getSecond() )
+		{ }
+	};
+
+	/** Print both the snapshots. */
+	template <typename FirstT, typename SecondT>
+	std::ostream& operator<<(std::ostream& os, const PairSnapshot<FirstT, SecondT>& snapshot)
+	{
+		os << snapshot.first << " " << snapshot.second;
+		return os;
+	}
+
+
+	/**
+	Conjunction of two continuators resolved at compile time - the algorithm
+	continues while both of them allow it. The second one is called only if
+	the first one allows the continuation, so the cheap continuators (deadline,
+	budget) should be the first ones and stateful ones (an ErrorContinuator
+	accumulating the error) the second ones. Conjunctions can be nested.
+	*/
+	template <typename FirstT, typename SecondT>
+	class AndContinuator :
+		public ContinuatorBase
+	{
+	public:
+		typedef FirstT FirstType;
+		typedef SecondT SecondType;
+		typedef PairSnapshot<FirstT, SecondT> SnapshotType;
+		
+		AndContinuator(FirstType& first, SecondType& second) :
+		m_first(first), m_second(second)
+		{ }
+		
+		inline bool operator()()
+		{
+			return m_first() && m_second();
+		}
+		
+		inline const FirstType& getFirst() const { return m_first; }
+		inline const SecondType& getSecond() const { return m_second; }
+		
+	protected:
+		FirstType& m_first;
+		SecondType& m_second;
+		
+	private:
+		AndContinuator& operator=(const AndContinuator&);
+	};
+	
+	/** Create conjunction of the given continuators. */
+	template <typename FirstT, typename SecondT>
+	inline AndContinuator<FirstT, SecondT> continueWhileBoth(FirstT& first, SecondT& second)
+	{
+		return AndContinuator<FirstT, SecondT>(first, second);
+	}
+	
+	/** Print both continuators. */
+	template <typename FirstT, typename SecondT>
+	std::ostream& operator<<(std::ostream& os, const AndContinuator<FirstT, SecondT>& both)
+	{
+		os << both.getFirst() << " " << both.getSecond();
+		return os;
+	}
+	
+	
+	/**
+	Disjunction of two continuators resolved at compile time - the algorithm
+	continues while any of them allows it. The second one is called only if
+	the first one doesn't allow the continuation.
+	*/
+	template <typename FirstT, typename SecondT>
+	class OrContinuator :
+		public ContinuatorBase
+	{
+	public:
+		typedef FirstT FirstType;
+		typedef SecondT SecondType;
+		typedef PairSnapshot<FirstT, SecondT> SnapshotType;
+		
+		OrContinuator(FirstType& first, SecondType& second) :
+		m_first(first), m_second(second)
+		{ }
+		
+		inline bool operator()()
+		{
+			return m_first() || m_second();
+		}
+		
+		inline const FirstType& getFirst() const { return m_first; }
+		inline const SecondType& getSecond() const { return m_second; }
+		
+	protected:
+		FirstType& m_first;
+		SecondType& m_second;
+		
+	private:
+		OrContinuator& operator=(const OrContinuator&);
+	};
+	
+	/** Create disjunction of the given continuators. */
+	template <typename FirstT, typename SecondT>
+	inline OrContinuator<FirstT, SecondT> continueWhileAny(FirstT& first, SecondT& second)
+	{
+		return OrContinuator<FirstT, SecondT>(first, second);
+	}
+	
+	/** Print both continuators. */
+	template <typename FirstT, typename SecondT>
+	std::ostream& operator<<(std::ostream& os, const OrContinuator<FirstT, SecondT>& any)
+	{
+		os << any.getFirst() << " " << any.getSecond();
+		return os;
+	}
+
+}
+
 #endif
\ No newline at end of file
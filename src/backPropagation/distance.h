@@ -1,105 +1,171 @@
-#ifndef _DISTANCE_H_
-#define _DISTANCE_H_
-
-#include <cmath>
-
-namespace NNLib
-{
-
-	/**
-	Base class for every distance functor of two vectors.
-	*/
-	template <typename T>
-	struct DistanceBase
-	{
-		typedef T InputType;
-		typedef T DistType;
-	};
-
-
-	/**
-	Computes Manhattan distance of two vectors (also called city-block distance,
-	rectilinear distance, L1 distance etc.
-	*/
-	template <typename T>
-	struct ManhattanDistance :
-		public DistanceBase<T>
-	{
-		typedef DistanceBase<T> _DistBase;
-		typedef typename _DistBase::InputType InputType;
-		typedef typename _DistBase::DistType DistType;
-
-		inline DistType operator()(const InputType x[], const InputType y[], size_t len) const
-		{
-			return distance(x, y, len);
-		}
-
-		inline DistType distance(const InputType x[], const InputType y[], size_t len) const
-		{
-			DistType dist = 0;
-			for (size_t i = 0; i < len; ++i)
-				dist += std::abs( x[i] - y[i] );
-			return dist;
-		}
-	};
-
-
-	/**
-	Computes squared value of standard Eucleidian distance.
-	*/
-	template <typename T>
-	struct SquaredEuclideanDistance :
-		public DistanceBase<T>
-	{
-		typedef DistanceBase<T> _DistBase;
-		typedef typename _DistBase::InputType InputType;
-		typedef typename _DistBase::DistType DistType;
-
-		inline DistType operator()(const InputType x[], const InputType y[], size_t len) const
-		{
-			return distance(x, y, len);
-		}
-
-		inline DistType distance(const InputType x[], const InputType y[], size_t len) const
-		{
-			DistType dist = 0;
-			for (size_t i = 0; i < len; ++i) {
-				DistType diff = x[i] - y[i];
-				dist += diff * diff;
-			}
-			return dist;
-		}
-	};
-
-
-	/**
-	Computes maximal absolute difference of two coordinates.
-	*/
-	template <typename T>
-	struct MaxDistance :
-		public DistanceBase<T>
-	{
-		typedef DistanceBase<T> _DistBase;
-		typedef typename _DistBase::InputType InputType;
-		typedef typename _DistBase::DistType DistType;
-
-		inline DistType operator()(const InputType x[], const InputType y[], size_t len) const
-		{
-			return distance(x, y, len);
-		}
-
-		inline DistType distance(const InputType x[], const InputType y[], size_t len) const
-		{
-			DistType max = 0;
-			for (size_t i = 0; i < len; ++i) {
-				DistType absDiff = std::abs( x[i] - y[i] );
-				if (absDiff > max)
-					max = absDiff;
-			}
-			return max;
-		}
-	};
-
-}
-
+#ifndef _DISTANCE_H_
+#define _DISTANCE_H_
+
+#include <cmath>
+
+namespace NNLib
+{
+
+	/**
+	Base class for every distance functor of two vectors.
+	*/
+	template <typename T>
+	struct DistanceBase
+	{
+		typedef T InputType;
+		typedef T DistType;
+	};
+
+
+	/**
+	Computes Manhattan distance of two vectors (also called city-block distance,
+	rectilinear distance, L1 distance etc.
+	*/
+	template <typename T>
+	struct ManhattanDistance :
+		public DistanceBase<T>
+	{
+		typedef DistanceBase<T> _DistBase;
+		typedef typename _DistBase::InputType InputType;
+		typedef typename _DistBase::DistType DistType;
+
+		inline DistType operator()(const InputType x[], const InputType y[], size_t len) const
+		{
+			return distance(x, y, len);
+		}
+
+		inline DistType distance(const InputType x[], const InputType y[], size_t len) const
+		{
+			DistType dist = 0;
+			for (size_t i = 0; i < len; ++i)
+				dist += std::abs( x[i] - y[i] );
+			return dist;
+		}
+	};
+
+
+	/**
+	Computes squared value of standard Eucleidian distance.
+	*/
+	template <typename T>
+	struct SquaredEuclideanDistance :
+		public DistanceBase<T>
+	{
+		typedef DistanceBase<T> _DistBase;
+		typedef typename _DistBase::InputType InputType;
+		typedef typename _DistBase::DistType DistType;
+
+		inline DistType operator()(const InputType x[], const InputType y[], size_t len) const
+		{
+			return distance(x, y, len);
+		}
+
+		inline DistType distance(const InputType x[], const InputType y[], size_t len) const
+		{
+			DistType dist = 0;
+			for (size_t i = 0; i < len; ++i) {
+				DistType diff = x[i] - y[i];
+				dist += diff * diff;
+			}
+			return dist;
+		}
+	};
+
+
+	/**
+	Computes maximal absolute difference of two coordinates.
+	*/
+	template <typename T>
+	struct MaxDistance :
+		public DistanceBase<T>
+	{
+		typedef DistanceBase<T> _DistBase;
+		typedef typename _DistBase::InputType InputType;
+		typedef typename _DistBase::DistType DistType;
+
+		inline DistType operator()(const InputType x[], const InputType y[], size_t len) const
+		{
+			return distance(x, y, len);
+		}
+
+		inline DistType distance(const InputType x[], const InputType y[], size_t len) const
+		{
+			DistType max = 0;
+			for (size_t i = 0; i < len; ++i) {
+				DistType absDiff = std::abs( x[i] - y[i] );
+				if (absDiff > max)
+					max = absDiff;
+			}
+			return max;
+		}
+	};
+
+
+	/**
+	Computes cross-entropy of the expected distribution y and the real one x
+	(e.g. outputs of a SoftmaxLayer). The order of the vectors matters. Values
+	of x are limited from below so that the logarithm is always finite.
+	*/
+	template <typename T>
+	struct CrossEntropyDistance :
+		public DistanceBase<T>
+	{
+		typedef DistanceBase<T> _DistBase;
+		typedef typename _DistBase::InputType InputType;
+		typedef typename _DistBase::DistType DistType;
+
+		inline DistType operator()(const InputType x[], const InputType y[], size_t len) const
+		{
+			return distance(x, y, len);
+		}
+
+		inline DistType distance(const InputType x[], const InputType y[], size_t len) const
+		{
+			static const InputType MIN_VALUE = static_cast<InputType>(1e-30);
+			DistType dist = 0;
+			for (size_t i = 0; i < len; ++i) {
+				if (y[i] != 0)
+					dist -= y[i] * std::log( (x[i] > MIN_VALUE) ? x[i] : MIN_VALUE );
+			}
+			return dist;
+		}
+	};
+
+
+	/**
+	Computes classification error - zero if the maximal coordinates of both the
+	vectors have the same index, one otherwise. Averaged over patterns it is the
+	ratio of misclassified patterns (e.g. for ErrorContinuator).
+	*/
+	template <typename T>
+	struct ClassificationDistance :
+		public DistanceBase<T>
+	{
+		typedef DistanceBase<T> _DistBase;
+		typedef typename _DistBase::InputType InputType;
+		typedef typename _DistBase::DistType DistType;
+
+		inline DistType operator()(const InputType x[], const InputType y[], size_t len) const
+		{
+			return distance(x, y, len);
+		}
+
+		inline DistType distance(const InputType x[], const InputType y[], size_t len) const
+		{
+			return static_cast<DistType>( (argMax(x, len) == argMax(y, len)) ? 0 : 1 );
+		}
+
+	protected:
+		static size_t argMax(const InputType x[], size_t len)
+		{
+			size_t maxIndex = 0;
+			for (size_t i = 1; i < len; ++i)
+				if (x[i] > x[maxIndex])
+					maxIndex = i;
+			return maxIndex;
+		}
+	};
+
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef _FROZEN_PREFIX_CACHE_H_
+#define _FROZEN_PREFIX_CACHE_H_
+
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+
+namespace NNLib
+{
+
+	/**
+	Cache of outputs of the last layer of the frozen prefix of a network for the
+	single patterns (identified by their addresses). Weights of the frozen layers
+	don't change during training so their outputs for a pattern can be computed
+	only once and the later cycles start from the first trained layer. The cache
+	is valid only for the given count of frozen layers and it has to be cleared
+	whenever weights of the frozen layers or the patterns change.
+	*/
+	template <typename T>
+	class FrozenPrefixCache
+	{
+	public:
+		typedef T OutputType;
+
+		FrozenPrefixCache() :
+		m_prefixLength(0)
+		{ }
+
+		/** Get cached outputs for the given pattern or NULL if there are none. */
+		inline const OutputType* find(const void *pattern) const
+		{
+			typename OffsetsMap::const_iterator it = m_offsets.find(pattern);
+			return (it == m_offsets.end()) ? NULL : &m_outputs[it->second];
+		}
+
+		/** Cache the given count of outputs for the given pattern. */
+		void store(const void *pattern, const OutputType outputs[], size_t count)
+		{
+			m_offsets[pattern] = m_outputs.size();
+			m_outputs.insert(m_outputs.end(), outputs, outputs + count);
+		}
+
+		/** Remove all the cached outputs and set the count of frozen layers. */
+		void reset(size_t prefixLength)
+		{
+			m_prefixLength = prefixLength;
+			m_offsets.clear();
+			m_outputs.clear();
+		}
+
+		inline void clear() { reset(m_prefixLength); }
+
+		inline size_t getPrefixLength() const { return m_prefixLength; }
+		inline size_t getPatternsCount() const { return m_offsets.size(); }
+
+	protected:
+		typedef std::unordered_map<const void*, size_t> OffsetsMap;
+
+		/** Count of the frozen layers the outputs belong to. */
+		size_t m_prefixLength;
+
+		/** Offsets of outputs of the single patterns. */
+		OffsetsMap m_offsets;
+
+		/** Outputs of all the patterns one after another. */
+		std::vector<OutputType> m_outputs;
+	};
+
+}
+
+#endif
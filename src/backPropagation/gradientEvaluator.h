@@ -1,7 +1,12 @@
 #ifndef _GRADIENT_EVALUATOR_H_
 #define	_GRADIENT_EVALUATOR_H_
 
+#include <vector>
+#include <algorithm>
+#include "common/sparseVector.h"
 #include "feedForward/networkBufferAllocator.h"
+#include "feedForward/softmaxLayer.h"
+#include "backPropagation/profiler.h"
 
 namespace NNLib
 {
@@ -33,7 +38,10 @@ namespace NNLib
 
 	/**
 	Standard error function gradient evaluator for back-propagation algorithm using delta
-	errors for each neuron.
+	errors for each neuron. The error function is the squared error, except for a
+	SoftmaxLayer on the output where it's the cross-entropy. Gradient of frozen layers
+	isn't evaluated (their values in the buffer are left untouched) and deltas are
+	evaluated only down to the first layer that isn't frozen.
 	*/
 	template <typename NetworkT>
 	class DeltaGradientEvaluator :
@@ -49,93 +57,392 @@ namespace NNLib
 		typedef typename _EvaluatorBase::OutputType OutputType;
 		typedef typename _EvaluatorBase::WeightType DeltaType;
 
+		typedef WeightsBuffer<WeightType> GradientType;
+
 		DeltaGradientEvaluator(const NetworkType& network) :
-		_EvaluatorBase(network)
+		_EvaluatorBase(network), m_deltas(network)
+		{ }
+
+		/** Eval errror function gradient for the given input and expected output. */
+		inline void evalGradient(const InputType *input, const OutputType *expectedOutput, GradientType& gradient)
 		{
-			m_deltas = createNeuronsBuffer<DeltaType>(this->m_network);
+			EmptyProfiler profiler;
+			evalGradient(input, expectedOutput, gradient, profiler);
 		}
 
-		~DeltaGradientEvaluator()
+		/** Eval errror function gradient for the given sparse input. Gradient of the
+		first layer is evaluated only for the weights of the non-zero inputs, the
+		other values of its block are left untouched (see
+		WeightsUpdaterBase::forEachActiveWeightsBlock()). */
+		inline void evalGradient(const SparseVector<InputType>& input, const OutputType *expectedOutput,
+			GradientType& gradient)
 		{
-			deleteNeuronsBuffer(m_deltas);
+			EmptyProfiler profiler;
+			evalGradient(input, expectedOutput, gradient, profiler);
 		}
 
-		/** Eval errror function gradient for the given input and expected output. */
-		void evalGradient(const InputType *input, const OutputType *expectedOutput, WeightType ***gradient)
+		/** Eval errror function gradient and measure the single layers by the given profiler. */
+		template <typename ProfilerT>
+		inline void evalGradient(const InputType *input, const OutputType *expectedOutput, GradientType& gradient,
+			ProfilerT& profiler)
 		{
-			const size_t layersCount = this->m_network.getLayersCount();
+			evalLayersGradient(input, expectedOutput, gradient, profiler);
+		}
 
-			// eval deltas for all the layers
-			evalOutputLayerDeltas(expectedOutput);
-			for (size_t layer = 2; layer <= layersCount; ++layer)
-				evalHiddenLayerDeltas(layersCount - layer);
+		template <typename ProfilerT>
+		inline void evalGradient(const SparseVector<InputType>& input, const OutputType *expectedOutput,
+			GradientType& gradient, ProfilerT& profiler)
+		{
+			evalLayersGradient(input, expectedOutput, gradient, profiler);
+		}
+
+		/** Eval errror function gradient of a dense input layer by layer from the
+		output one and call func(index, firstRow, rowsCount) on tiles of rows
+		(neurons) of every layer which isn't frozen as soon as their gradient is
+		evaluated - so func can update the weights of the rows while their
+		gradient is in the cache. A layer is processed only after the deltas of
+		the previous layer are evaluated, so they use the old weights. */
+		template <typename LayerFunction, typename ProfilerT>
+		void evalFusedGradient(const InputType *input, const OutputType *expectedOutput, GradientType& gradient,
+			LayerFunction& func, ProfilerT& profiler)
+		{
+			LayerInputsCollector collector = { m_inputs, input };
+			m_inputs.clear();
+			this->m_network.forEachLayer(collector);
 
-			// eval weights steps
-			for (size_t layer = layersCount - 1; layer > 0; --layer)
-				evalLayerGradient(layer, this->m_network[layer-1].getOutputCache(), gradient[layer]);
-			evalLayerGradient(0, input, gradient[0]);
+			FusedEvaluator<LayerFunction, ProfilerT> evaluator = { *this, expectedOutput, gradient, func, profiler,
+				this->m_network.getFrozenPrefixLength(), NULL, 0, 0, NO_LAYER, 0, 0 };
+			this->m_network.forEachLayerBackward(evaluator);
+			evaluator.flush();
 		}
 
 	protected:
 		/** Deltas for all the neurons. */
-		DeltaType **m_deltas;
+		NeuronsBuffer<DeltaType> m_deltas;
+
+		/** Inputs of the single layers for the fused evaluation. */
+		std::vector<const InputType*> m_inputs;
+
+		static const size_t NO_LAYER = ~size_t(0);
+
+		/** Size of gradient of a tile of rows in the fused evaluation (in bytes). */
+		static const size_t FUSED_TILE_SIZE = 8192;
+
+		/** Eval error function gradient for the given input of the first layer
+		(a dense array or a sparse vector). */
+		template <typename InputVectorT, typename ProfilerT>
+		void evalLayersGradient(const InputVectorT& input, const OutputType *expectedOutput, GradientType& gradient,
+			ProfilerT& profiler)
+		{
+			// eval deltas for all the layers from the output one to the first trained one
+			DeltasEvaluator<ProfilerT> deltasEvaluator = { *this, expectedOutput, profiler,
+				this->m_network.getFrozenPrefixLength(), NULL, 0, 0 };
+			this->m_network.forEachLayerBackward(deltasEvaluator);
+
+			// eval gradient for all the layers, input of each layer is output of the previous one
+			LayerGradientEvaluator<InputVectorT, ProfilerT> gradientEvaluator =
+				{ *this, input, NULL, gradient, profiler };
+			this->m_network.forEachLayer(gradientEvaluator);
+		}
+
+		/** Functor evaluating deltas of the single layers from the output one.
+		Weights of the next layer are kept for the previous (hidden) one. */
+		template <typename ProfilerT>
+		struct DeltasEvaluator
+		{
+			DeltaGradientEvaluator& evaluator;
+			const OutputType *expectedOutput;
+			ProfilerT& profiler;
+			size_t firstTrained;
+			const WeightType *nextWeights;
+			size_t nextStride, nextNeuronsCount;
+
+			template <typename LayerT>
+			inline void operator()(const LayerT& layer, size_t index)
+			{
+				if (index < firstTrained)
+					return;
+
+				profiler.beginLayer(PHASE_GRADIENT, index);
+				if (index + 1 == evaluator.m_network.getLayersCount())
+					evaluator.evalOutputLayerDeltas(layer, index, expectedOutput);
+				else
+					evaluator.evalHiddenLayerDeltas(layer, index, nextWeights, nextStride, nextNeuronsCount);
+				profiler.endLayer(PHASE_GRADIENT, index);
+
+				nextWeights = layer.getWeights();
+				nextStride = layer.getWeightsStride();
+				nextNeuronsCount = layer.getNeuronsCount();
+			}
+		};
+
+		/** Functor evaluating gradient of the single layers from the first one.
+		Input of the first layer is given, the others get outputs of the previous one. */
+		template <typename InputVectorT, typename ProfilerT>
+		struct LayerGradientEvaluator
+		{
+			DeltaGradientEvaluator& evaluator;
+			const InputVectorT& firstInput;
+			const InputType *input;
+			GradientType& gradient;
+			ProfilerT& profiler;
+
+			template <typename LayerT>
+			inline void operator()(const LayerT& layer, size_t index)
+			{
+				if (layer.isFrozen()) {
+					input = layer.getOutputCache();
+					return;
+				}
+
+				profiler.beginLayer(PHASE_GRADIENT, index);
+				if (index == 0)
+					evaluator.evalLayerGradient(layer, index, firstInput, gradient);
+				else
+					evaluator.evalLayerGradient(layer, index, input, gradient);
+				profiler.endLayer(PHASE_GRADIENT, index);
+				input = layer.getOutputCache();
+			}
+		};
+
+		/** Functor collecting inputs of the single layers - the given input of the
+		first one and the outputs of the previous layer of the others. */
+		struct LayerInputsCollector
+		{
+			std::vector<const InputType*>& inputs;
+			const InputType *input;
+
+			template <typename LayerT>
+			inline void operator()(const LayerT& layer, size_t)
+			{
+				inputs.push_back(input);
+				input = layer.getOutputCache();
+			}
+		};
+
+		/** Functor evaluating deltas of the single layers from the output one.
+		Gradient of the next (higher) layer is evaluated and passed to the layer
+		function after the deltas of the current one are evaluated with its weights. */
+		template <typename LayerFunction, typename ProfilerT>
+		struct FusedEvaluator
+		{
+			DeltaGradientEvaluator& evaluator;
+			const OutputType *expectedOutput;
+			GradientType& gradient;
+			LayerFunction& func;
+			ProfilerT& profiler;
+			size_t firstTrained;
+			const WeightType *nextWeights;
+			size_t nextStride, nextNeuronsCount;
+
+			/** Layer waiting for its gradient. */
+			size_t pending, pendingInputsCount, pendingNeuronsCount;
+
+			template <typename LayerT>
+			inline void operator()(const LayerT& layer, size_t index)
+			{
+				if (index < firstTrained)
+					return;
+
+				profiler.beginLayer(PHASE_GRADIENT, index);
+				if (index + 1 == evaluator.m_network.getLayersCount())
+					evaluator.evalOutputLayerDeltas(layer, index, expectedOutput);
+				else
+					evaluator.evalHiddenLayerDeltas(layer, index, nextWeights, nextStride, nextNeuronsCount);
+				profiler.endLayer(PHASE_GRADIENT, index);
+
+				flush();
+				if (!layer.isFrozen()) {
+					pending = index;
+					pendingInputsCount = layer.getInputsCount();
+					pendingNeuronsCount = layer.getNeuronsCount();
+				}
+
+				nextWeights = layer.getWeights();
+				nextStride = layer.getWeightsStride();
+				nextNeuronsCount = layer.getNeuronsCount();
+			}
+
+			/** Eval gradient of the waiting layer tile by tile and pass the tiles
+			to the layer function. */
+			void flush()
+			{
+				if (pending == NO_LAYER)
+					return;
+
+				profiler.beginLayer(PHASE_UPDATE, pending);
+				const size_t tileRows = std::max<size_t>(
+					FUSED_TILE_SIZE / ( gradient.getStride(pending) * sizeof(WeightType) ), 1 );
+				for (size_t first = 0; first < pendingNeuronsCount; first += tileRows)
+				{
+					const size_t count = std::min(tileRows, pendingNeuronsCount - first);
+					evaluator.evalGradientRows(pending, evaluator.m_inputs[pending], pendingInputsCount,
+						first, count, gradient);
+					func(pending, first, count);
+				}
+				profiler.endLayer(PHASE_UPDATE, pending);
+				pending = NO_LAYER;
+			}
+		};
 
 		/** Eval deltas for the output layer and for the given expected output. This method
 		supposes that output of the output layer is cached in it. */
-		void evalOutputLayerDeltas(const OutputType expectedOutput[])
+		template <typename LayerT>
+		void evalOutputLayerDeltas(const LayerT& layer, size_t index, const OutputType expectedOutput[])
 		{
-			const size_t layer = this->m_network.getLayersCount() - 1;
-			const size_t neuronsCount = this->m_network[layer].getNeuronsCount();
-			const OutputType *realOutput = this->m_network[layer].getOutputCache();
-			DeltaType *deltas = m_deltas[layer];
+			const size_t neuronsCount = layer.getNeuronsCount();
+			const OutputType *realOutput = layer.getOutputCache();
+			DeltaType *deltas = m_deltas[index];
 
 			// difference between the expected and real output
 			for (size_t i = 0; i < neuronsCount; ++i)
 				deltas[i] = ( realOutput[i] - expectedOutput[i] ) *
-					this->m_network[layer][i].getActivationFunc().valDerivation( realOutput[i] );
+					layer[i].getActivationFunc().valDerivation( realOutput[i] );
 		}
 
-		/** Eval deltas for the given hidden layer. This method supposes that output
-		of the layer is cached in it. */
-		void evalHiddenLayerDeltas(size_t layer)
+		/** Eval deltas for the softmax output layer. The gradient of the cross-entropy
+		error fused with the softmax is just the difference of the real and expected
+		output (the derivations of the softmax cancel out). */
+		template <typename NeuronT>
+		void evalOutputLayerDeltas(const SoftmaxLayer<NeuronT>& layer, size_t index,
+			const OutputType expectedOutput[])
 		{
-			const size_t nextLayer = layer + 1;
-			const size_t neuronsCount = this->m_network[layer].getNeuronsCount();
-			const size_t nextNeuronsCount = this->m_network[nextLayer].getNeuronsCount();
-			const OutputType *output = this->m_network[layer].getOutputCache();
-			DeltaType *deltas = m_deltas[layer];
-			const DeltaType *nextDeltas = m_deltas[nextLayer];
+			const size_t neuronsCount = layer.getNeuronsCount();
+			const OutputType *realOutput = layer.getOutputCache();
+			DeltaType *deltas = m_deltas[index];
 
 			for (size_t i = 0; i < neuronsCount; ++i)
+				deltas[i] = realOutput[i] - expectedOutput[i];
+		}
+
+		/** Eval deltas for the given hidden layer from the weights (in rows of the
+		given stride) and deltas of the next layer. This method supposes that output
+		of the layer is cached in it. */
+		template <typename LayerT>
+		void evalHiddenLayerDeltas(const LayerT& layer, size_t index,
+			const WeightType nextWeights[], size_t nextStride, size_t nextNeuronsCount)
+		{
+			const size_t neuronsCount = layer.getNeuronsCount();
+			const OutputType *output = layer.getOutputCache();
+			DeltaType *deltas = m_deltas[index];
+			const DeltaType *nextDeltas = m_deltas[index + 1];
+
+			// compute weighted sums of deltas from the next layer row by row
+			std::fill(deltas, deltas + neuronsCount, DeltaType());
+			for (size_t j = 0; j < nextNeuronsCount; ++j)
 			{
-				// compute weighted sum of deltas from the next layer
-				DeltaType nextDeltasSum = 0;
-				for (size_t j = 0; j < nextNeuronsCount; ++j)
-					nextDeltasSum += this->m_network[nextLayer][j][i] * nextDeltas[j];
-
-				// compute delta for each neuron from this layer
-				deltas[i] = nextDeltasSum *
-					this->m_network[layer][i].getActivationFunc().valDerivation( output[i] );
+				const WeightType *row = nextWeights + j * nextStride;
+				const DeltaType nextDelta = nextDeltas[j];
+				for (size_t i = 0; i < neuronsCount; ++i)
+					deltas[i] += row[i] * nextDelta;
 			}
+
+			// compute delta for each neuron from this layer
+			for (size_t i = 0; i < neuronsCount; ++i)
+				deltas[i] *= layer[i].getActivationFunc().valDerivation( output[i] );
 		}
 
-		/** Eval gradient for the given layer. */
-		void evalLayerGradient(size_t layer, const InputType input[], WeightType **gradientLayer)
+		/** Eval gradient for the given layer (the padding of the rows is left zero). */
+		template <typename LayerT>
+		void evalLayerGradient(const LayerT& layer, size_t index, const InputType input[], GradientType& gradient)
 		{
-			const size_t inputsCount = this->m_network[layer].getInputsCount();
-			const size_t neuronsCount = this->m_network[layer].getNeuronsCount();
-			const DeltaType *deltas = m_deltas[layer];
-			WeightType *gradient = *gradientLayer;
+			const size_t inputsCount = layer.getInputsCount();
+			const size_t neuronsCount = layer.getNeuronsCount();
+			const DeltaType *deltas = m_deltas[index];
 
-			size_t k = 0;
 			for (size_t j = 0; j < neuronsCount; ++j)
+			{
+				WeightType *row = gradient.getRow(index, j);
+				const DeltaType delta = deltas[j];
+				for (size_t i = 0; i < inputsCount; ++i)
+					row[i] = delta * input[i];
+			}
+		}
+
+		/** Eval gradient of the given rows (neurons) of the given layer. */
+		void evalGradientRows(size_t index, const InputType input[], size_t inputsCount,
+			size_t firstRow, size_t rowsCount, GradientType& gradient)
+		{
+			const DeltaType *deltas = m_deltas[index];
+			for (size_t j = firstRow; j < firstRow + rowsCount; ++j)
+			{
+				WeightType *row = gradient.getRow(index, j);
+				const DeltaType delta = deltas[j];
 				for (size_t i = 0; i < inputsCount; ++i)
-					gradient[k++] = deltas[j] * input[i];
+					row[i] = delta * input[i];
+			}
+		}
+
+		/** Eval gradient for the given layer only for the non-zero values of the
+		sparse input, the other values of the rows are left untouched. */
+		template <typename LayerT>
+		void evalLayerGradient(const LayerT& layer, size_t index, const SparseVector<InputType>& input,
+			GradientType& gradient)
+		{
+			const size_t neuronsCount = layer.getNeuronsCount();
+			const DeltaType *deltas = m_deltas[index];
+
+			for (size_t j = 0; j < neuronsCount; ++j)
+			{
+				WeightType *row = gradient.getRow(index, j);
+				const DeltaType delta = deltas[j];
+				for (size_t k = 0; k < input.count; ++k)
+					row[ input.indices[k] ] = delta * input.values[k];
+			}
 		}
 
 	private:
 		DeltaGradientEvaluator& operator=(const DeltaGradientEvaluator&);
 	};
+
+	template <typename NetworkT>
+	const size_t DeltaGradientEvaluator<NetworkT>::NO_LAYER;
+
+	template <typename NetworkT>
+	const size_t DeltaGradientEvaluator<NetworkT>::FUSED_TILE_SIZE;
+
+
+	/**
+	Evaluator of gradients of the single outputs of the network (rows of its
+	Jacobian) for the Levenberg-Marquardt algorithm. It's DeltaGradientEvaluator
+	with deltas of the output layer replaced by the derivation of the given output
+	only, therefore the output layer mustn't be a SoftmaxLayer.
+	*/
+	template <typename NetworkT>
+	class JacobianEvaluator :
+		public DeltaGradientEvaluator<NetworkT>
+	{
+	private:
+		typedef DeltaGradientEvaluator<NetworkT> _EvaluatorBase;
+
+	public:
+		typedef typename _EvaluatorBase::NetworkType NetworkType;
+		typedef typename _EvaluatorBase::InputType  InputType;
+		typedef typename _EvaluatorBase::OutputType OutputType;
+		typedef typename _EvaluatorBase::GradientType GradientType;
+
+		JacobianEvaluator(const NetworkType& network) :
+		_EvaluatorBase(network), m_targets( network.getOutputsCount() )
+		{ }
+
+		/** Eval gradient of the given output for the given input. This method
+		supposes that the network was evaluated for the input. */
+		void evalOutputGradient(const InputType *input, size_t output, GradientType& gradient)
+		{
+			// the target differs from the real output only by one at the given output
+			// so the deltas of the other outputs are zero
+			const OutputType *realOutput = this->m_network.getOutputCache();
+			std::copy( realOutput, realOutput + m_targets.size(), m_targets.begin() );
+			m_targets[output] -= 1;
+			this->evalGradient( input, &m_targets[0], gradient );
+		}
+
+	protected:
+		std::vector<OutputType> m_targets;
+
+	private:
+		JacobianEvaluator& operator=(const JacobianEvaluator&);
+	};
 	
 }
 
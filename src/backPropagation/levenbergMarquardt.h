@@ -0,0 +1,389 @@
+#ifndef _LEVENBERG_MARQUARDT_H_
+#define _LEVENBERG_MARQUARDT_H_
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include "common/cholesky.h"
+#include "common/threads.h"
+#include "common/utils.h"
+#include "backPropagation/gradientEvaluator.h"
+#include "backPropagation/batchTrainer.h"
+
+namespace NNLib
+{
+
+	/**
+	Levenberg-Marquardt algorithm for networks with the squared error and up to a
+	few thousands of weights (the approximate Hessian takes getTrainedCount()^2
+	doubles). Every epoch builds the Gauss-Newton system J^T * J and J^T * e of
+	the current weights, where J is the Jacobian of the outputs of all the
+	patterns and e are their errors, and solves the damped system
+	(J^T * J + mu * I) * step = J^T * e by the Cholesky decomposition. The damping
+	is decreased after a step which lowers the error and increased (and the
+	system solved again) otherwise.
+
+	The Jacobian is built in blocks of rows (outputs of a chunk of patterns) -
+	the rows are evaluated in more threads by JacobianEvaluators on the copies
+	of the network of the threads of BatchGradientEvaluator (which evaluates
+	the errors of the trial steps) and every block is added to the upper half of J^T * J by a
+	symmetric rank-k update split among the threads by rows of the matrix.
+	Only the weights of layers which aren't frozen are trained. The output layer
+	mustn't be a SoftmaxLayer.
+	*/
+	template <typename NetworkT, typename ContT>
+	class LevenbergMarquardt :
+		public BatchTrainerBase<NetworkT, ContT>
+	{
+	private:
+		typedef BatchTrainerBase<NetworkT, ContT> _TrainerBase;
+
+	public:
+		typedef typename _TrainerBase::NetworkType NetworkType;
+		typedef typename _TrainerBase::WeightType WeightType;
+		typedef typename _TrainerBase::ErrorType ErrorType;
+		typedef typename _TrainerBase::ContainerType ContainerType;
+		typedef typename _TrainerBase::GradientType GradientType;
+		typedef typename ContainerType::value_type DataType;
+		typedef typename NetworkType::OutputType OutputType;
+
+		/** Default initial damping. */
+		static const double DEF_DAMPING;
+
+		/** Default factor of the damping change. */
+		static const double DEF_DAMPING_FACTOR;
+
+		/** Count of rows of a block of the Jacobian (at least one pattern). */
+		static const size_t BLOCK_ROWS = 256;
+
+		/** Zero count of threads means to use all the hardware threads. */
+		LevenbergMarquardt(NetworkType& network, const ContainerType& data, size_t threadsCount = 0) :
+		_TrainerBase(network, data, threadsCount),
+		m_data(data), m_outputsCount( network.getOutputsCount() ),
+		m_blockPatterns( std::max<size_t>(BLOCK_ROWS / network.getOutputsCount(), 1) ),
+		m_blockRows( m_blockPatterns * network.getOutputsCount() ),
+		m_damping(DEF_DAMPING), m_dampingFactor(DEF_DAMPING_FACTOR), m_trainedCount(0)
+		{
+			for (size_t thread = 0; thread < this->m_evaluator.getThreadsCount(); ++thread)
+				m_workers.push_back( new Worker( this->m_evaluator.getNetwork(thread) ) );
+		}
+
+		~LevenbergMarquardt()
+		{
+			deleteRange( m_workers.begin(), m_workers.end() );
+		}
+
+		virtual void reset()
+		{
+			_TrainerBase::reset();
+			m_damping = DEF_DAMPING;
+		}
+
+		inline double getDamping() const { return m_damping; }
+		inline void setDamping(double damping) { m_damping = damping; }
+
+		inline double getDampingFactor() const { return m_dampingFactor; }
+		inline void setDampingFactor(double factor) { m_dampingFactor = factor; }
+
+		/** Get count of the trained weights (size of the solved system). */
+		inline size_t getTrainedCount() const { return m_trainedCount; }
+
+	protected:
+		/** Buffers of one thread working on the copy of the network of the same
+		thread of the evaluator. */
+		struct Worker
+		{
+			NetworkType& network;
+			JacobianEvaluator<NetworkType> evaluator;
+			GradientType gradient;
+			double error;
+
+			Worker(NetworkType& network) :
+			network(network), evaluator(network), gradient(network), error(0)
+			{ }
+		};
+
+		/** Functor evaluating rows of a block of the Jacobian (used by parallelFor). */
+		struct BlockEvaluator
+		{
+			LevenbergMarquardt& trainer;
+			size_t first;
+
+			inline void operator()(size_t thread, size_t begin, size_t end)
+			{
+				trainer.evalJacobianRows(thread, first, first + begin, first + end);
+			}
+		};
+
+		/** Functor adding a block of the Jacobian to the system (used by parallelFor). */
+		struct BlockAccumulator
+		{
+			LevenbergMarquardt& trainer;
+			size_t rowsCount;
+
+			inline void operator()(size_t, size_t begin, size_t end)
+			{
+				for (size_t part = begin; part < end; ++part)
+					trainer.accumBlock( trainer.m_parts[part], trainer.m_parts[part + 1], rowsCount );
+			}
+		};
+
+		const ContainerType& m_data;
+		const size_t m_outputsCount;
+		const size_t m_blockPatterns, m_blockRows;
+		std::vector<Worker*> m_workers;
+
+		double m_damping, m_dampingFactor;
+
+		/** Indices of the trained weights in WeightsBuffer. */
+		std::vector<size_t> m_trained;
+		size_t m_trainedCount;
+
+		/** J^T * J in the upper triangle, the Cholesky factor in the lower one. */
+		std::vector<double> m_system;
+		std::vector<double> m_factorDiagonal;
+
+		/** J^T * e and the solved step. */
+		std::vector<double> m_errorGradient, m_step;
+
+		/** Transposed block of the Jacobian (m_blockRows values per weight) and errors of its rows. */
+		std::vector<double> m_block;
+		std::vector<double> m_blockErrors;
+
+		/** First rows of the system of the single threads (of similar work). */
+		std::vector<size_t> m_parts;
+
+		static const double MIN_DAMPING, MAX_DAMPING;
+
+		/** Count of columns of the system processed at once by the rank-k update. */
+		static const size_t TILE_SIZE = 64;
+
+		/** Functor collecting indices of the weights of the trained layers. */
+		struct TrainedIndices
+		{
+			const GradientType& buffer;
+			std::vector<size_t>& indices;
+
+			template <typename LayerT>
+			inline void operator()(const LayerT& layer, size_t index)
+			{
+				if ( layer.isFrozen() )
+					return;
+				for (size_t j = 0; j < layer.getNeuronsCount(); ++j)
+					for (size_t i = 0; i < layer.getInputsCount(); ++i)
+						indices.push_back( buffer.getIndex(index, j, i) );
+			}
+		};
+
+		virtual void start()
+		{
+			this->m_network.saveWeights(this->m_weights);
+
+			m_trained.clear();
+			TrainedIndices collector = { this->m_weights, m_trained };
+			static_cast<const NetworkType&>(this->m_network).forEachLayer(collector);
+			m_trainedCount = m_trained.size();
+
+			m_system.assign(m_trainedCount * m_trainedCount, 0);
+			m_factorDiagonal.assign(m_trainedCount, 0);
+			m_errorGradient.assign(m_trainedCount, 0);
+			m_step.assign(m_trainedCount, 0);
+			m_block.assign(m_trainedCount * m_blockRows, 0);
+			m_blockErrors.assign(m_blockRows, 0);
+			splitRows();
+
+			buildSystem();
+			this->m_started = true;
+		}
+
+		virtual bool step()
+		{
+			for (;;)
+			{
+				if ( choleskyFactor(&m_system[0], m_trainedCount, m_damping, &m_factorDiagonal[0]) )
+				{
+					std::copy( m_errorGradient.begin(), m_errorGradient.end(), m_step.begin() );
+					choleskySolve(&m_system[0], m_trainedCount, &m_factorDiagonal[0], &m_step[0]);
+
+					this->m_trial.copyFrom(this->m_weights);
+					WeightType *trial = this->m_trial.getData();
+					for (size_t i = 0; i < m_trainedCount; ++i)
+						trial[ m_trained[i] ] -= static_cast<WeightType>( m_step[i] );
+
+					++this->m_evalsCount;
+					if ( this->m_evaluator.evalError(trial) < this->m_error ) {
+						this->m_weights.copyFrom(this->m_trial);
+						m_damping = std::max(m_damping / m_dampingFactor, MIN_DAMPING);
+						buildSystem();
+						return true;
+					}
+				}
+
+				m_damping *= m_dampingFactor;
+				if (m_damping > MAX_DAMPING) {
+					m_damping = MAX_DAMPING;
+					return false;
+				}
+			}
+		}
+
+		/** Split rows of the system among the threads so that their parts of the
+		upper triangle are of similar sizes. */
+		void splitRows()
+		{
+			const size_t n = m_trainedCount;
+			const size_t partsCount = m_workers.size();
+			const double total = 0.5 * n * (n + 1);
+
+			m_parts.assign(1, 0);
+			double work = 0;
+			for (size_t row = 0; row < n && m_parts.size() < partsCount; ++row) {
+				work += n - row;
+				if ( work >= total * m_parts.size() / partsCount )
+					m_parts.push_back(row + 1);
+			}
+			m_parts.push_back(n);
+		}
+
+		/** Build J^T * J, J^T * e and the error for the current weights. */
+		void buildSystem()
+		{
+			++this->m_evalsCount;
+			for (size_t thread = 0; thread < m_workers.size(); ++thread) {
+				m_workers[thread]->network.restoreWeights(this->m_weights);
+				m_workers[thread]->error = 0;
+			}
+			std::fill(m_system.begin(), m_system.end(), 0.0);
+			std::fill(m_errorGradient.begin(), m_errorGradient.end(), 0.0);
+
+			for (size_t first = 0; first < m_data.size(); first += m_blockPatterns)
+			{
+				const size_t patternsCount = std::min(m_blockPatterns, m_data.size() - first);
+				BlockEvaluator evaluator = { *this, first };
+				parallelFor(patternsCount, m_workers.size(), evaluator);
+
+				BlockAccumulator accumulator = { *this, patternsCount * m_outputsCount };
+				parallelFor(m_parts.size() - 1, m_parts.size() - 1, accumulator);
+			}
+
+			double error = 0;
+			for (size_t thread = 0; thread < m_workers.size(); ++thread)
+				error += m_workers[thread]->error;
+			this->m_error = static_cast<ErrorType>(error);
+
+			// J^T * e is the gradient of the error
+			this->m_gradient.fill(0);
+			WeightType *gradient = this->m_gradient.getData();
+			double norm2 = 0;
+			for (size_t i = 0; i < m_trainedCount; ++i) {
+				gradient[ m_trained[i] ] = static_cast<WeightType>( m_errorGradient[i] );
+				norm2 += m_errorGradient[i] * m_errorGradient[i];
+			}
+			this->m_gradientNorm = std::sqrt(norm2);
+		}
+
+		/** Eval rows of the given patterns of the block starting at the first pattern. */
+		void evalJacobianRows(size_t thread, size_t first, size_t begin, size_t end)
+		{
+			Worker& worker = *m_workers[thread];
+			const WeightType *gradient = worker.gradient.getData();
+
+			for (size_t p = begin; p < end; ++p)
+			{
+				const DataType& pattern = m_data[p];
+				const OutputType *realOutput = worker.network.eval( pattern.getInput() );
+
+				for (size_t k = 0; k < m_outputsCount; ++k)
+				{
+					const size_t row = (p - first) * m_outputsCount + k;
+					const double error = realOutput[k] - pattern.getOutput()[k];
+					m_blockErrors[row] = error;
+					worker.error += 0.5 * error * error;
+
+					worker.evaluator.evalOutputGradient( pattern.getInput(), k, worker.gradient );
+					for (size_t i = 0; i < m_trainedCount; ++i)
+						m_block[i * m_blockRows + row] = gradient[ m_trained[i] ];
+				}
+			}
+		}
+
+		/** Add the block of the Jacobian to the rows [begin, end) of the upper
+		triangle of J^T * J (tile by tile of columns so the columns stay in the
+		cache) and of J^T * e. */
+		void accumBlock(size_t begin, size_t end, size_t rowsCount)
+		{
+			const double *block = &m_block[0];
+			for (size_t tile = begin; tile < m_trainedCount; tile += TILE_SIZE)
+			{
+				const size_t tileEnd = std::min(tile + TILE_SIZE, m_trainedCount);
+				const size_t rowsEnd = std::min(end, tileEnd);
+				for (size_t i = begin; i < rowsEnd; ++i)
+				{
+					double *row = &m_system[i * m_trainedCount];
+					const double *columnI = block + i * m_blockRows;
+					size_t j = std::max(i, tile);
+					for (; j + 4 <= tileEnd; j += 4)
+						dot4(columnI, block + j * m_blockRows, m_blockRows, rowsCount, row + j);
+					for (; j < tileEnd; ++j)
+						row[j] += dot(columnI, block + j * m_blockRows, rowsCount);
+				}
+			}
+
+			for (size_t i = begin; i < end; ++i)
+				m_errorGradient[i] += dot(block + i * m_blockRows, &m_blockErrors[0], rowsCount);
+		}
+
+		static inline double dot(const double x[], const double y[], size_t len)
+		{
+			double sum = 0;
+			for (size_t r = 0; r < len; ++r)
+				sum += x[r] * y[r];
+			return sum;
+		}
+
+		/** Add dot products of x with four columns of the given stride to the
+		given sums (x is loaded only once for all of them). */
+		static inline void dot4(const double x[], const double columns[], size_t stride, size_t len,
+			double sums[])
+		{
+			const double *c0 = columns, *c1 = columns + stride, *c2 = c1 + stride, *c3 = c2 + stride;
+			double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+			for (size_t r = 0; r < len; ++r) {
+				const double v = x[r];
+				s0 += v * c0[r];
+				s1 += v * c1[r];
+				s2 += v * c2[r];
+				s3 += v * c3[r];
+			}
+			sums[0] += s0;
+			sums[1] += s1;
+			sums[2] += s2;
+			sums[3] += s3;
+		}
+
+	private:
+		LevenbergMarquardt(const LevenbergMarquardt&);
+		LevenbergMarquardt& operator=(const LevenbergMarquardt&);
+	};
+
+	template <typename NetworkT, typename ContT>
+	const double LevenbergMarquardt<NetworkT, ContT>::DEF_DAMPING = 1e-3;
+
+	template <typename NetworkT, typename ContT>
+	const double LevenbergMarquardt<NetworkT, ContT>::DEF_DAMPING_FACTOR = 10;
+
+	template <typename NetworkT, typename ContT>
+	const double LevenbergMarquardt<NetworkT, ContT>::MIN_DAMPING = 1e-20;
+
+	template <typename NetworkT, typename ContT>
+	const double LevenbergMarquardt<NetworkT, ContT>::MAX_DAMPING = 1e10;
+
+	template <typename NetworkT, typename ContT>
+	const size_t LevenbergMarquardt<NetworkT, ContT>::BLOCK_ROWS;
+
+	template <typename NetworkT, typename ContT>
+	const size_t LevenbergMarquardt<NetworkT, ContT>::TILE_SIZE;
+
+}
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef _MOMENT_UPDATES_H_
+#define _MOMENT_UPDATES_H_
+
+#include <cmath>
+#include "common/simd.h"
+
+namespace NNLib
+{
+
+	/**
+	Fused kernels of the moment based updaters - the moments and the weights are
+	updated in one pass over the arrays. Generic versions are plain loops, the
+	float versions use SSE (if available) - four weights at once. The arrays
+	don't have to be aligned.
+	*/
+
+	/**
+	m = beta1 * m + (1 - beta1) * g
+	v = beta2 * v + (1 - beta2) * g^2
+	w = w - step * m / (sqrt(v) + epsilon) - decay * w
+	*/
+	template <typename T>
+	void updateAdamMoments(T w[], const T g[], T m[], T v[], size_t len,
+		T step, T beta1, T beta2, T epsilon, T decay)
+	{
+		const T beta1Inv = 1 - beta1, beta2Inv = 1 - beta2;
+		for (size_t i = 0; i < len; ++i) {
+			m[i] = beta1 * m[i] + beta1Inv * g[i];
+			v[i] = beta2 * v[i] + beta2Inv * g[i] * g[i];
+			w[i] -= step * m[i] / (std::sqrt(v[i]) + epsilon) + decay * w[i];
+		}
+	}
+
+	/**
+	v = rho * v + scale * g^2
+	w = w - rate * g / (sqrt(v) + epsilon)
+	*/
+	template <typename T>
+	void updateSquaresMoments(T w[], const T g[], T v[], size_t len,
+		T rate, T rho, T scale, T epsilon)
+	{
+		for (size_t i = 0; i < len; ++i) {
+			v[i] = rho * v[i] + scale * g[i] * g[i];
+			w[i] -= rate * g[i] / (std::sqrt(v[i]) + epsilon);
+		}
+	}
+
+
+	#ifdef NNLIB_HAS_SSE
+
+	inline void updateAdamMoments(float w[], const float g[], float m[], float v[], size_t len,
+		float step, float beta1, float beta2, float epsilon, float decay)
+	{
+		const __m128 mbeta1 = _mm_set1_ps(beta1), mbeta1Inv = _mm_set1_ps(1 - beta1);
+		const __m128 mbeta2 = _mm_set1_ps(beta2), mbeta2Inv = _mm_set1_ps(1 - beta2);
+		const __m128 mstep = _mm_set1_ps(step), mepsilon = _mm_set1_ps(epsilon), mdecay = _mm_set1_ps(decay);
+		const size_t vecLen = len - len % SSE_FLOATS;
+		for (size_t i = 0; i < vecLen; i += SSE_FLOATS) {
+			const __m128 mg = _mm_loadu_ps(g + i);
+			const __m128 mm = _mm_add_ps( _mm_mul_ps(mbeta1, _mm_loadu_ps(m + i)), _mm_mul_ps(mbeta1Inv, mg) );
+			const __m128 mv = _mm_add_ps( _mm_mul_ps(mbeta2, _mm_loadu_ps(v + i)),
+				_mm_mul_ps(mbeta2Inv, _mm_mul_ps(mg, mg)) );
+			const __m128 mw = _mm_loadu_ps(w + i);
+			const __m128 delta = _mm_div_ps( _mm_mul_ps(mstep, mm), _mm_add_ps(_mm_sqrt_ps(mv), mepsilon) );
+			_mm_storeu_ps( m + i, mm );
+			_mm_storeu_ps( v + i, mv );
+			_mm_storeu_ps( w + i, _mm_sub_ps( mw, _mm_add_ps(delta, _mm_mul_ps(mdecay, mw)) ) );
+		}
+		updateAdamMoments<float>(w + vecLen, g + vecLen, m + vecLen, v + vecLen, len - vecLen,
+			step, beta1, beta2, epsilon, decay);
+	}
+
+	inline void updateSquaresMoments(float w[], const float g[], float v[], size_t len,
+		float rate, float rho, float scale, float epsilon)
+	{
+		const __m128 mrate = _mm_set1_ps(rate), mrho = _mm_set1_ps(rho);
+		const __m128 mscale = _mm_set1_ps(scale), mepsilon = _mm_set1_ps(epsilon);
+		const size_t vecLen = len - len % SSE_FLOATS;
+		for (size_t i = 0; i < vecLen; i += SSE_FLOATS) {
+			const __m128 mg = _mm_loadu_ps(g + i);
+			const __m128 mv = _mm_add_ps( _mm_mul_ps(mrho, _mm_loadu_ps(v + i)),
+				_mm_mul_ps(mscale, _mm_mul_ps(mg, mg)) );
+			const __m128 delta = _mm_div_ps( _mm_mul_ps(mrate, mg), _mm_add_ps(_mm_sqrt_ps(mv), mepsilon) );
+			_mm_storeu_ps( v + i, mv );
+			_mm_storeu_ps( w + i, _mm_sub_ps(_mm_loadu_ps(w + i), delta) );
+		}
+		updateSquaresMoments<float>(w + vecLen, g + vecLen, v + vecLen, len - vecLen,
+			rate, rho, scale, epsilon);
+	}
+
+	#endif
+
+}
+
+#endif
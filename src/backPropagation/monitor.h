@@ -1,159 +1,242 @@
-#ifndef _MONITOR_H_
-#define _MONITOR_H_
-
-#include <string>
-#include <iostream>
-#include <iomanip>
-#include <vector>
-
-namespace NNLib
-{
-
-	/**
-	Base class for an every monitor class.
-	*/
-	class Monitor
-	{
-	public:
-		Monitor(unsigned timer = DEF_TIMER) :
-		m_timer(timer), m_counter(0)
-		{ }
-
-		inline void operator()()
-		{
-			if ( ++m_counter == m_timer ) {
-				execute();
-				m_counter = 0;
-			}
-		}
-
-		virtual void execute() = 0;
-		
-		// virtual destructor due to inheritance
-		virtual ~Monitor() { }
-
-	protected:
-		static const unsigned DEF_TIMER = 1;
-		const unsigned m_timer;
-		unsigned m_counter;
-
-	private:
-		Monitor& operator=(const Monitor&);
-	};
-
-
-	/**
-	This monitor does nothing.
-	*/
-	class EmptyMonitor :
-		public Monitor
-	{
-	public:
-		// do nothing
-		virtual void execute() { }
-	};
-
-
-	/**
-	Combined monitor that holds a list of other monitors and call
-	them in the given order.
-	*/
-	class CombinedMonitor :
-		public Monitor
-	{
-	protected:
-		typedef std::vector<Monitor*> MonitorsList;
-
-	public:
-		CombinedMonitor(unsigned timer = DEF_TIMER) :
-		Monitor(timer)
-		{ }
-
-		inline void add(Monitor& monitor)
-		{
-			m_monitors.push_back(&monitor);
-		}
-
-		virtual void execute()
-		{
-			for (MonitorsList::iterator it = m_monitors.begin(); it != m_monitors.end(); ++it)
-				(**it)();
-		}
-
-	protected:
-		/** List of all the monitors to be called by this monitor. */
-		MonitorsList m_monitors;
-	};
-	
-	
-	/**
-	This monitor prints out the given parameter's value. The parameter has to
-	have operator << for printing to ostream overloaded.
-	*/
-	template <typename ParamT>
-	class ParamMonitor :
-		public Monitor
-	{
-	public:
-		typedef ParamT ParamType;
-		
-		ParamMonitor(std::ostream& os, const ParamType& param,
-			unsigned timer = DEF_TIMER, const std::string& delim = DEF_DELIM) :
-		Monitor(timer), m_ostream(os), m_param(param), m_delim(delim)
-		{ }
-		
-		virtual void execute()
-		{
-			m_ostream << m_param << std::endl << m_delim;
-		}
-		
-	protected:
-		std::ostream& m_ostream;
-		const ParamType& m_param;
-		const std::string m_delim;
-		
-		static const char* DEF_DELIM;
-		
-	private:
-		ParamMonitor& operator=(const ParamMonitor&);
-	};
-	
-	template <typename ParamT>
-	const char* ParamMonitor<ParamT>::DEF_DELIM = "";
-	
-	
-	/**
-	This monitor prints out the given parameter's name and its value. The parameter
-	has to have operator << for printing to ostream overloaded.
-	*/
-	template <typename ParamT>
-	class NamedParamMonitor :
-		public ParamMonitor<ParamT>
-	{
-	private:
-		typedef ParamMonitor<ParamT> _ParamMonitor;
-		
-	public:
-		typedef typename _ParamMonitor::ParamType ParamType;
-		
-		NamedParamMonitor(std::ostream& os, const ParamType& param, const std::string& name,
-			unsigned timer = _ParamMonitor::DEF_TIMER, const std::string& delim = _ParamMonitor::DEF_DELIM) :
-		_ParamMonitor(os, param, timer, delim), m_name(name)
-		{ }
-		
-		virtual void execute()
-		{
-			this->m_ostream << m_name << std::endl;
-			_ParamMonitor::execute();
-		}
-		
-	protected:
-		const std::string m_name;
-		
-	private:
-		NamedParamMonitor& operator=(const NamedParamMonitor&);
-	};
-
-}
-
+#ifndef _MONITOR_H_
+#define _MONITOR_H_
+
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+namespace NNLib
+{
+
+	template <typename T>
+	struct SnapshotVoid
+	{
+		typedef void Type;
+	};
+
+	/**
+	Type of a cheap copy of a monitored parameter (e.g. for the asynchronous
+	monitors) - the nested SnapshotType of the parameter if it has one,
+	otherwise the parameter itself.
+	*/
+	template <typename ParamT, typename = void>
+	struct ParamSnapshot
+	{
+		typedef ParamT Type;
+	};
+
+	template <typename ParamT>
+	struct ParamSnapshot<ParamT, typename SnapshotVoid<typename ParamT::SnapshotType>::Type>
+	{
+		typedef typename ParamT::SnapshotType Type;
+	};
+
+
+	/**
+	Base class for an every monitor class.
+	*/
+	class Monitor
+	{
+	public:
+		Monitor(unsigned timer = DEF_TIMER) :
+		m_timer(timer), m_counter(0)
+		{ }
+
+		inline void operator()()
+		{
+			if ( tick() )
+				execute();
+		}
+
+		/** Count the call and return whether the monitor should be executed. */
+		inline bool tick()
+		{
+			if ( ++m_counter != m_timer )
+				return false;
+			m_counter = 0;
+			return true;
+		}
+
+		virtual void execute() = 0;
+		
+		// virtual destructor due to inheritance
+		virtual ~Monitor() { }
+
+	protected:
+		static const unsigned DEF_TIMER = 1;
+		const unsigned m_timer;
+		unsigned m_counter;
+
+	private:
+		Monitor& operator=(const Monitor&);
+	};
+
+
+	/**
+	Call the monitor through its static type - execute() of a final monitor
+	class (EmptyMonitor, MonitorPair) isn't called virtually and can be inlined.
+	*/
+	template <typename MonitorT>
+	inline void callMonitor(MonitorT& monitor)
+	{
+		if ( monitor.tick() )
+			monitor.execute();
+	}
+
+
+	/**
+	This monitor does nothing.
+	*/
+	class EmptyMonitor final :
+		public Monitor
+	{
+	public:
+		// do nothing
+		virtual void execute() { }
+	};
+
+
+	/**
+	Combined monitor that holds a list of other monitors and call
+	them in the given order.
+	*/
+	class CombinedMonitor :
+		public Monitor
+	{
+	protected:
+		typedef std::vector<Monitor*> MonitorsList;
+
+	public:
+		CombinedMonitor(unsigned timer = DEF_TIMER) :
+		Monitor(timer)
+		{ }
+
+		inline void add(Monitor& monitor)
+		{
+			m_monitors.push_back(&monitor);
+		}
+
+		virtual void execute()
+		{
+			for (MonitorsList::iterator it = m_monitors.begin(); it != m_monitors.end(); ++it)
+				(**it)();
+		}
+
+	protected:
+		/** List of all the monitors to be called by this monitor. */
+		MonitorsList m_monitors;
+	};
+	
+	
+	/**
+	Combination of two monitors resolved at compile time - they are called in
+	the given order without the virtual calls (if their classes are final or
+	also MonitorPairs) and without the list of CombinedMonitor. Pairs can be
+	nested to combine more monitors.
+	*/
+	template <typename FirstT, typename SecondT>
+	class MonitorPair final :
+		public Monitor
+	{
+	public:
+		typedef FirstT FirstType;
+		typedef SecondT SecondType;
+
+		MonitorPair(FirstType& first, SecondType& second, unsigned timer = DEF_TIMER) :
+		Monitor(timer), m_first(first), m_second(second)
+		{ }
+
+		virtual void execute()
+		{
+			callMonitor(m_first);
+			callMonitor(m_second);
+		}
+
+	protected:
+		FirstType& m_first;
+		SecondType& m_second;
+
+	private:
+		MonitorPair& operator=(const MonitorPair&);
+	};
+
+	/** Create combination of the given monitors. */
+	template <typename FirstT, typename SecondT>
+	inline MonitorPair<FirstT, SecondT> combineMonitors(FirstT& first, SecondT& second)
+	{
+		return MonitorPair<FirstT, SecondT>(first, second);
+	}
+	
+	
+	/**
+	This monitor prints out the given parameter's value. The parameter has to
+	have operator << for printing to ostream overloaded.
+	*/
+	template <typename ParamT>
+	class ParamMonitor :
+		public Monitor
+	{
+	public:
+		typedef ParamT ParamType;
+		
+		ParamMonitor(std::ostream& os, const ParamType& param,
+			unsigned timer = DEF_TIMER, const std::string& delim = DEF_DELIM) :
+		Monitor(timer), m_ostream(os), m_param(param), m_delim(delim)
+		{ }
+		
+		virtual void execute()
+		{
+			m_ostream << m_param << std::endl << m_delim;
+		}
+		
+	protected:
+		std::ostream& m_ostream;
+		const ParamType& m_param;
+		const std::string m_delim;
+		
+		static const char* DEF_DELIM;
+		
+	private:
+		ParamMonitor& operator=(const ParamMonitor&);
+	};
+	
+	template <typename ParamT>
+	const char* ParamMonitor<ParamT>::DEF_DELIM = "";
+	
+	
+	/**
+	This monitor prints out the given parameter's name and its value. The parameter
+	has to have operator << for printing to ostream overloaded.
+	*/
+	template <typename ParamT>
+	class NamedParamMonitor :
+		public ParamMonitor<ParamT>
+	{
+	private:
+		typedef ParamMonitor<ParamT> _ParamMonitor;
+		
+	public:
+		typedef typename _ParamMonitor::ParamType ParamType;
+		
+		NamedParamMonitor(std::ostream& os, const ParamType& param, const std::string& name,
+			unsigned timer = _ParamMonitor::DEF_TIMER, const std::string& delim = _ParamMonitor::DEF_DELIM) :
+		_ParamMonitor(os, param, timer, delim), m_name(name)
+		{ }
+		
+		virtual void execute()
+		{
+			this->m_ostream << m_name << std::endl;
+			_ParamMonitor::execute();
+		}
+		
+	protected:
+		const std::string m_name;
+		
+	private:
+		NamedParamMonitor& operator=(const NamedParamMonitor&);
+	};
+
+}
+
 #endif
\ No newline at end of file
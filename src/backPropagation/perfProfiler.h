@@ -0,0 +1,152 @@
+#ifndef _PERF_PROFILER_H_
+#define _PERF_PROFILER_H_
+
+#include <ostream>
+#include "common/perfCounters.h"
+#include "backPropagation/profiler.h"
+#include "backPropagation/monitor.h"
+
+namespace NNLib
+{
+
+	/**
+	Profiler which reads the hardware performance counters (cycles, instructions,
+	cache and branch misses) at the begin and the end of every phase of the
+	training. It can be passed to BackPropBase::run() like the PhaseProfiler or
+	its begin(PHASE_EVAL) and end(PHASE_EVAL) can be called around
+	FeedForwardNetwork::eval(). Every reading is a system call, so the phases are
+	measured as wholes, not per layer. If the counters are not available nothing
+	is measured and isAvailable() returns false.
+	*/
+	class PerfProfiler
+	{
+	public:
+		/** The count of weights of the profiled network is used to report the
+		events per weight (zero means not to report them). */
+		PerfProfiler(size_t weightsCount = 0) :
+		m_weightsCount(weightsCount)
+		{
+			reset();
+		}
+
+		inline void begin(TrainingPhase phase)
+		{
+			m_counters.read( m_start[phase] );
+		}
+
+		inline void end(TrainingPhase phase)
+		{
+			PerfValues now;
+			m_counters.read(now);
+			m_values[phase] += now - m_start[phase];
+			++m_counts[phase];
+		}
+
+		inline void beginLayer(TrainingPhase, size_t) { }
+		inline void endLayer(TrainingPhase, size_t) { }
+
+		void reset()
+		{
+			for (size_t phase = 0; phase < PHASES_COUNT; ++phase) {
+				m_values[phase] = m_start[phase] = PerfValues();
+				m_counts[phase] = 0;
+			}
+		}
+
+		inline bool isAvailable() const { return m_counters.isAvailable(); }
+		inline bool isAvailable(PerfEvent event) const { return m_counters.isAvailable(event); }
+
+		inline size_t getWeightsCount() const { return m_weightsCount; }
+		inline size_t getCount(TrainingPhase phase) const { return m_counts[phase]; }
+		inline PerfValueType getValue(TrainingPhase phase, PerfEvent event) const { return m_values[phase][event]; }
+
+		/** Get instructions per cycle in the given phase. */
+		inline double getIPC(TrainingPhase phase) const
+		{
+			const PerfValueType cycles = getValue(phase, PERF_CYCLES);
+			return (cycles > 0) ? static_cast<double>( getValue(phase, PERF_INSTRUCTIONS) ) / cycles : 0;
+		}
+
+		/** Get average count of the event per one call of the phase (i.e. per pattern). */
+		inline double getPerPattern(TrainingPhase phase, PerfEvent event) const
+		{
+			return (m_counts[phase] > 0) ? static_cast<double>( getValue(phase, event) ) / m_counts[phase] : 0;
+		}
+
+		/** Get average count of the event per one call of the phase and one weight. */
+		inline double getPerWeight(TrainingPhase phase, PerfEvent event) const
+		{
+			return (m_weightsCount > 0) ? getPerPattern(phase, event) / m_weightsCount : 0;
+		}
+
+	protected:
+		PerfCounters m_counters;
+		const size_t m_weightsCount;
+
+		PerfValues m_start[PHASES_COUNT];
+		PerfValues m_values[PHASES_COUNT];
+		size_t m_counts[PHASES_COUNT];
+
+	private:
+		PerfProfiler(const PerfProfiler&);
+		PerfProfiler& operator=(const PerfProfiler&);
+	};
+
+
+	/** Print IPC and events per pattern (and per weight) of the single phases. */
+	inline std::ostream& operator<<(std::ostream& os, const PerfProfiler& profiler)
+	{
+		if ( !profiler.isAvailable() )
+			return os << "hardware performance counters not available\n";
+
+		for (size_t phase = 0; phase < PHASES_COUNT; ++phase)
+		{
+			const TrainingPhase p = static_cast<TrainingPhase>(phase);
+			if (profiler.getCount(p) == 0)
+				continue;
+			os << getPhaseName(p) << ": ipc=" << profiler.getIPC(p);
+			for (size_t event = 0; event < PERF_EVENTS_COUNT; ++event)
+			{
+				const PerfEvent e = static_cast<PerfEvent>(event);
+				os << " " << getPerfEventName(e) << "/pattern=";
+				if ( !profiler.isAvailable(e) ) {
+					os << "n/a";
+					continue;
+				}
+				os << profiler.getPerPattern(p, e);
+				if (profiler.getWeightsCount() > 0 && e != PERF_CYCLES && e != PERF_INSTRUCTIONS)
+					os << " " << getPerfEventName(e) << "/weight=" << profiler.getPerWeight(p, e);
+			}
+			os << "\n";
+		}
+		return os;
+	}
+
+
+	/**
+	This monitor prints the counters of the given hardware counters profiler.
+	*/
+	class PerfMonitor :
+		public Monitor
+	{
+	public:
+		PerfMonitor(std::ostream& os, const PerfProfiler& profiler, unsigned timer = DEF_TIMER) :
+		Monitor(timer), m_ostream(os), m_profiler(profiler)
+		{ }
+
+		virtual void execute()
+		{
+			m_ostream << m_profiler;
+		}
+
+	protected:
+		std::ostream& m_ostream;
+		const PerfProfiler& m_profiler;
+
+	private:
+		PerfMonitor& operator=(const PerfMonitor&);
+	};
+
+}
+
+#endif
@@ -0,0 +1,234 @@
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include <vector>
+#include <ostream>
+#include "common/cycleCounter.h"
+#include "backPropagation/monitor.h"
+
+namespace NNLib
+{
+
+	/** Phases of one step of the back-propagation algorithm. */
+	enum TrainingPhase
+	{
+		PHASE_EVAL,
+		PHASE_GRADIENT,
+		PHASE_UPDATE,
+		PHASE_CONTINUATOR,
+		PHASE_MONITOR,
+		PHASES_COUNT
+	};
+
+	/** Get name of the given phase. */
+	inline const char* getPhaseName(TrainingPhase phase)
+	{
+		static const char* NAMES[PHASES_COUNT] =
+			{ "eval", "evalGradient", "updateWeights", "continuator", "monitor" };
+		return NAMES[phase];
+	}
+
+
+	/**
+	Profiler that measures nothing. All its methods are empty so a training
+	profiled by it is as fast as a training without any profiler.
+	*/
+	class EmptyProfiler
+	{
+	public:
+		inline void begin(TrainingPhase) { }
+		inline void end(TrainingPhase) { }
+		inline void beginLayer(TrainingPhase, size_t) { }
+		inline void endLayer(TrainingPhase, size_t) { }
+	};
+
+
+	/**
+	Profiler which counts cycles spent in the single phases of the training
+	and in the single layers of the network for the eval and gradient phases.
+	Every thread should use its own profiler so the counters are plain integers
+	without any synchronization. Profilers of more threads can be merged.
+	*/
+	class PhaseProfiler
+	{
+	public:
+		PhaseProfiler(size_t layersCount = 0)
+		{
+			reset(layersCount);
+		}
+
+		inline void begin(TrainingPhase phase)
+		{
+			m_start[phase] = readCycleCounter();
+		}
+
+		inline void end(TrainingPhase phase)
+		{
+			m_cycles[phase] += readCycleCounter() - m_start[phase];
+			++m_counts[phase];
+		}
+
+		inline void beginLayer(TrainingPhase, size_t)
+		{
+			m_layerStart = readCycleCounter();
+		}
+
+		inline void endLayer(TrainingPhase phase, size_t layer)
+		{
+			if ( layer < m_layersCycles[phase].size() )
+				m_layersCycles[phase][layer] += readCycleCounter() - m_layerStart;
+		}
+
+		/** Add counters of another profiler (e.g. of another thread). */
+		void merge(const PhaseProfiler& other)
+		{
+			for (size_t phase = 0; phase < PHASES_COUNT; ++phase)
+			{
+				m_cycles[phase] += other.m_cycles[phase];
+				m_counts[phase] += other.m_counts[phase];
+				for (size_t layer = 0; layer < getLayersCount() && layer < other.getLayersCount(); ++layer)
+					m_layersCycles[phase][layer] += other.m_layersCycles[phase][layer];
+			}
+		}
+
+		void reset(size_t layersCount)
+		{
+			for (size_t phase = 0; phase < PHASES_COUNT; ++phase)
+			{
+				m_start[phase] = m_cycles[phase] = 0;
+				m_counts[phase] = 0;
+				m_layersCycles[phase].assign(layersCount, 0);
+			}
+			m_layerStart = 0;
+		}
+
+		inline void reset() { reset( getLayersCount() ); }
+
+		inline size_t getLayersCount() const { return m_layersCycles[0].size(); }
+
+		inline CycleType getCycles(TrainingPhase phase) const { return m_cycles[phase]; }
+		inline size_t getCount(TrainingPhase phase) const { return m_counts[phase]; }
+		inline CycleType getLayerCycles(TrainingPhase phase, size_t layer) const { return m_layersCycles[phase][layer]; }
+
+		inline double getSeconds(TrainingPhase phase) const
+		{
+			return m_cycles[phase] / getCyclesPerSecond();
+		}
+
+		CycleType getTotalCycles() const
+		{
+			CycleType total = 0;
+			for (size_t phase = 0; phase < PHASES_COUNT; ++phase)
+				total += m_cycles[phase];
+			return total;
+		}
+
+		/** Print the counters as a JSON object. */
+		void printJSON(std::ostream& os) const
+		{
+			os << "{\"cyclesPerSecond\":" << getCyclesPerSecond() << ",\"phases\":[";
+			for (size_t phase = 0; phase < PHASES_COUNT; ++phase)
+			{
+				const TrainingPhase p = static_cast<TrainingPhase>(phase);
+				os << ( (phase > 0) ? "," : "" ) << "{\"name\":\"" << getPhaseName(p) <<
+					"\",\"count\":" << getCount(p) << ",\"cycles\":" << getCycles(p) <<
+					",\"seconds\":" << getSeconds(p) << ",\"layers\":[";
+				for (size_t layer = 0; layer < getLayersCount(); ++layer)
+					os << ( (layer > 0) ? "," : "" ) << getLayerCycles(p, layer);
+				os << "]}";
+			}
+			os << "]}";
+		}
+
+		/** Print the counters as CSV lines phase,layer,count,cycles,seconds
+		(the layer is empty for the whole phase). */
+		void printCSV(std::ostream& os, bool header = true) const
+		{
+			const double frequency = getCyclesPerSecond();
+			if (header)
+				os << "phase,layer,count,cycles,seconds\n";
+			for (size_t phase = 0; phase < PHASES_COUNT; ++phase)
+			{
+				const TrainingPhase p = static_cast<TrainingPhase>(phase);
+				os << getPhaseName(p) << ",," << getCount(p) << "," << getCycles(p) <<
+					"," << getSeconds(p) << "\n";
+				for (size_t layer = 0; layer < getLayersCount(); ++layer)
+					if (getLayerCycles(p, layer) > 0)
+						os << getPhaseName(p) << "," << layer << "," << getCount(p) << "," <<
+							getLayerCycles(p, layer) << "," << (getLayerCycles(p, layer) / frequency) << "\n";
+			}
+		}
+
+	protected:
+		CycleType m_start[PHASES_COUNT];
+		CycleType m_cycles[PHASES_COUNT];
+		size_t m_counts[PHASES_COUNT];
+
+		/** Cycles spent in the single layers. */
+		std::vector<CycleType> m_layersCycles[PHASES_COUNT];
+		CycleType m_layerStart;
+	};
+
+
+	/** Print share of the single phases and layers on the total time. */
+	inline std::ostream& operator<<(std::ostream& os, const PhaseProfiler& profiler)
+	{
+		const double total = static_cast<double>( profiler.getTotalCycles() );
+		for (size_t phase = 0; phase < PHASES_COUNT; ++phase)
+		{
+			const TrainingPhase p = static_cast<TrainingPhase>(phase);
+			os << getPhaseName(p) << ": " << profiler.getSeconds(p) << " s (" <<
+				( (total > 0) ? 100 * profiler.getCycles(p) / total : 0 ) << " %)";
+			for (size_t layer = 0; layer < profiler.getLayersCount(); ++layer)
+				if (profiler.getLayerCycles(p, layer) > 0)
+					os << " L" << (layer + 1) << "=" <<
+						100 * profiler.getLayerCycles(p, layer) / total << "%";
+			os << "\n";
+		}
+		return os;
+	}
+
+
+	/**
+	This monitor prints the counters of the given profiler as a text, JSON
+	or CSV (without the header).
+	*/
+	class ProfilerMonitor :
+		public Monitor
+	{
+	public:
+		enum Format { FORMAT_TEXT, FORMAT_JSON, FORMAT_CSV };
+
+		ProfilerMonitor(std::ostream& os, const PhaseProfiler& profiler,
+			unsigned timer = DEF_TIMER, Format format = FORMAT_TEXT) :
+		Monitor(timer), m_ostream(os), m_profiler(profiler), m_format(format)
+		{ }
+
+		virtual void execute()
+		{
+			switch (m_format)
+			{
+			case FORMAT_JSON:
+				m_profiler.printJSON(m_ostream);
+				m_ostream << "\n";
+				break;
+			case FORMAT_CSV:
+				m_profiler.printCSV(m_ostream, false);
+				break;
+			default:
+				m_ostream << m_profiler;
+			}
+		}
+
+	protected:
+		std::ostream& m_ostream;
+		const PhaseProfiler& m_profiler;
+		const Format m_format;
+
+	private:
+		ProfilerMonitor& operator=(const ProfilerMonitor&);
+	};
+
+}
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef _THROUGHPUT_MONITOR_H_
+#define _THROUGHPUT_MONITOR_H_
+
+#include <ostream>
+#include <chrono>
+#include "backPropagation/monitor.h"
+
+namespace NNLib
+{
+
+	/**
+	This monitor measures the training speed. The count of processed patterns
+	is taken from the accessor's progress (e.g. IterCycleAccessor), time from
+	a monotonic clock. Patterns per second are exponentially smoothed over the
+	single calls, weights updated per second and achieved GFLOP/s are derived
+	from the count of the network's weights. If the accessor has a finite total
+	length the remaining time is estimated as well.
+	*/
+	template <typename NetworkT, typename AccessorT>
+	class ThroughputMonitor :
+		public Monitor
+	{
+	public:
+		typedef NetworkT NetworkType;
+		typedef AccessorT AccessorType;
+		typedef std::chrono::steady_clock Clock;
+
+		/** Floating point operations per weight and pattern - multiply and add
+		in eval, in back-propagation of deltas with the gradient and in update. */
+		static const unsigned DEF_FLOPS_PER_WEIGHT = 6;
+
+		static const double DEF_SMOOTHING;
+
+		/** The smoothing is the weight of the newest rate (0..1]. */
+		ThroughputMonitor(std::ostream& os, const NetworkType& network, const AccessorType& accessor,
+			unsigned timer = DEF_TIMER, double smoothing = DEF_SMOOTHING,
+			unsigned flopsPerWeight = DEF_FLOPS_PER_WEIGHT) :
+		Monitor(timer), m_ostream(os), m_network(network), m_accessor(accessor),
+		m_smoothing(smoothing), m_flopsPerWeight(flopsPerWeight)
+		{
+			reset();
+		}
+
+		/** Start measuring from now. */
+		void reset()
+		{
+			m_lastTime = Clock::now();
+			m_lastProgress = m_accessor.getProgress();
+			m_rate = 0;
+			m_initialized = false;
+		}
+
+		virtual void execute()
+		{
+			update();
+			m_ostream << *this << "\n";
+		}
+
+		/** Measure the rate since the last call. */
+		void update()
+		{
+			const Clock::time_point now = Clock::now();
+			const size_t progress = m_accessor.getProgress();
+			const double seconds = std::chrono::duration<double>(now - m_lastTime).count();
+
+			// the accessor could be restarted meanwhile
+			const size_t patterns = (progress >= m_lastProgress) ? progress - m_lastProgress : progress;
+			if (seconds <= 0 || patterns == 0)
+				return;
+
+			const double rate = patterns / seconds;
+			m_rate = m_initialized ? m_smoothing * rate + (1 - m_smoothing) * m_rate : rate;
+			m_initialized = true;
+			m_lastTime = now;
+			m_lastProgress = progress;
+		}
+
+		/** Get smoothed count of patterns per second. */
+		inline double getPatternsPerSecond() const { return m_rate; }
+
+		inline double getWeightsPerSecond() const
+		{
+			return m_rate * m_network.getWeightsCount();
+		}
+
+		inline double getGFlops() const
+		{
+			return 1e-9 * m_flopsPerWeight * getWeightsPerSecond();
+		}
+
+		/** Get estimated remaining seconds (negative if unknown). */
+		double getRemainingSeconds() const
+		{
+			const size_t total = m_accessor.getTotalLen();
+			if (total == 0 || m_rate <= 0)
+				return -1;
+			const size_t progress = m_accessor.getProgress();
+			return (progress < total) ? (total - progress) / m_rate : 0;
+		}
+
+	protected:
+		std::ostream& m_ostream;
+		const NetworkType& m_network;
+		const AccessorType& m_accessor;
+		const double m_smoothing;
+		const unsigned m_flopsPerWeight;
+
+		Clock::time_point m_lastTime;
+		size_t m_lastProgress;
+		double m_rate;
+		bool m_initialized;
+
+	private:
+		ThroughputMonitor& operator=(const ThroughputMonitor&);
+	};
+
+	template <typename NetworkT, typename AccessorT>
+	const double ThroughputMonitor<NetworkT,AccessorT>::DEF_SMOOTHING = 0.3;
+
+
+	/** Print the current throughput and the remaining time. */
+	template <typename NetworkT, typename AccessorT>
+	std::ostream& operator<<(std::ostream& os, const ThroughputMonitor<NetworkT,AccessorT>& monitor)
+	{
+		os << "patterns/s=" << monitor.getPatternsPerSecond() <<
+			" weights/s=" << monitor.getWeightsPerSecond() <<
+			" GFLOP/s=" << monitor.getGFlops() << " eta=";
+		const double remaining = monitor.getRemainingSeconds();
+		(remaining < 0) ? (os << "inf") : (os << remaining << "s");
+		return os;
+	}
+
+}
+
+#endif
@@ -1,747 +1,1028 @@
-#ifndef _WEIGHTS_UPDATER_H_
-#define _WEIGHTS_UPDATER_H_
-
-#include "backPropagation/learningRate.h"
-#include "backPropagation/learningMomentum.h"
-#include "common/mathematics.h"
-#include "initializers/constantInitializer.h"
-
-namespace NNLib
-{
-
-// BASE CLASS /////////////////////////////////////////////////////////////////
-
-	/**
-	Base class for every updater of a neural network's weights.
-	*/
-	template <typename NetworkT>
-	class WeightsUpdaterBase
-	{
-	public:
-		typedef NetworkT NetworkType;
-		typedef typename NetworkType::WeightType WeightType;
-
-		WeightsUpdaterBase(NetworkType& network) :
-		m_network(network)
-		{ }
-
-	protected:
-		/** Network which weights should be updated. */
-		NetworkType& m_network;
-
-	private:
-		WeightsUpdaterBase& operator=(const WeightsUpdaterBase&);
-	};
-
-
-// STANDARD BACK-PROPAGATION ALGORITHM ////////////////////////////////////////
-
-	/**
-	Standard version of weights updater with a global learning rate and momentum.
-	*/
-	template <typename NetworkT>
-	class StandardUpdater :
-		public WeightsUpdaterBase<NetworkT>,
-		public GlobalLearningRate<typename NetworkT::WeightType>,
-		public GlobalLearningMomentum<typename NetworkT::WeightType>
-	{
-	private:
-		typedef WeightsUpdaterBase<NetworkT> _UpdaterBase;
-		typedef GlobalLearningRate<typename NetworkT::WeightType> _LearningRateBase;
-		typedef GlobalLearningMomentum<typename NetworkT::WeightType> _LearningMomentumBase;
-
-	public:
-		typedef typename _UpdaterBase::NetworkType NetworkType;
-		typedef typename _UpdaterBase::WeightType WeightType;
-		typedef typename _LearningRateBase::RateType RateType;
-		typedef typename _LearningMomentumBase::MomentumType MomentumType;
-		
-		StandardUpdater(NetworkType& network) :
-		_UpdaterBase(network)
-		{
-			m_weightsCache = new WeightType[network.getWeightsCount()];
-			reset();
-		}
-
-		~StandardUpdater()
-		{
-			delete [] m_weightsCache;
-		}
-
-		void updateWeights(WeightType ***gradient)
-		{
-			m_gradient = **gradient;
-			m_index = 0;
-			this->m_network.forEachWeightForward( *this );
-		}
-		
-		/** Update one given weight. */
-		void operator()(WeightType& weight)
-		{
-			// cache the old weight
-			WeightType oldWeight = m_weightsCache[m_index];
-			m_weightsCache[m_index] = weight;
-
-			// update the weight
-			weight += this->getLearningMomentum() * ( m_weightsCache[m_index] - oldWeight ) -
-				this->getLearningRate() * m_gradient[m_index];
-
-			// move to the next weight
-			++m_index;
-		}
-
-		void reset()
-		{
-			ConstantInitializer<WeightType>(0)
-				( m_weightsCache, this->m_network.getWeightsCount() );
-		}
-
-	protected:
-		WeightType *m_weightsCache;
-		WeightType *m_gradient;
-		size_t m_index;
-	};
-
-
-// SILVA AND ALMEIDA'S ALGORITHM //////////////////////////////////////////////
-
-	/**
-	Updater used by Silva and Almeida's algorithm.
-	*/
-	template <typename NetworkT>
-	class SilvaAlmeidaUpdater :
-		public WeightsUpdaterBase<NetworkT>,
-		public LocalLearningRate<typename NetworkT::WeightType>,
-		public AdaptiveRate<typename NetworkT::WeightType>
-	{
-	private:
-		typedef WeightsUpdaterBase<NetworkT> _UpdaterBase;
-		typedef LocalLearningRate<typename NetworkT::WeightType> _LearningRateBase;
-		typedef AdaptiveRate<typename NetworkT::WeightType> _AdaptiveRateBase;
-
-	public:
-		typedef typename _UpdaterBase::NetworkType NetworkType;
-		typedef typename _UpdaterBase::WeightType WeightType;
-		typedef typename _LearningRateBase::RateType RateType;
-
-		SilvaAlmeidaUpdater(NetworkType& network, RateType up = DEF_UP_RATE, RateType down = DEF_DOWN_RATE) :
-		_UpdaterBase(network), _LearningRateBase(network), _AdaptiveRateBase(up, down)
-		{
-			m_gradientCache = new WeightType[network.getWeightsCount()];
-			reset();
-		}
-
-		~SilvaAlmeidaUpdater()
-		{
-			delete [] m_gradientCache;
-		}
-
-		void updateWeights(WeightType ***gradient)
-		{
-			m_gradient = **gradient;
-			m_index = 0;
-			this->m_network.forEachWeightForward( *this );
-		}
-		
-		/** Update one given weight. */
-		void operator()(WeightType& weight)
-		{
-			static const WeightType ZERO_WEIGHT = static_cast<WeightType>(0);
-
-			// update the weight
-			weight -= this->getLearningRate(m_index) * m_gradient[m_index];
-
-			// update the learning rate
-			WeightType signum = m_gradientCache[m_index] * m_gradient[m_index];
-			if (signum > ZERO_WEIGHT)
-				this->setLearningRate( m_index, this->getLearningRate(m_index) * this->getUpRate() );
-			else if (signum < ZERO_WEIGHT)
-				this->setLearningRate( m_index, this->getLearningRate(m_index) * this->getDownRate() );
-
-			// cache the gradient
-			m_gradientCache[m_index] = m_gradient[m_index];
-
-			// move to the next weight
-			++m_index;
-		}
-
-		void reset()
-		{
-			ConstantInitializer<WeightType>(0)
-				( m_gradientCache, this->m_network.getWeightsCount() );
-		}
-
-	protected:
-		WeightType *m_gradientCache;
-		WeightType *m_gradient;
-		size_t m_index;
-
-		static const RateType DEF_UP_RATE;
-		static const RateType DEF_DOWN_RATE;
-	};
-
-	template <typename NetworkT>
-	const typename SilvaAlmeidaUpdater<NetworkT>::RateType SilvaAlmeidaUpdater<NetworkT>::DEF_UP_RATE
-		= static_cast<typename SilvaAlmeidaUpdater<NetworkT>::RateType>( 1.2f );
-	
-	template <typename NetworkT>
-	const typename SilvaAlmeidaUpdater<NetworkT>::RateType SilvaAlmeidaUpdater<NetworkT>::DEF_DOWN_RATE
-		= static_cast<typename SilvaAlmeidaUpdater<NetworkT>::RateType>( 0.8f );
-
-
-// DELTA-BAR-DELTA ALGORITHM //////////////////////////////////////////////////
-
-	/**
-	Updater used by Delta-bar-delta algorithm.
-	*/
-	template <typename NetworkT>
-	class DeltaBarDeltaUpdater :
-		public WeightsUpdaterBase<NetworkT>,
-		public LocalLearningRate<typename NetworkT::WeightType>,
-		public AdaptiveRate<typename NetworkT::WeightType>
-	{
-	private:
-		typedef WeightsUpdaterBase<NetworkT> _UpdaterBase;
-		typedef LocalLearningRate<typename NetworkT::WeightType> _LearningRateBase;
-		typedef AdaptiveRate<typename NetworkT::WeightType> _AdaptiveRateBase;
-
-	public:
-		typedef typename _UpdaterBase::NetworkType NetworkType;
-		typedef typename _UpdaterBase::WeightType WeightType;
-		typedef typename _LearningRateBase::RateType RateType;
-
-		DeltaBarDeltaUpdater(NetworkType& network, RateType up = DEF_UP_RATE, RateType down = DEF_DOWN_RATE,
-		RateType inertia = DEF_INERTIA) :
-		_UpdaterBase(network), _LearningRateBase(network), _AdaptiveRateBase(up, down)
-		{
-			m_deltasCache = new WeightType[network.getWeightsCount()];
-			setInertia(inertia);
-			reset();
-		}
-
-		~DeltaBarDeltaUpdater()
-		{
-			delete [] m_deltasCache;
-		}
-
-		void updateWeights(WeightType ***gradient)
-		{
-			m_gradient = **gradient;
-			m_index = 0;
-			this->m_network.forEachWeightForward( *this );
-		}
-		
-		/** Update one given weight. */
-		void operator()(WeightType& weight)
-		{
-			static const WeightType ZERO_WEIGHT = static_cast<WeightType>(0);
-
-			// update the weight
-			weight -= this->getLearningRate(m_index) * m_gradient[m_index];
-
-			// update the learning rate
-			WeightType signum = m_gradient[m_index] * m_deltasCache[m_index];
-			if (signum > ZERO_WEIGHT)
-				this->setLearningRate( m_index, this->getLearningRate(m_index) + this->getUpRate() );
-			else if (signum < ZERO_WEIGHT)
-				this->setLearningRate( m_index, this->getLearningRate(m_index) * this->getDownRate() );
-
-			// update the delta param
-			m_deltasCache[m_index] = getInertiaInv() * m_gradient[m_index] +
-				getInertia() * m_deltasCache[m_index];
-
-			// move to the next weight
-			++m_index;
-		}
-
-		void reset()
-		{
-			ConstantInitializer<WeightType>(0)
-				( m_deltasCache, this->m_network.getWeightsCount() );
-		}
-
-		inline RateType getInertia() const { return m_inertia; }
-		inline RateType getInertiaInv() const { return m_inertiaInv; }
-		
-		inline void setInertia(RateType inertia)
-		{
-			m_inertia = inertia;
-			m_inertiaInv = static_cast<RateType>(1) - inertia;
-		}
-
-	protected:
-		WeightType *m_deltasCache;
-		WeightType *m_gradient;
-		size_t m_index;
-		WeightType m_inertia, m_inertiaInv;
-
-		static const RateType DEF_UP_RATE;
-		static const RateType DEF_DOWN_RATE;
-		static const WeightType DEF_INERTIA;
-	};
-
-	template <typename NetworkT>
-	const typename DeltaBarDeltaUpdater<NetworkT>::RateType DeltaBarDeltaUpdater<NetworkT>::DEF_UP_RATE
-		= static_cast<typename DeltaBarDeltaUpdater<NetworkT>::RateType>( 0.09f );
-	
-	template <typename NetworkT>
-	const typename DeltaBarDeltaUpdater<NetworkT>::RateType DeltaBarDeltaUpdater<NetworkT>::DEF_DOWN_RATE
-		= static_cast<typename DeltaBarDeltaUpdater<NetworkT>::RateType>( 0.8f );
-
-	template <typename NetworkT>
-	const typename DeltaBarDeltaUpdater<NetworkT>::WeightType DeltaBarDeltaUpdater<NetworkT>::DEF_INERTIA
-		= static_cast<typename DeltaBarDeltaUpdater<NetworkT>::WeightType>( 0.5f );
-
-
-// SUPER SAB ALGORITHM ////////////////////////////////////////////////////////
-
-	/**
-	Updater used by Super SAB (Self-Adapting Back-propagation) algorithm.
-	*/
-	template <typename NetworkT>
-	class SuperSABUpdater :
-		public WeightsUpdaterBase<NetworkT>,
-		public LocalLearningRate<typename NetworkT::WeightType>,
-		public AdaptiveRate<typename NetworkT::WeightType>,
-		public GlobalLearningMomentum<typename NetworkT::WeightType>
-	{
-	private:
-		typedef WeightsUpdaterBase<NetworkT> _UpdaterBase;
-		typedef LocalLearningRate<typename NetworkT::WeightType> _LearningRateBase;
-		typedef AdaptiveRate<typename NetworkT::WeightType> _AdaptiveRateBase;
-		typedef GlobalLearningMomentum<typename NetworkT::WeightType> _LearningMomentumBase;
-
-	public:
-		typedef typename _UpdaterBase::NetworkType NetworkType;
-		typedef typename _UpdaterBase::WeightType WeightType;
-		typedef typename _LearningRateBase::RateType RateType;
-		typedef typename _LearningMomentumBase::MomentumType MomentumType;
-
-		SuperSABUpdater(NetworkType& network, RateType up = DEF_UP_RATE, RateType down = DEF_DOWN_RATE) :
-		_UpdaterBase(network), _LearningRateBase(network), _AdaptiveRateBase(up, down)
-		{
-			size_t weightsCount = network.getWeightsCount();
-			m_gradientCache = new WeightType[weightsCount];
-			m_weightsCache  = new WeightType[weightsCount];
-			m_stepsCache  = new WeightType[weightsCount];
-			reset();
-		}
-
-		~SuperSABUpdater()
-		{
-			delete [] m_gradientCache;
-			delete [] m_weightsCache;
-			delete [] m_stepsCache;
-		}
-
-		void updateWeights(WeightType ***gradient)
-		{
-			m_gradient = **gradient;
-			m_index = 0;
-			this->m_network.forEachWeightForward( *this );
-		}
-		
-		/** Update one given weight. */
-		void operator()(WeightType& weight)
-		{
-			static const WeightType ZERO_WEIGHT = static_cast<WeightType>(0);
-
-			// change of derivation
-			WeightType signum = m_gradientCache[m_index] * m_gradient[m_index];
-			
-			if (signum >= ZERO_WEIGHT)
-			{
-				// compute current step and cache it
-				m_stepsCache[m_index] = this->getLearningMomentum() * ( weight - m_weightsCache[m_index] ) -
-					this->getLearningRate(m_index) * m_gradient[m_index];
-
-				// cache the old weight and the old gradient
-				m_weightsCache[m_index] = weight;
-				m_gradientCache[m_index] = m_gradient[m_index];
-
-				// update the weight
-				weight += m_stepsCache[m_index];
-
-				// update the learning rate if needed
-				RateType learningRate = this->getLearningRate(m_index);
-				if ( learningRate < getMaxLearningRate() )
-					this->setLearningRate( m_index, learningRate * this->getUpRate() );
-			}
-			else
-			{
-				// reset the last weight update
-				weight -= m_stepsCache[m_index];
-
-				// annulate the step cache and the update cache
-				m_stepsCache[m_index] = m_gradientCache[m_index] = ZERO_WEIGHT;
-
-				// update the learning rate
-				this->setLearningRate( m_index, this->getLearningRate(m_index) * this->getDownRate() );
-			}
-
-			// move to the next weight
-			++m_index;
-		}
-
-		void reset()
-		{
-			ConstantInitializer<WeightType> init(0);
-			size_t weightsCount = this->m_network.getWeightsCount();
-			init(m_gradientCache, weightsCount);
-			init(m_weightsCache, weightsCount);
-			init(m_stepsCache, weightsCount);
-		}
-
-		inline WeightType getMaxLearningRate() const { return m_maxLearningRate; }
-		inline void setMaxLearningRate(WeightType rate) { m_maxLearningRate = rate; }
-
-	protected:
-		WeightType *m_gradientCache;
-		WeightType *m_weightsCache;
-		WeightType *m_stepsCache;
-		WeightType *m_gradient;
-		WeightType m_maxLearningRate;
-		size_t m_index;
-
-		static const RateType DEF_UP_RATE, DEF_DOWN_RATE;
-		static const RateType DEF_MAX_RATE;
-	};
-
-	template <typename NetworkT>
-	const typename SuperSABUpdater<NetworkT>::RateType SuperSABUpdater<NetworkT>::DEF_UP_RATE
-		= static_cast<typename SuperSABUpdater<NetworkT>::RateType>( 1.05f );
-	
-	template <typename NetworkT>
-	const typename SuperSABUpdater<NetworkT>::RateType SuperSABUpdater<NetworkT>::DEF_DOWN_RATE
-		= static_cast<typename SuperSABUpdater<NetworkT>::RateType>( 0.5f );
-		
-	template <typename NetworkT>
-	const typename SuperSABUpdater<NetworkT>::RateType SuperSABUpdater<NetworkT>::DEF_MAX_RATE
-		= static_cast<typename SuperSABUpdater<NetworkT>::RateType>( 0.8f );
-
-
-// QUICKPROP ALGORITHM ////////////////////////////////////////////////////////
-
-	/**
-	Updater used by the Quickprop (Quick-propagation) algorithm.
-	*/
-	template <typename NetworkT>
-	class QuickpropUpdater :
-		public WeightsUpdaterBase<NetworkT>
-	{
-	private:
-		typedef WeightsUpdaterBase<NetworkT> _UpdaterBase;
-
-	public:
-		typedef typename _UpdaterBase::NetworkType NetworkType;
-		typedef typename _UpdaterBase::WeightType WeightType;
-		
-		QuickpropUpdater(NetworkType& network) :
-		_UpdaterBase(network)
-		{
-			size_t weightsCount = network.getWeightsCount();
-			m_gradientCache = new WeightType[weightsCount];
-			m_stepsCache = new WeightType[weightsCount];
-			reset();
-		}
-
-		~QuickpropUpdater()
-		{
-			delete [] m_gradientCache;
-			delete [] m_stepsCache;
-		}
-
-		void updateWeights(WeightType ***gradient)
-		{
-			m_gradient = **gradient;
-			m_index = 0;
-			this->m_network.forEachWeightForward( *this );
-		}
-		
-		/** Update one given weight. */
-		void operator()(WeightType& weight)
-		{
-			// difference between current and previous gradient
-			const WeightType gradientDiff = m_gradientCache[m_index] - m_gradient[m_index];
-			
-			if ( !isZero(gradientDiff) )
-			{
-				// compute step of the weight and cache it
-				m_stepsCache[m_index] = m_stepsCache[m_index] * m_gradient[m_index] / gradientDiff;
-
-				// cache current gradient
-				m_gradientCache[m_index] = m_gradient[m_index];
-
-				// update the weight
-				weight += m_stepsCache[m_index];
-			}
-
-			// move to the next weight
-			++m_index;
-		}
-
-		void reset()
-		{
-			size_t weightsCount = this->m_network.getWeightsCount();
-			ConstantInitializer<WeightType>(0)(m_gradientCache, weightsCount);
-			ConstantInitializer<WeightType>(-2)(m_stepsCache, weightsCount);
-		}
-
-	protected:
-		WeightType *m_gradientCache;
-		WeightType *m_stepsCache;
-		WeightType *m_gradient;
-		size_t m_index;
-
-		/** Informs whether the given value is approximately equal to zero. */
-		inline bool isZero(const WeightType& weight)
-		{
-			static const WeightType POS = static_cast<WeightType>( 0.000001f );
-			static const WeightType NEG = -POS;
-			return (weight > NEG) && (weight < POS);
-		}
-	};
-
-
-// RPROP ALGORITHM //////////////////////////////////////////////
-
-	/**
-	Updater used by Rprop algorithm.
-	*/
-	template <typename NetworkT>
-	class RpropUpdater :
-		public WeightsUpdaterBase<NetworkT>,
-		public LocalLearningRate<typename NetworkT::WeightType>,
-		public AdaptiveRate<typename NetworkT::WeightType>
-	{
-	private:
-		typedef WeightsUpdaterBase<NetworkT> _UpdaterBase;
-		typedef LocalLearningRate<typename NetworkT::WeightType> _LearningRateBase;
-		typedef AdaptiveRate<typename NetworkT::WeightType> _AdaptiveRateBase;
-
-	public:
-		typedef typename _UpdaterBase::NetworkType NetworkType;
-		typedef typename _UpdaterBase::WeightType WeightType;
-		typedef typename _LearningRateBase::RateType RateType;
-
-		RpropUpdater(NetworkType& network, RateType up = DEF_UP_RATE, RateType down = DEF_DOWN_RATE) :
-		_UpdaterBase(network), _LearningRateBase(network), _AdaptiveRateBase(up, down)
-		{
-			m_gradientCache = new WeightType[network.getWeightsCount()];
-			reset();
-		}
-
-		~RpropUpdater()
-		{
-			delete [] m_gradientCache;
-		}
-
-		void updateWeights(WeightType ***gradient)
-		{
-			m_gradient = **gradient;
-			m_index = 0;
-			this->m_network.forEachWeightForward( *this );
-		}
-		
-		/** Update one given weight. */
-		void operator()(WeightType& weight)
-		{
-			static const WeightType ZERO_WEIGHT = static_cast<WeightType>(0);
-
-			RateType learningRate = this->getLearningRate(m_index);
-			WeightType signum = m_gradientCache[m_index] * m_gradient[m_index];
-			
-			if (signum >= ZERO_WEIGHT)
-			{
-				// update the weight
-				weight -= learningRate * sgn( m_gradient[m_index] );
-				
-				// increase the learning rate if the maximal value hasn't been already reached
-				if (learningRate < m_maxRate)
-					this->setLearningRate( m_index, learningRate * this->getUpRate() );
-
-				// cache the gradient
-				m_gradientCache[m_index] = m_gradient[m_index];
-			}
-			else if (signum < ZERO_WEIGHT)
-			{
-				// decrease the learning rate if the minimal value hasn't been already reached
-				if (learningRate > m_minRate)
-					this->setLearningRate( m_index, learningRate * this->getDownRate() );
-
-				// don't cache the gradient
-				m_gradientCache[m_index] = m_gradient[m_index];
-			}
-
-			// move to the next weight
-			++m_index;
-		}
-
-		void reset()
-		{
-			ConstantInitializer<WeightType>(0)
-				( m_gradientCache, this->m_network.getWeightsCount() );
-		}
-
-	protected:
-		WeightType *m_gradientCache;
-		WeightType *m_gradient;
-		RateType m_maxRate, m_minRate;
-		size_t m_index;
-
-		static const RateType DEF_UP_RATE, DEF_DOWN_RATE;
-		static const RateType DEF_MAX_RATE, DEF_MIN_RATE;
-	};
-
-	template <typename NetworkT>
-	const typename RpropUpdater<NetworkT>::RateType RpropUpdater<NetworkT>::DEF_UP_RATE
-		= static_cast<typename RpropUpdater<NetworkT>::RateType>( 1.2f );
-	
-	template <typename NetworkT>
-	const typename RpropUpdater<NetworkT>::RateType RpropUpdater<NetworkT>::DEF_DOWN_RATE
-		= static_cast<typename RpropUpdater<NetworkT>::RateType>( 0.8f );
-	
-	template <typename NetworkT>
-	const typename RpropUpdater<NetworkT>::RateType RpropUpdater<NetworkT>::DEF_MAX_RATE
-		= static_cast<typename RpropUpdater<NetworkT>::RateType>( 1.8f );
-		
-	template <typename NetworkT>
-	const typename RpropUpdater<NetworkT>::RateType RpropUpdater<NetworkT>::DEF_MIN_RATE
-		= static_cast<typename RpropUpdater<NetworkT>::RateType>( 0.2f );
-
-
-// QRPROP ALGORITHM //////////////////////////////////////////////
-
-	/**
-	Updater used by QRprop algorithm.
-	*/
-	template <typename NetworkT>
-	class QRpropUpdater :
-		public WeightsUpdaterBase<NetworkT>,
-		public LocalLearningRate<typename NetworkT::WeightType>,
-		public AdaptiveRate<typename NetworkT::WeightType>,
-		public MinMaxRate<typename NetworkT::WeightType>
-	{
-	private:
-		typedef WeightsUpdaterBase<NetworkT> _UpdaterBase;
-		typedef LocalLearningRate<typename NetworkT::WeightType> _LearningRateBase;
-		typedef AdaptiveRate<typename NetworkT::WeightType> _AdaptiveRateBase;
-		typedef MinMaxRate<typename NetworkT::WeightType> _MinMaxRateBase;
-
-	public:
-		typedef typename _UpdaterBase::NetworkType NetworkType;
-		typedef typename _UpdaterBase::WeightType WeightType;
-		typedef typename _LearningRateBase::RateType RateType;
-
-		QRpropUpdater(NetworkType& network, RateType up = DEF_UP_RATE, RateType down = DEF_DOWN_RATE,
-			RateType max = DEF_MAX_RATE, RateType min = DEF_MIN_RATE) :
-		_UpdaterBase(network), _LearningRateBase(network), _AdaptiveRateBase(up, down), _MinMaxRateBase(min, max)
-		{
-			const size_t weightsCount = network.getWeightsCount();
-			m_gradientCache = new WeightType[weightsCount];
-			m_gradientCache2 = new WeightType[weightsCount];
-			m_q = new WeightType[weightsCount];
-			reset();
-		}
-
-		~QRpropUpdater()
-		{
-			delete [] m_gradientCache;
-			delete [] m_gradientCache2;
-			delete [] m_q;
-		}
-
-		void updateWeights(WeightType ***gradient)
-		{
-			m_gradient = **gradient;
-			m_index = 0;
-			this->m_network.forEachWeightForward( *this );
-		}
-		
-		/** Update one given weight. */
-		void operator()(WeightType& weight)
-		{
-			static const WeightType ZERO_WEIGHT = static_cast<WeightType>(0);
-
-			RateType learningRate = this->getLearningRate(m_index);
-			WeightType signum = m_gradientCache[m_index] * m_gradient[m_index];
-			
-			if (signum == ZERO_WEIGHT)
-			{
-				// update q-param
-				RateType downRateInv = static_cast<RateType>(1) / this->getDownRate();
-				if ( m_gradient[m_index] != m_gradientCache2[m_index] ) {
-					WeightType deriv = std::abs( m_gradient[m_index] /
-						(m_gradient[m_index] - m_gradientCache[m_index]) );
-					m_q[m_index] = max( this->getUpRate(), min(downRateInv, deriv) );
-				}
-				else {
-					m_q[m_index] = downRateInv;
-				}
-
-				// update learning rate, weight and cache
-				this->setLearningRate( m_index, max(this->getMinRate(), m_q[m_index] * learningRate) );
-				updateWeightAndCache(weight);
-			}
-			else if (signum > ZERO_WEIGHT)
-			{
-				// update learning rate, weight and cache
-				this->setLearningRate( m_index, min(this->getMaxRate(), this->getUpRate() * learningRate) );
-				updateWeightAndCache(weight);
-			}
-			else
-			{
-				// update neither learning-param nor weight and don't cache the last gradient
-				m_gradientCache2[m_index] = m_gradientCache[m_index];
-				m_gradientCache[m_index] = ZERO_WEIGHT;
-			}
-
-			// move to the next weight
-			++m_index;
-		}
-
-		void reset()
-		{
-			const size_t weightsCount = this->m_network.getWeightsCount();
-			ConstantInitializer<WeightType> init(0);
-			init(m_gradientCache, weightsCount);
-			init(m_gradientCache2, weightsCount);
-			init(m_q, weightsCount);
-		}
-
-	protected:
-		WeightType *m_gradientCache, *m_gradientCache2, *m_q;
-		WeightType *m_gradient;
-		RateType m_maxRate, m_minRate;
-		size_t m_index;
-
-		static const RateType DEF_UP_RATE, DEF_DOWN_RATE;
-		static const RateType DEF_MAX_RATE, DEF_MIN_RATE;
-
-		inline void updateWeightAndCache(WeightType& weight)
-		{
-			weight -= this->getLearningRate(m_index) * sgn( m_gradient[m_index] );
-			m_gradientCache2[m_index] = m_gradientCache[m_index];
-			m_gradientCache[m_index]  = m_gradient[m_index];
-		}
-	};
-
-	template <typename NetworkT>
-	const typename QRpropUpdater<NetworkT>::RateType QRpropUpdater<NetworkT>::DEF_UP_RATE
-		= static_cast<typename QRpropUpdater<NetworkT>::RateType>( 1.2f );
-	
-	template <typename NetworkT>
-	const typename QRpropUpdater<NetworkT>::RateType QRpropUpdater<NetworkT>::DEF_DOWN_RATE
-		= static_cast<typename QRpropUpdater<NetworkT>::RateType>( 0.6f );
-	
-	template <typename NetworkT>
-	const typename QRpropUpdater<NetworkT>::RateType QRpropUpdater<NetworkT>::DEF_MAX_RATE
-		= static_cast<typename QRpropUpdater<NetworkT>::RateType>( 3.0f );
-	
-	template <typename NetworkT>
-	const typename QRpropUpdater<NetworkT>::RateType QRpropUpdater<NetworkT>::DEF_MIN_RATE
-		= static_cast<typename QRpropUpdater<NetworkT>::RateType>( 0.05f );
-
-}
-
+#ifndef _WEIGHTS_UPDATER_H_
+#define _WEIGHTS_UPDATER_H_
+
+#include <cmath>
+#include "common/sparseVector.h"
+#include "feedForward/networkBufferAllocator.h"
+#include "backPropagation/learningRate.h"
+#include "backPropagation/learningMomentum.h"
+#include "common/mathematics.h"
+#include "backPropagation/momentUpdates.h"
+
+namespace NNLib
+{
+
+// BASE CLASS /////////////////////////////////////////////////////////////////
+
+	/**
+	Base class for every updater of a neural network's weights. The updaters
+	get the gradient as a WeightsBuffer and update the network's weights block
+	by block (see FeedForwardNetwork::forEachWeightsBlock()) in straight loops
+	over the gradient and their own caches of the same layout. Blocks of frozen
+	layers are skipped.
+
+	The updater class UpdaterT derived from this one (CRTP) defines just
+	operator()(weights, index, count) updating a block of weights by the
+	gradient set by beginUpdate() (which it can hide to prepare its step).
+	*/
+	template <typename NetworkT, typename UpdaterT>
+	class WeightsUpdaterBase
+	{
+	public:
+		typedef NetworkT NetworkType;
+		typedef typename NetworkType::WeightType WeightType;
+		typedef WeightsBuffer<WeightType> GradientType;
+
+		WeightsUpdaterBase(NetworkType& network) :
+		m_network(network), m_gradient(NULL)
+		{ }
+
+		/** Update weights of the layers which aren't frozen by the given gradient. */
+		void updateWeights(const GradientType& gradient)
+		{
+			getUpdater().beginUpdate(gradient);
+			forEachTrainedWeightsBlock( getUpdater() );
+		}
+
+		/** Update only the weights of the non-zero values of the given sparse
+		input in the first layer (see forEachActiveWeightsBlock()). */
+		void updateWeights(const GradientType& gradient, const SparseVector<WeightType>& input)
+		{
+			getUpdater().beginUpdate(gradient);
+			forEachActiveWeightsBlock( getUpdater(), input );
+		}
+
+		/** Set the gradient for the next updates of blocks by operator(). */
+		inline void beginUpdate(const GradientType& gradient)
+		{
+			m_gradient = gradient.getData();
+		}
+
+	protected:
+		/** Network which weights should be updated. */
+		NetworkType& m_network;
+
+		/** Gradient of the current update. */
+		const WeightType *m_gradient;
+
+		inline UpdaterT& getUpdater() { return static_cast<UpdaterT&>(*this); }
+
+		/** Perform func(weights, index, count) like forEachWeightsBlock() but only
+		on the blocks of the layers which aren't frozen. */
+		template <typename Function>
+		inline void forEachTrainedWeightsBlock(Function& func)
+		{
+			TrainedWeightsBlocks<Function> blocks = { func, 0 };
+			m_network.forEachLayer(blocks);
+		}
+
+		/** Perform func(weights, index, count) like forEachTrainedWeightsBlock() but in
+		the first layer only on the single weights of the non-zero values of the
+		given sparse input. The updates of the first layer then cost in proportion
+		to the count of the non-zero values, caches of the other weights of the
+		layer are left as they are (lazy update). */
+		template <typename Function>
+		inline void forEachActiveWeightsBlock(Function& func, const SparseVector<WeightType>& input)
+		{
+			ActiveWeightsBlocks<Function> blocks = { func, input, 0 };
+			m_network.forEachLayer(blocks);
+		}
+
+		/** Perform func(weights, index, count) only on the given rows of the block
+		of the given layer (if it isn't frozen), e.g. as soon as their gradient is
+		evaluated. */
+		template <typename Function>
+		inline void forLayerWeightsRows(Function& func, size_t layer, size_t firstRow, size_t rowsCount)
+		{
+			LayerWeightsRows<Function> rows = { func, layer, firstRow, rowsCount, 0 };
+			m_network.forEachLayer(rows);
+		}
+
+		template <typename Function>
+		struct TrainedWeightsBlocks
+		{
+			Function& func;
+			size_t index;
+
+			template <typename LayerT>
+			inline void operator()(LayerT& layer, size_t)
+			{
+				if (!layer.isFrozen())
+					func( layer.getWeights(), index, layer.getWeightsBlockSize() );
+				index += layer.getWeightsBlockSize();
+			}
+		};
+
+		template <typename Function>
+		struct LayerWeightsRows
+		{
+			Function& func;
+			size_t layer, firstRow, rowsCount;
+			size_t index;
+
+			template <typename LayerT>
+			inline void operator()(LayerT& l, size_t layerIndex)
+			{
+				if (layerIndex == layer && !l.isFrozen()) {
+					const size_t offset = firstRow * l.getWeightsStride();
+					func( l.getWeights() + offset, index + offset, rowsCount * l.getWeightsStride() );
+				}
+				index += l.getWeightsBlockSize();
+			}
+		};
+
+		template <typename Function>
+		struct ActiveWeightsBlocks
+		{
+			Function& func;
+			const SparseVector<WeightType>& input;
+			size_t index;
+
+			template <typename LayerT>
+			inline void operator()(LayerT& layer, size_t layerIndex)
+			{
+				WeightType *weights = layer.getWeights();
+				if (layerIndex == 0 && !layer.isFrozen()) {
+					const size_t stride = layer.getWeightsStride();
+					for (size_t j = 0, row = 0; j < layer.getNeuronsCount(); ++j, row += stride)
+						for (size_t k = 0; k < input.count; ++k)
+							func( weights + row + input.indices[k], index + row + input.indices[k], 1 );
+				}
+				else if (!layer.isFrozen()) {
+					func( weights, index, layer.getWeightsBlockSize() );
+				}
+				index += layer.getWeightsBlockSize();
+			}
+		};
+
+	private:
+		WeightsUpdaterBase& operator=(const WeightsUpdaterBase&);
+	};
+
+
+// STANDARD BACK-PROPAGATION ALGORITHM ////////////////////////////////////////
+
+	/**
+	Standard version of weights updater with a global learning rate and momentum.
+	*/
+	template <typename NetworkT>
+	class StandardUpdater :
+		public WeightsUpdaterBase< NetworkT, StandardUpdater<NetworkT> >,
+		public GlobalLearningRate<typename NetworkT::WeightType>,
+		public GlobalLearningMomentum<typename NetworkT::WeightType>
+	{
+	private:
+		typedef WeightsUpdaterBase< NetworkT, StandardUpdater<NetworkT> > _UpdaterBase;
+		typedef GlobalLearningRate<typename NetworkT::WeightType> _LearningRateBase;
+		typedef GlobalLearningMomentum<typename NetworkT::WeightType> _LearningMomentumBase;
+
+	public:
+		typedef typename _UpdaterBase::NetworkType NetworkType;
+		typedef typename _UpdaterBase::WeightType WeightType;
+		typedef typename _UpdaterBase::GradientType GradientType;
+		typedef typename _LearningRateBase::RateType RateType;
+		typedef typename _LearningMomentumBase::MomentumType MomentumType;
+		
+		StandardUpdater(NetworkType& network) :
+		_UpdaterBase(network), m_weightsCache(network)
+		{ }
+
+		/** Update the given block of weights starting at the given flat index. */
+		void operator()(WeightType weights[], size_t index, size_t count)
+		{
+			const WeightType *gradient = this->m_gradient + index;
+			WeightType *weightsCache = m_weightsCache.getData() + index;
+			const MomentumType momentum = this->getLearningMomentum();
+			const RateType rate = this->getLearningRate();
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				// cache the old weight
+				const WeightType oldWeight = weightsCache[i];
+				weightsCache[i] = weights[i];
+
+				// update the weight
+				weights[i] += momentum * (weights[i] - oldWeight) - rate * gradient[i];
+			}
+		}
+
+		void reset()
+		{
+			m_weightsCache.fill(0);
+		}
+
+	protected:
+		WeightsBuffer<WeightType> m_weightsCache;
+	};
+
+
+// SILVA AND ALMEIDA'S ALGORITHM //////////////////////////////////////////////
+
+	/**
+	Updater used by Silva and Almeida's algorithm.
+	*/
+	template <typename NetworkT>
+	class SilvaAlmeidaUpdater :
+		public WeightsUpdaterBase< NetworkT, SilvaAlmeidaUpdater<NetworkT> >,
+		public LocalLearningRate<typename NetworkT::WeightType>,
+		public AdaptiveRate<typename NetworkT::WeightType>
+	{
+	private:
+		typedef WeightsUpdaterBase< NetworkT, SilvaAlmeidaUpdater<NetworkT> > _UpdaterBase;
+		typedef LocalLearningRate<typename NetworkT::WeightType> _LearningRateBase;
+		typedef AdaptiveRate<typename NetworkT::WeightType> _AdaptiveRateBase;
+
+	public:
+		typedef typename _UpdaterBase::NetworkType NetworkType;
+		typedef typename _UpdaterBase::WeightType WeightType;
+		typedef typename _UpdaterBase::GradientType GradientType;
+		typedef typename _LearningRateBase::RateType RateType;
+
+		SilvaAlmeidaUpdater(NetworkType& network, RateType up = DEF_UP_RATE, RateType down = DEF_DOWN_RATE) :
+		_UpdaterBase(network), _LearningRateBase(network), _AdaptiveRateBase(up, down),
+		m_gradientCache(network)
+		{ }
+
+		/** Update the given block of weights starting at the given flat index. */
+		void operator()(WeightType weights[], size_t index, size_t count)
+		{
+			static const WeightType ZERO_WEIGHT = static_cast<WeightType>(0);
+			const WeightType *gradient = this->m_gradient + index;
+			WeightType *gradientCache = m_gradientCache.getData() + index;
+			RateType *rates = this->m_learningRatesLin + index;
+			const RateType up = this->getUpRate(), down = this->getDownRate();
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				// update the weight
+				weights[i] -= rates[i] * gradient[i];
+
+				// update the learning rate
+				const WeightType signum = gradientCache[i] * gradient[i];
+				if (signum > ZERO_WEIGHT)
+					rates[i] *= up;
+				else if (signum < ZERO_WEIGHT)
+					rates[i] *= down;
+
+				// cache the gradient
+				gradientCache[i] = gradient[i];
+			}
+		}
+
+		void reset()
+		{
+			m_gradientCache.fill(0);
+		}
+
+	protected:
+		WeightsBuffer<WeightType> m_gradientCache;
+
+		static const RateType DEF_UP_RATE;
+		static const RateType DEF_DOWN_RATE;
+	};
+
+	template <typename NetworkT>
+	const typename SilvaAlmeidaUpdater<NetworkT>::RateType SilvaAlmeidaUpdater<NetworkT>::DEF_UP_RATE
+		= static_cast<typename SilvaAlmeidaUpdater<NetworkT>::RateType>( 1.2f );
+	
+	template <typename NetworkT>
+	const typename SilvaAlmeidaUpdater<NetworkT>::RateType SilvaAlmeidaUpdater<NetworkT>::DEF_DOWN_RATE
+		= static_cast<typename SilvaAlmeidaUpdater<NetworkT>::RateType>( 0.8f );
+
+
+// DELTA-BAR-DELTA ALGORITHM //////////////////////////////////////////////////
+
+	/**
+	Updater used by Delta-bar-delta algorithm.
+	*/
+	template <typename NetworkT>
+	class DeltaBarDeltaUpdater :
+		public WeightsUpdaterBase< NetworkT, DeltaBarDeltaUpdater<NetworkT> >,
+		public LocalLearningRate<typename NetworkT::WeightType>,
+		public AdaptiveRate<typename NetworkT::WeightType>
+	{
+	private:
+		typedef WeightsUpdaterBase< NetworkT, DeltaBarDeltaUpdater<NetworkT> > _UpdaterBase;
+		typedef LocalLearningRate<typename NetworkT::WeightType> _LearningRateBase;
+		typedef AdaptiveRate<typename NetworkT::WeightType> _AdaptiveRateBase;
+
+	public:
+		typedef typename _UpdaterBase::NetworkType NetworkType;
+		typedef typename _UpdaterBase::WeightType WeightType;
+		typedef typename _UpdaterBase::GradientType GradientType;
+		typedef typename _LearningRateBase::RateType RateType;
+
+		DeltaBarDeltaUpdater(NetworkType& network, RateType up = DEF_UP_RATE, RateType down = DEF_DOWN_RATE,
+		RateType inertia = DEF_INERTIA) :
+		_UpdaterBase(network), _LearningRateBase(network), _AdaptiveRateBase(up, down),
+		m_deltasCache(network)
+		{
+			setInertia(inertia);
+		}
+
+		/** Update the given block of weights starting at the given flat index. */
+		void operator()(WeightType weights[], size_t index, size_t count)
+		{
+			static const WeightType ZERO_WEIGHT = static_cast<WeightType>(0);
+			const WeightType *gradient = this->m_gradient + index;
+			WeightType *deltasCache = m_deltasCache.getData() + index;
+			RateType *rates = this->m_learningRatesLin + index;
+			const RateType up = this->getUpRate(), down = this->getDownRate();
+			const RateType inertia = getInertia(), inertiaInv = getInertiaInv();
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				// update the weight
+				weights[i] -= rates[i] * gradient[i];
+
+				// update the learning rate
+				const WeightType signum = gradient[i] * deltasCache[i];
+				if (signum > ZERO_WEIGHT)
+					rates[i] += up;
+				else if (signum < ZERO_WEIGHT)
+					rates[i] *= down;
+
+				// update the delta param
+				deltasCache[i] = inertiaInv * gradient[i] + inertia * deltasCache[i];
+			}
+		}
+
+		void reset()
+		{
+			m_deltasCache.fill(0);
+		}
+
+		inline RateType getInertia() const { return m_inertia; }
+		inline RateType getInertiaInv() const { return m_inertiaInv; }
+		
+		inline void setInertia(RateType inertia)
+		{
+			m_inertia = inertia;
+			m_inertiaInv = static_cast<RateType>(1) - inertia;
+		}
+
+	protected:
+		WeightsBuffer<WeightType> m_deltasCache;
+		WeightType m_inertia, m_inertiaInv;
+
+		static const RateType DEF_UP_RATE;
+		static const RateType DEF_DOWN_RATE;
+		static const WeightType DEF_INERTIA;
+	};
+
+	template <typename NetworkT>
+	const typename DeltaBarDeltaUpdater<NetworkT>::RateType DeltaBarDeltaUpdater<NetworkT>::DEF_UP_RATE
+		= static_cast<typename DeltaBarDeltaUpdater<NetworkT>::RateType>( 0.09f );
+	
+	template <typename NetworkT>
+	const typename DeltaBarDeltaUpdater<NetworkT>::RateType DeltaBarDeltaUpdater<NetworkT>::DEF_DOWN_RATE
+		= static_cast<typename DeltaBarDeltaUpdater<NetworkT>::RateType>( 0.8f );
+
+	template <typename NetworkT>
+	const typename DeltaBarDeltaUpdater<NetworkT>::WeightType DeltaBarDeltaUpdater<NetworkT>::DEF_INERTIA
+		= static_cast<typename DeltaBarDeltaUpdater<NetworkT>::WeightType>( 0.5f );
+
+
+// SUPER SAB ALGORITHM ////////////////////////////////////////////////////////
+
+	/**
+	Updater used by Super SAB (Self-Adapting Back-propagation) algorithm.
+	*/
+	template <typename NetworkT>
+	class SuperSABUpdater :
+		public WeightsUpdaterBase< NetworkT, SuperSABUpdater<NetworkT> >,
+		public LocalLearningRate<typename NetworkT::WeightType>,
+		public AdaptiveRate<typename NetworkT::WeightType>,
+		public GlobalLearningMomentum<typename NetworkT::WeightType>
+	{
+	private:
+		typedef WeightsUpdaterBase< NetworkT, SuperSABUpdater<NetworkT> > _UpdaterBase;
+		typedef LocalLearningRate<typename NetworkT::WeightType> _LearningRateBase;
+		typedef AdaptiveRate<typename NetworkT::WeightType> _AdaptiveRateBase;
+		typedef GlobalLearningMomentum<typename NetworkT::WeightType> _LearningMomentumBase;
+
+	public:
+		typedef typename _UpdaterBase::NetworkType NetworkType;
+		typedef typename _UpdaterBase::WeightType WeightType;
+		typedef typename _UpdaterBase::GradientType GradientType;
+		typedef typename _LearningRateBase::RateType RateType;
+		typedef typename _LearningMomentumBase::MomentumType MomentumType;
+
+		SuperSABUpdater(NetworkType& network, RateType up = DEF_UP_RATE, RateType down = DEF_DOWN_RATE) :
+		_UpdaterBase(network), _LearningRateBase(network), _AdaptiveRateBase(up, down),
+		m_gradientCache(network), m_weightsCache(network), m_stepsCache(network),
+		m_maxLearningRate(DEF_MAX_RATE)
+		{ }
+
+		/** Update the given block of weights starting at the given flat index. */
+		void operator()(WeightType weights[], size_t index, size_t count)
+		{
+			static const WeightType ZERO_WEIGHT = static_cast<WeightType>(0);
+			const WeightType *gradient = this->m_gradient + index;
+			WeightType *gradientCache = m_gradientCache.getData() + index;
+			WeightType *weightsCache = m_weightsCache.getData() + index;
+			WeightType *stepsCache = m_stepsCache.getData() + index;
+			RateType *rates = this->m_learningRatesLin + index;
+			const MomentumType momentum = this->getLearningMomentum();
+			const RateType up = this->getUpRate(), down = this->getDownRate();
+			const RateType maxRate = getMaxLearningRate();
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				// change of derivation
+				const WeightType signum = gradientCache[i] * gradient[i];
+
+				if (signum >= ZERO_WEIGHT)
+				{
+					// compute current step and cache it
+					stepsCache[i] = momentum * (weights[i] - weightsCache[i]) - rates[i] * gradient[i];
+
+					// cache the old weight and the old gradient
+					weightsCache[i] = weights[i];
+					gradientCache[i] = gradient[i];
+
+					// update the weight
+					weights[i] += stepsCache[i];
+
+					// update the learning rate if needed
+					if (rates[i] < maxRate)
+						rates[i] *= up;
+				}
+				else
+				{
+					// reset the last weight update
+					weights[i] -= stepsCache[i];
+
+					// annulate the step cache and the update cache
+					stepsCache[i] = gradientCache[i] = ZERO_WEIGHT;
+
+					// update the learning rate
+					rates[i] *= down;
+				}
+			}
+		}
+
+		void reset()
+		{
+			m_gradientCache.fill(0);
+			m_weightsCache.fill(0);
+			m_stepsCache.fill(0);
+		}
+
+		inline WeightType getMaxLearningRate() const { return m_maxLearningRate; }
+		inline void setMaxLearningRate(WeightType rate) { m_maxLearningRate = rate; }
+
+	protected:
+		WeightsBuffer<WeightType> m_gradientCache;
+		WeightsBuffer<WeightType> m_weightsCache;
+		WeightsBuffer<WeightType> m_stepsCache;
+		WeightType m_maxLearningRate;
+
+		static const RateType DEF_UP_RATE, DEF_DOWN_RATE;
+		static const RateType DEF_MAX_RATE;
+	};
+
+	template <typename NetworkT>
+	const typename SuperSABUpdater<NetworkT>::RateType SuperSABUpdater<NetworkT>::DEF_UP_RATE
+		= static_cast<typename SuperSABUpdater<NetworkT>::RateType>( 1.05f );
+	
+	template <typename NetworkT>
+	const typename SuperSABUpdater<NetworkT>::RateType SuperSABUpdater<NetworkT>::DEF_DOWN_RATE
+		= static_cast<typename SuperSABUpdater<NetworkT>::RateType>( 0.5f );
+		
+	template <typename NetworkT>
+	const typename SuperSABUpdater<NetworkT>::RateType SuperSABUpdater<NetworkT>::DEF_MAX_RATE
+		= static_cast<typename SuperSABUpdater<NetworkT>::RateType>( 0.8f );
+
+
+// QUICKPROP ALGORITHM ////////////////////////////////////////////////////////
+
+	/**
+	Updater used by the Quickprop (Quick-propagation) algorithm.
+	*/
+	template <typename NetworkT>
+	class QuickpropUpdater :
+		public WeightsUpdaterBase< NetworkT, QuickpropUpdater<NetworkT> >
+	{
+	private:
+		typedef WeightsUpdaterBase< NetworkT, QuickpropUpdater<NetworkT> > _UpdaterBase;
+
+	public:
+		typedef typename _UpdaterBase::NetworkType NetworkType;
+		typedef typename _UpdaterBase::WeightType WeightType;
+		typedef typename _UpdaterBase::GradientType GradientType;
+		
+		QuickpropUpdater(NetworkType& network) :
+		_UpdaterBase(network), m_gradientCache(network), m_stepsCache(network)
+		{
+			reset();
+		}
+
+		/** Update the given block of weights starting at the given flat index. */
+		void operator()(WeightType weights[], size_t index, size_t count)
+		{
+			const WeightType *gradient = this->m_gradient + index;
+			WeightType *gradientCache = m_gradientCache.getData() + index;
+			WeightType *stepsCache = m_stepsCache.getData() + index;
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				// difference between current and previous gradient
+				const WeightType gradientDiff = gradientCache[i] - gradient[i];
+
+				if ( !isZero(gradientDiff) )
+				{
+					// compute step of the weight and cache it
+					stepsCache[i] = stepsCache[i] * gradient[i] / gradientDiff;
+
+					// cache current gradient
+					gradientCache[i] = gradient[i];
+
+					// update the weight
+					weights[i] += stepsCache[i];
+				}
+			}
+		}
+
+		void reset()
+		{
+			m_gradientCache.fill(0);
+			m_stepsCache.fill(-2);
+		}
+
+	protected:
+		WeightsBuffer<WeightType> m_gradientCache;
+		WeightsBuffer<WeightType> m_stepsCache;
+
+		/** Informs whether the given value is approximately equal to zero. */
+		inline bool isZero(const WeightType& weight)
+		{
+			static const WeightType POS = static_cast<WeightType>( 0.000001f );
+			static const WeightType NEG = -POS;
+			return (weight > NEG) && (weight < POS);
+		}
+	};
+
+
+// RPROP ALGORITHM //////////////////////////////////////////////
+
+	/**
+	Updater used by Rprop algorithm.
+	*/
+	template <typename NetworkT>
+	class RpropUpdater :
+		public WeightsUpdaterBase< NetworkT, RpropUpdater<NetworkT> >,
+		public LocalLearningRate<typename NetworkT::WeightType>,
+		public AdaptiveRate<typename NetworkT::WeightType>
+	{
+	private:
+		typedef WeightsUpdaterBase< NetworkT, RpropUpdater<NetworkT> > _UpdaterBase;
+		typedef LocalLearningRate<typename NetworkT::WeightType> _LearningRateBase;
+		typedef AdaptiveRate<typename NetworkT::WeightType> _AdaptiveRateBase;
+
+	public:
+		typedef typename _UpdaterBase::NetworkType NetworkType;
+		typedef typename _UpdaterBase::WeightType WeightType;
+		typedef typename _UpdaterBase::GradientType GradientType;
+		typedef typename _LearningRateBase::RateType RateType;
+
+		RpropUpdater(NetworkType& network, RateType up = DEF_UP_RATE, RateType down = DEF_DOWN_RATE) :
+		_UpdaterBase(network), _LearningRateBase(network), _AdaptiveRateBase(up, down),
+		m_gradientCache(network), m_maxRate(DEF_MAX_RATE), m_minRate(DEF_MIN_RATE)
+		{ }
+
+		/** Update the given block of weights starting at the given flat index. */
+		void operator()(WeightType weights[], size_t index, size_t count)
+		{
+			static const WeightType ZERO_WEIGHT = static_cast<WeightType>(0);
+			const WeightType *gradient = this->m_gradient + index;
+			WeightType *gradientCache = m_gradientCache.getData() + index;
+			RateType *rates = this->m_learningRatesLin + index;
+			const RateType up = this->getUpRate(), down = this->getDownRate();
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				const RateType learningRate = rates[i];
+				const WeightType signum = gradientCache[i] * gradient[i];
+
+				if (signum >= ZERO_WEIGHT)
+				{
+					// update the weight
+					weights[i] -= learningRate * sgn( gradient[i] );
+
+					// increase the learning rate if the maximal value hasn't been already reached
+					if (learningRate < m_maxRate)
+						rates[i] = learningRate * up;
+				}
+				else
+				{
+					// decrease the learning rate if the minimal value hasn't been already reached
+					if (learningRate > m_minRate)
+						rates[i] = learningRate * down;
+				}
+
+				// cache the gradient
+				gradientCache[i] = gradient[i];
+			}
+		}
+
+		void reset()
+		{
+			m_gradientCache.fill(0);
+		}
+
+	protected:
+		WeightsBuffer<WeightType> m_gradientCache;
+		RateType m_maxRate, m_minRate;
+
+		static const RateType DEF_UP_RATE, DEF_DOWN_RATE;
+		static const RateType DEF_MAX_RATE, DEF_MIN_RATE;
+	};
+
+	template <typename NetworkT>
+	const typename RpropUpdater<NetworkT>::RateType RpropUpdater<NetworkT>::DEF_UP_RATE
+		= static_cast<typename RpropUpdater<NetworkT>::RateType>( 1.2f );
+	
+	template <typename NetworkT>
+	const typename RpropUpdater<NetworkT>::RateType RpropUpdater<NetworkT>::DEF_DOWN_RATE
+		= static_cast<typename RpropUpdater<NetworkT>::RateType>( 0.8f );
+	
+	template <typename NetworkT>
+	const typename RpropUpdater<NetworkT>::RateType RpropUpdater<NetworkT>::DEF_MAX_RATE
+		= static_cast<typename RpropUpdater<NetworkT>::RateType>( 1.8f );
+		
+	template <typename NetworkT>
+	const typename RpropUpdater<NetworkT>::RateType RpropUpdater<NetworkT>::DEF_MIN_RATE
+		= static_cast<typename RpropUpdater<NetworkT>::RateType>( 0.2f );
+
+
+// QRPROP ALGORITHM //////////////////////////////////////////////
+
+	/**
+	Updater used by QRprop algorithm.
+	*/
+	template <typename NetworkT>
+	class QRpropUpdater :
+		public WeightsUpdaterBase< NetworkT, QRpropUpdater<NetworkT> >,
+		public LocalLearningRate<typename NetworkT::WeightType>,
+		public AdaptiveRate<typename NetworkT::WeightType>,
+		public MinMaxRate<typename NetworkT::WeightType>
+	{
+	private:
+		typedef WeightsUpdaterBase< NetworkT, QRpropUpdater<NetworkT> > _UpdaterBase;
+		typedef LocalLearningRate<typename NetworkT::WeightType> _LearningRateBase;
+		typedef AdaptiveRate<typename NetworkT::WeightType> _AdaptiveRateBase;
+		typedef MinMaxRate<typename NetworkT::WeightType> _MinMaxRateBase;
+
+	public:
+		typedef typename _UpdaterBase::NetworkType NetworkType;
+		typedef typename _UpdaterBase::WeightType WeightType;
+		typedef typename _UpdaterBase::GradientType GradientType;
+		typedef typename _LearningRateBase::RateType RateType;
+
+		QRpropUpdater(NetworkType& network, RateType up = DEF_UP_RATE, RateType down = DEF_DOWN_RATE,
+			RateType max = DEF_MAX_RATE, RateType min = DEF_MIN_RATE) :
+		_UpdaterBase(network), _LearningRateBase(network), _AdaptiveRateBase(up, down), _MinMaxRateBase(min, max),
+		m_gradientCache(network), m_gradientCache2(network), m_q(network)
+		{ }
+
+		/** Update the given block of weights starting at the given flat index. */
+		void operator()(WeightType weights[], size_t index, size_t count)
+		{
+			static const WeightType ZERO_WEIGHT = static_cast<WeightType>(0);
+			const WeightType *gradient = this->m_gradient + index;
+			WeightType *gradientCache = m_gradientCache.getData() + index;
+			WeightType *gradientCache2 = m_gradientCache2.getData() + index;
+			WeightType *q = m_q.getData() + index;
+			RateType *rates = this->m_learningRatesLin + index;
+			const RateType up = this->getUpRate();
+			const RateType downRateInv = static_cast<RateType>(1) / this->getDownRate();
+			const RateType minRate = this->getMinRate(), maxRate = this->getMaxRate();
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				const WeightType signum = gradientCache[i] * gradient[i];
+
+				if (signum == ZERO_WEIGHT)
+				{
+					// update q-param
+					if ( gradient[i] != gradientCache2[i] ) {
+						const WeightType deriv = std::abs( gradient[i] / (gradient[i] - gradientCache[i]) );
+						q[i] = max( up, min(downRateInv, deriv) );
+					}
+					else {
+						q[i] = downRateInv;
+					}
+
+					// update learning rate, weight and cache
+					rates[i] = max(minRate, q[i] * rates[i]);
+				}
+				else if (signum > ZERO_WEIGHT)
+				{
+					// update learning rate, weight and cache
+					rates[i] = min(maxRate, up * rates[i]);
+				}
+				else
+				{
+					// update neither learning-param nor weight and don't cache the last gradient
+					gradientCache2[i] = gradientCache[i];
+					gradientCache[i] = ZERO_WEIGHT;
+					continue;
+				}
+
+				weights[i] -= rates[i] * sgn( gradient[i] );
+				gradientCache2[i] = gradientCache[i];
+				gradientCache[i] = gradient[i];
+			}
+		}
+
+		void reset()
+		{
+			m_gradientCache.fill(0);
+			m_gradientCache2.fill(0);
+			m_q.fill(0);
+		}
+
+	protected:
+		WeightsBuffer<WeightType> m_gradientCache, m_gradientCache2, m_q;
+
+		static const RateType DEF_UP_RATE, DEF_DOWN_RATE;
+		static const RateType DEF_MAX_RATE, DEF_MIN_RATE;
+	};
+
+	template <typename NetworkT>
+	const typename QRpropUpdater<NetworkT>::RateType QRpropUpdater<NetworkT>::DEF_UP_RATE
+		= static_cast<typename QRpropUpdater<NetworkT>::RateType>( 1.2f );
+	
+	template <typename NetworkT>
+	const typename QRpropUpdater<NetworkT>::RateType QRpropUpdater<NetworkT>::DEF_DOWN_RATE
+		= static_cast<typename QRpropUpdater<NetworkT>::RateType>( 0.6f );
+	
+	template <typename NetworkT>
+	const typename QRpropUpdater<NetworkT>::RateType QRpropUpdater<NetworkT>::DEF_MAX_RATE
+		= static_cast<typename QRpropUpdater<NetworkT>::RateType>( 3.0f );
+	
+	template <typename NetworkT>
+	const typename QRpropUpdater<NetworkT>::RateType QRpropUpdater<NetworkT>::DEF_MIN_RATE
+		= static_cast<typename QRpropUpdater<NetworkT>::RateType>( 0.05f );
+
+
+// ADAM ALGORITHM /////////////////////////////////////////////////////////////
+
+	/**
+	Updater used by Adam algorithm - a global learning rate scaled for every
+	weight by the moving averages of the gradient (first moment) and of its
+	squares (second moment) with the bias correction of the initial steps.
+	The optional weight decay is decoupled from the gradient (AdamW).
+	The moments are updated together with the weights in one fused pass.
+	*/
+	template <typename NetworkT>
+	class AdamUpdater :
+		public WeightsUpdaterBase< NetworkT, AdamUpdater<NetworkT> >,
+		public GlobalLearningRate<typename NetworkT::WeightType>
+	{
+	private:
+		typedef WeightsUpdaterBase< NetworkT, AdamUpdater<NetworkT> > _UpdaterBase;
+		typedef GlobalLearningRate<typename NetworkT::WeightType> _LearningRateBase;
+
+	public:
+		typedef typename _UpdaterBase::NetworkType NetworkType;
+		typedef typename _UpdaterBase::WeightType WeightType;
+		typedef typename _UpdaterBase::GradientType GradientType;
+		typedef typename _LearningRateBase::RateType RateType;
+
+		AdamUpdater(NetworkType& network, RateType rate = DEF_RATE, RateType beta1 = DEF_BETA1,
+			RateType beta2 = DEF_BETA2, RateType weightDecay = 0) :
+		_UpdaterBase(network), _LearningRateBase(rate),
+		m_moments(network), m_squares(network),
+		m_beta1(beta1), m_beta2(beta2), m_epsilon(DEF_EPSILON), m_weightDecay(weightDecay),
+		m_step(0)
+		{ }
+
+		/** Set the gradient and the rates of the next step for the updates of
+		blocks by operator(). */
+		inline void beginUpdate(const GradientType& gradient)
+		{
+			_UpdaterBase::beginUpdate(gradient);
+			beginStep();
+		}
+
+		/** Update the given block of weights starting at the given flat index. */
+		void operator()(WeightType weights[], size_t index, size_t count)
+		{
+			updateAdamMoments( weights, this->m_gradient + index, m_moments.getData() + index,
+				m_squares.getData() + index, count, m_stepRate, m_beta1, m_beta2, m_epsilon, m_decayRate );
+		}
+
+		void reset()
+		{
+			m_moments.fill(0);
+			m_squares.fill(0);
+			m_step = 0;
+		}
+
+		inline RateType getBeta1() const { return m_beta1; }
+		inline void setBeta1(RateType beta1) { m_beta1 = beta1; }
+
+		inline RateType getBeta2() const { return m_beta2; }
+		inline void setBeta2(RateType beta2) { m_beta2 = beta2; }
+
+		inline RateType getEpsilon() const { return m_epsilon; }
+		inline void setEpsilon(RateType epsilon) { m_epsilon = epsilon; }
+
+		inline RateType getWeightDecay() const { return m_weightDecay; }
+		inline void setWeightDecay(RateType weightDecay) { m_weightDecay = weightDecay; }
+
+		/** Get count of the performed steps. */
+		inline size_t getStep() const { return m_step; }
+
+	protected:
+		WeightsBuffer<WeightType> m_moments, m_squares;
+		RateType m_beta1, m_beta2, m_epsilon, m_weightDecay;
+		size_t m_step;
+
+		/** Learning rate with the bias correction and the decay of the current step. */
+		RateType m_stepRate, m_decayRate;
+
+		static const RateType DEF_RATE, DEF_BETA1, DEF_BETA2, DEF_EPSILON;
+
+		inline void beginStep()
+		{
+			++m_step;
+			const RateType rate = this->getLearningRate();
+			m_stepRate = static_cast<RateType>( rate * std::sqrt( 1 - std::pow(m_beta2, static_cast<RateType>(m_step)) ) /
+				( 1 - std::pow(m_beta1, static_cast<RateType>(m_step)) ) );
+			m_decayRate = rate * m_weightDecay;
+		}
+	};
+
+	template <typename NetworkT>
+	const typename AdamUpdater<NetworkT>::RateType AdamUpdater<NetworkT>::DEF_RATE
+		= static_cast<typename AdamUpdater<NetworkT>::RateType>( 0.001f );
+
+	template <typename NetworkT>
+	const typename AdamUpdater<NetworkT>::RateType AdamUpdater<NetworkT>::DEF_BETA1
+		= static_cast<typename AdamUpdater<NetworkT>::RateType>( 0.9f );
+
+	template <typename NetworkT>
+	const typename AdamUpdater<NetworkT>::RateType AdamUpdater<NetworkT>::DEF_BETA2
+		= static_cast<typename AdamUpdater<NetworkT>::RateType>( 0.999f );
+
+	template <typename NetworkT>
+	const typename AdamUpdater<NetworkT>::RateType AdamUpdater<NetworkT>::DEF_EPSILON
+		= static_cast<typename AdamUpdater<NetworkT>::RateType>( 1e-8f );
+
+
+	/**
+	Updater used by AdamW algorithm - Adam with a decoupled weight decay.
+	*/
+	template <typename NetworkT>
+	class AdamWUpdater :
+		public AdamUpdater<NetworkT>
+	{
+	private:
+		typedef AdamUpdater<NetworkT> _AdamBase;
+
+	public:
+		typedef typename _AdamBase::NetworkType NetworkType;
+		typedef typename _AdamBase::RateType RateType;
+
+		AdamWUpdater(NetworkType& network, RateType rate = _AdamBase::DEF_RATE,
+			RateType weightDecay = DEF_WEIGHT_DECAY) :
+		_AdamBase(network, rate, _AdamBase::DEF_BETA1, _AdamBase::DEF_BETA2, weightDecay)
+		{ }
+
+	protected:
+		static const RateType DEF_WEIGHT_DECAY;
+	};
+
+	template <typename NetworkT>
+	const typename AdamWUpdater<NetworkT>::RateType AdamWUpdater<NetworkT>::DEF_WEIGHT_DECAY
+		= static_cast<typename AdamWUpdater<NetworkT>::RateType>( 0.01f );
+
+
+// RMSPROP ALGORITHM //////////////////////////////////////////////////////////
+
+	/**
+	Updater used by RMSProp algorithm - a global learning rate divided for every
+	weight by the root of the moving average of squares of its gradient.
+	*/
+	template <typename NetworkT>
+	class RMSPropUpdater :
+		public WeightsUpdaterBase< NetworkT, RMSPropUpdater<NetworkT> >,
+		public GlobalLearningRate<typename NetworkT::WeightType>
+	{
+	private:
+		typedef WeightsUpdaterBase< NetworkT, RMSPropUpdater<NetworkT> > _UpdaterBase;
+		typedef GlobalLearningRate<typename NetworkT::WeightType> _LearningRateBase;
+
+	public:
+		typedef typename _UpdaterBase::NetworkType NetworkType;
+		typedef typename _UpdaterBase::WeightType WeightType;
+		typedef typename _UpdaterBase::GradientType GradientType;
+		typedef typename _LearningRateBase::RateType RateType;
+
+		RMSPropUpdater(NetworkType& network, RateType rate = DEF_RATE, RateType decay = DEF_DECAY) :
+		_UpdaterBase(network), _LearningRateBase(rate),
+		m_squares(network), m_decay(decay), m_epsilon(DEF_EPSILON)
+		{ }
+
+		/** Update the given block of weights starting at the given flat index. */
+		void operator()(WeightType weights[], size_t index, size_t count)
+		{
+			updateSquaresMoments( weights, this->m_gradient + index, m_squares.getData() + index, count,
+				this->getLearningRate(), m_decay, 1 - m_decay, m_epsilon );
+		}
+
+		void reset()
+		{
+			m_squares.fill(0);
+		}
+
+		/** Get decay of the moving average of squares of the gradient. */
+		inline RateType getDecay() const { return m_decay; }
+		inline void setDecay(RateType decay) { m_decay = decay; }
+
+		inline RateType getEpsilon() const { return m_epsilon; }
+		inline void setEpsilon(RateType epsilon) { m_epsilon = epsilon; }
+
+	protected:
+		WeightsBuffer<WeightType> m_squares;
+		RateType m_decay, m_epsilon;
+
+		static const RateType DEF_RATE, DEF_DECAY, DEF_EPSILON;
+	};
+
+	template <typename NetworkT>
+	const typename RMSPropUpdater<NetworkT>::RateType RMSPropUpdater<NetworkT>::DEF_RATE
+		= static_cast<typename RMSPropUpdater<NetworkT>::RateType>( 0.001f );
+
+	template <typename NetworkT>
+	const typename RMSPropUpdater<NetworkT>::RateType RMSPropUpdater<NetworkT>::DEF_DECAY
+		= static_cast<typename RMSPropUpdater<NetworkT>::RateType>( 0.9f );
+
+	template <typename NetworkT>
+	const typename RMSPropUpdater<NetworkT>::RateType RMSPropUpdater<NetworkT>::DEF_EPSILON
+		= static_cast<typename RMSPropUpdater<NetworkT>::RateType>( 1e-8f );
+
+
+// ADAGRAD ALGORITHM //////////////////////////////////////////////////////////
+
+	/**
+	Updater used by AdaGrad algorithm - a global learning rate divided for every
+	weight by the root of the sum of squares of all its gradients.
+	*/
+	template <typename NetworkT>
+	class AdaGradUpdater :
+		public WeightsUpdaterBase< NetworkT, AdaGradUpdater<NetworkT> >,
+		public GlobalLearningRate<typename NetworkT::WeightType>
+	{
+	private:
+		typedef WeightsUpdaterBase< NetworkT, AdaGradUpdater<NetworkT> > _UpdaterBase;
+		typedef GlobalLearningRate<typename NetworkT::WeightType> _LearningRateBase;
+
+	public:
+		typedef typename _UpdaterBase::NetworkType NetworkType;
+		typedef typename _UpdaterBase::WeightType WeightType;
+		typedef typename _UpdaterBase::GradientType GradientType;
+		typedef typename _LearningRateBase::RateType RateType;
+
+		AdaGradUpdater(NetworkType& network, RateType rate = DEF_RATE) :
+		_UpdaterBase(network), _LearningRateBase(rate),
+		m_squares(network), m_epsilon(DEF_EPSILON)
+		{ }
+
+		/** Update the given block of weights starting at the given flat index. */
+		void operator()(WeightType weights[], size_t index, size_t count)
+		{
+			static const WeightType ONE = static_cast<WeightType>(1);
+			updateSquaresMoments( weights, this->m_gradient + index, m_squares.getData() + index, count,
+				this->getLearningRate(), ONE, ONE, m_epsilon );
+		}
+
+		void reset()
+		{
+			m_squares.fill(0);
+		}
+
+		inline RateType getEpsilon() const { return m_epsilon; }
+		inline void setEpsilon(RateType epsilon) { m_epsilon = epsilon; }
+
+	protected:
+		WeightsBuffer<WeightType> m_squares;
+		RateType m_epsilon;
+
+		static const RateType DEF_RATE, DEF_EPSILON;
+	};
+
+	template <typename NetworkT>
+	const typename AdaGradUpdater<NetworkT>::RateType AdaGradUpdater<NetworkT>::DEF_RATE
+		= static_cast<typename AdaGradUpdater<NetworkT>::RateType>( 0.01f );
+
+	template <typename NetworkT>
+	const typename AdaGradUpdater<NetworkT>::RateType AdaGradUpdater<NetworkT>::DEF_EPSILON
+		= static_cast<typename AdaGradUpdater<NetworkT>::RateType>( 1e-8f );
+
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,9 @@
+#include "benchmarks/benchmark.h"
+
+namespace NNLib
+{
+	
+	const double BenchmarkRunner::DEF_MIN_SECONDS = 0.25;
+	volatile double BenchmarkRunner::s_sink = 0;
+	
+}
@@ -0,0 +1,155 @@
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <chrono>
+#include <algorithm>
+#include "common/cycleCounter.h"
+
+namespace NNLib
+{
+
+	/**
+	Result of a single benchmark. Times are per one processed item (a vector
+	element, a weight, a pattern ...) so results of different sizes can be compared.
+	*/
+	struct BenchmarkResult
+	{
+		std::string group;
+		std::string name;
+		size_t size;
+		size_t iterations;
+		double minNanoseconds;
+		double medianNanoseconds;
+		double cyclesPerItem;
+
+		inline double getItemsPerSecond() const
+		{
+			return (minNanoseconds > 0) ? 1e9 / minNanoseconds : 0;
+		}
+	};
+
+
+	/**
+	Runner of microbenchmarks. A benchmark is a functor returning a number which
+	is summed to a volatile sink so the compiler cannot throw the measured work
+	away. The count of calls per repetition is doubled until the repetition takes
+	at least the given time, then the repetitions are measured and their minimum
+	and median are stored. Benchmarks whose group/name doesn't contain the filter
+	are skipped.
+	*/
+	class BenchmarkRunner
+	{
+	public:
+		typedef std::vector<BenchmarkResult> ResultsList;
+
+		static const double DEF_MIN_SECONDS;
+		static const size_t DEF_REPEATS = 5;
+
+		BenchmarkRunner(double minSeconds = DEF_MIN_SECONDS, size_t repeats = DEF_REPEATS,
+			const std::string& filter = "") :
+		m_minSeconds(minSeconds), m_repeats( (repeats > 0) ? repeats : 1 ), m_filter(filter)
+		{ }
+
+		/** Check whether the benchmark of the given group and name will be run. */
+		inline bool isEnabled(const std::string& group, const std::string& name) const
+		{
+			return ( (group + "/" + name).find(m_filter) != std::string::npos );
+		}
+
+		/** Measure the given functor which processes the given count of items per call. */
+		template <typename FuncT>
+		void run(const std::string& group, const std::string& name, size_t size,
+			FuncT& func, size_t itemsPerCall)
+		{
+			if ( !isEnabled(group, name) )
+				return;
+
+			// warm up and find count of calls per repetition
+			size_t iterations = 1;
+			while ( measure(func, iterations).first < m_minSeconds / m_repeats && iterations < MAX_ITERATIONS )
+				iterations *= 2;
+
+			std::vector<double> seconds(m_repeats);
+			CycleType minCycles = 0;
+			for (size_t repeat = 0; repeat < m_repeats; ++repeat) {
+				std::pair<double,CycleType> time = measure(func, iterations);
+				seconds[repeat] = time.first;
+				if (repeat == 0 || time.second < minCycles)
+					minCycles = time.second;
+			}
+			std::sort( seconds.begin(), seconds.end() );
+
+			const double items = static_cast<double>(iterations) * itemsPerCall;
+			BenchmarkResult result;
+			result.group = group;
+			result.name = name;
+			result.size = size;
+			result.iterations = iterations;
+			result.minNanoseconds = 1e9 * seconds.front() / items;
+			result.medianNanoseconds = 1e9 * seconds[m_repeats / 2] / items;
+			result.cyclesPerItem = minCycles / items;
+			m_results.push_back(result);
+		}
+
+		inline const ResultsList& getResults() const { return m_results; }
+
+		/** Print the results as CSV with a header line. */
+		void printCSV(std::ostream& os) const
+		{
+			os << "group,name,size,iterations,minNs,medianNs,cyclesPerItem,itemsPerSecond\n";
+			for (ResultsList::const_iterator it = m_results.begin(); it != m_results.end(); ++it)
+				os << it->group << "," << it->name << "," << it->size << "," << it->iterations << "," <<
+					it->minNanoseconds << "," << it->medianNanoseconds << "," << it->cyclesPerItem << "," <<
+					it->getItemsPerSecond() << "\n";
+		}
+
+		/** Print the results as a JSON array of objects. */
+		void printJSON(std::ostream& os) const
+		{
+			os << "[\n";
+			for (ResultsList::const_iterator it = m_results.begin(); it != m_results.end(); ++it)
+				os << ( (it != m_results.begin()) ? ",\n" : "" ) << "{\"group\":\"" << it->group <<
+					"\",\"name\":\"" << it->name << "\",\"size\":" << it->size <<
+					",\"iterations\":" << it->iterations << ",\"minNs\":" << it->minNanoseconds <<
+					",\"medianNs\":" << it->medianNanoseconds << ",\"cyclesPerItem\":" << it->cyclesPerItem <<
+					",\"itemsPerSecond\":" << it->getItemsPerSecond() << "}";
+			os << "\n]\n";
+		}
+
+	protected:
+		static const size_t MAX_ITERATIONS = 1 << 30;
+
+		const double m_minSeconds;
+		const size_t m_repeats;
+		const std::string m_filter;
+		ResultsList m_results;
+
+		/** Sink for the results of the measured functors. */
+		static volatile double s_sink;
+
+		/** Call the functor the given count of times and return seconds and cycles. */
+		template <typename FuncT>
+		static std::pair<double,CycleType> measure(FuncT& func, size_t iterations)
+		{
+			typedef std::chrono::steady_clock Clock;
+			double sum = 0;
+			const Clock::time_point start = Clock::now();
+			const CycleType startCycles = readCycleCounter();
+			for (size_t i = 0; i < iterations; ++i)
+				sum += func();
+			const CycleType cycles = readCycleCounter() - startCycles;
+			const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+			s_sink = s_sink + sum;
+			return std::make_pair(seconds, cycles);
+		}
+
+	private:
+		BenchmarkRunner& operator=(const BenchmarkRunner&);
+	};
+
+}
+
+#endif
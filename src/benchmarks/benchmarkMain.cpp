@@ -0,0 +1,571 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include "common/range.h"
+#include "activationFunctions/sigmoidFunc.h"
+#include "activationFunctions/symmetricSigmoidFunc.h"
+#include "activationFunctions/tabbedSigmoidFunc.h"
+#include "activationFunctions/heavisideStepFunc.h"
+#include "activationFunctions/reluFunc.h"
+#include "activationFunctions/leakyReLUFunc.h"
+#include "activationFunctions/hardSigmoidFunc.h"
+#include "activationFunctions/symmetricHardSigmoidFunc.h"
+#include "combinators/dotProduct.h"
+#include "combinators/dotProductSSE.h"
+#include "neurons/neuronBase.h"
+#include "feedForward/feedForwardLayer.h"
+#include "feedForward/feedForwardNetwork.h"
+#include "feedForward/networkBufferAllocator.h"
+#include "data/inOutData.h"
+#include "data/sequentialAccessor.h"
+#include "data/randomAccessor.h"
+#include "data/iterCycleAccessor.h"
+#include "backPropagation/backPropBase.h"
+#include "backPropagation/gradientEvaluator.h"
+#include "backPropagation/weightsUpdater.h"
+#include "benchmarks/benchmark.h"
+
+using namespace NNLib;
+
+/*
+Benchmarks of the library kernels, layers and the whole training. Usage:
+  benchmark [--json] [--min-time=SECONDS] [--repeats=COUNT] [--filter=TEXT] [--output=FILE]
+Results are printed as CSV (or JSON) with times per one processed item. Random
+numbers are seeded by a constant so every run measures the same data.
+*/
+
+namespace
+{
+	const unsigned SEED = 42;
+
+	typedef InOutData< InOutPair<float> > Data;
+
+	typedef FeedForwardNetwork< FeedForwardLayer< NeuronBase<float, SigmoidFunc, DotProduct> > > Network;
+	typedef FeedForwardNetwork< FeedForwardLayer< NeuronBase<float, SigmoidFunc, DotProductSSE> > > NetworkSSE;
+
+	float randomFloat()
+	{
+		return 2 * static_cast<float>( ::rand() ) / RAND_MAX - 1;
+	}
+
+	void fillRandom(std::vector<float>& arr)
+	{
+		for (size_t i = 0; i < arr.size(); ++i)
+			arr[i] = randomFloat();
+	}
+
+	/** Fill the data by the given count of random patterns. */
+	void fillRandom(Data& data, size_t patternsCount)
+	{
+		std::vector<float> in( data.getInputLen() ), out( data.getOutputLen() );
+		for (size_t p = 0; p < patternsCount; ++p) {
+			fillRandom(in);
+			fillRandom(out);
+			data.add(&in[0], &out[0]);
+		}
+	}
+
+	/** Layers sizes of a network with the given count of hidden layers. */
+	Network::LayersSizes getLayersSizes(size_t width, size_t depth, size_t outputsCount)
+	{
+		Network::LayersSizes sizes(depth + 1, width);
+		sizes[depth] = outputsCount;
+		return sizes;
+	}
+
+	std::string toString(size_t val)
+	{
+		std::ostringstream os;
+		os << val;
+		return os.str();
+	}
+
+
+	/** Dot product of two vectors. The start of the first vector is moved by
+	every call so the compiler cannot hoist the computation out of the loop. */
+	template <typename CombinatorT>
+	class CombinatorBench
+	{
+	public:
+		CombinatorBench(size_t len) :
+		m_x(len + OFFSETS), m_y(len), m_len(len), m_offset(0)
+		{
+			fillRandom(m_x);
+			fillRandom(m_y);
+		}
+
+		inline double operator()()
+		{
+			m_offset = (m_offset + 1) % OFFSETS;
+			return m_combinator(&m_x[m_offset], &m_y[0], m_len);
+		}
+
+	protected:
+		static const size_t OFFSETS = 4;
+		CombinatorT m_combinator;
+		std::vector<float> m_x, m_y;
+		const size_t m_len;
+		size_t m_offset;
+	};
+
+
+	/** Call of the activation function or of its derivation from the function value. */
+	template <typename FuncT, bool DERIVATION>
+	struct ActivationCall
+	{
+		static inline float call(const FuncT& func, float x) { return func.function(x); }
+	};
+
+	template <typename FuncT>
+	struct ActivationCall<FuncT, true>
+	{
+		static inline float call(const FuncT& func, float y) { return func.valDerivation(y); }
+	};
+
+
+	/** Activation function (or derivation from its value) of a vector of values. */
+	template <typename FuncT, bool DERIVATION>
+	class ActivationBench
+	{
+	public:
+		ActivationBench(size_t len) :
+		m_x(len + 1), m_len(len), m_offset(0)
+		{
+			fillRandom(m_x);
+			for (size_t i = 0; i < m_x.size(); ++i)
+				m_x[i] = DERIVATION ? 0.5f * (m_x[i] + 1) : 8 * m_x[i];
+		}
+
+		inline double operator()()
+		{
+			m_offset ^= 1;
+			const float *x = &m_x[m_offset];
+			float sum = 0;
+			for (size_t i = 0; i < m_len; ++i)
+				sum += ActivationCall<FuncT, DERIVATION>::call(m_func, x[i]);
+			return sum;
+		}
+
+	protected:
+		FuncT m_func;
+		std::vector<float> m_x;
+		const size_t m_len;
+		size_t m_offset;
+	};
+
+
+	/** Bulk version of the activation function (or derivation from its value)
+	evaluating the whole vector in one call. */
+	template <typename FuncT, bool DERIVATION>
+	class ActivationBulkBench :
+		public ActivationBench<FuncT, DERIVATION>
+	{
+	public:
+		ActivationBulkBench(size_t len) :
+		ActivationBench<FuncT, DERIVATION>(len), m_y(len)
+		{ }
+
+		inline double operator()()
+		{
+			this->m_offset ^= 1;
+			const float *x = &this->m_x[this->m_offset];
+			if (DERIVATION)
+				this->m_func.valDerivation(x, &m_y[0], this->m_len);
+			else
+				this->m_func.function(x, &m_y[0], this->m_len);
+			return m_y[this->m_len - 1];
+		}
+
+	protected:
+		std::vector<float> m_y;
+	};
+
+
+	/** One update of all the weights of the network. The sign of the gradient
+	alternates so the weights don't diverge however long the benchmark runs. */
+	template <template <typename> class UpdaterT>
+	class UpdaterBench
+	{
+	public:
+		UpdaterBench(Network& network) :
+		m_network(network), m_updater(network),
+		m_gradient(network), m_negGradient(network), m_odd(false)
+		{
+			// the padding of the rows stays zero
+			for (size_t layer = 0; layer < network.getLayersCount(); ++layer) {
+				for (size_t neuron = 0; neuron < network[layer].getNeuronsCount(); ++neuron) {
+					float *grad = m_gradient.getRow(layer, neuron);
+					float *negGrad = m_negGradient.getRow(layer, neuron);
+					for (size_t input = 0; input < network[layer].getInputsCount(); ++input) {
+						grad[input] = 0.01f * randomFloat();
+						negGrad[input] = -grad[input];
+					}
+				}
+			}
+		}
+
+		inline double operator()()
+		{
+			m_odd = !m_odd;
+			m_updater.updateWeights(m_odd ? m_gradient : m_negGradient);
+			return 0;
+		}
+
+	protected:
+		Network& m_network;
+		UpdaterT<Network> m_updater;
+		WeightsBuffer<float> m_gradient;
+		WeightsBuffer<float> m_negGradient;
+		bool m_odd;
+
+	private:
+		UpdaterBench& operator=(const UpdaterBench&);
+	};
+
+
+	/** Gradient of the error function for one pattern (the network is evaluated
+	for the pattern once in advance). */
+	class GradientBench
+	{
+	public:
+		GradientBench(Network& network, const Data& data) :
+		m_evaluator(network), m_pattern(data[0]), m_gradient(network)
+		{
+			network.eval( m_pattern.getInput() );
+		}
+
+		inline double operator()()
+		{
+			m_evaluator.evalGradient( m_pattern.getInput(), m_pattern.getOutput(), m_gradient );
+			return m_gradient.getData()[0];
+		}
+
+	protected:
+		DeltaGradientEvaluator<Network> m_evaluator;
+		const Data::Pair& m_pattern;
+		WeightsBuffer<float> m_gradient;
+
+	private:
+		GradientBench& operator=(const GradientBench&);
+	};
+
+
+	/** Parsing of the data from a text. */
+	class LoadBench
+	{
+	public:
+		LoadBench(size_t inputLen, size_t outputLen, size_t patternsCount) :
+		m_inputLen(inputLen), m_outputLen(outputLen)
+		{
+			std::ostringstream os;
+			for (size_t p = 0; p < patternsCount; ++p) {
+				for (size_t i = 0; i < inputLen + outputLen; ++i)
+					os << randomFloat() << " ";
+				os << "\n";
+			}
+			m_text = os.str();
+		}
+
+		inline double operator()()
+		{
+			Data data(m_inputLen, m_outputLen);
+			std::istringstream is(m_text);
+			data.load(is);
+			return static_cast<double>( data.size() );
+		}
+
+	protected:
+		const size_t m_inputLen;
+		const size_t m_outputLen;
+		std::string m_text;
+	};
+
+
+	/** Pass through all the patterns given by an accessor. */
+	template <typename AccessorT>
+	class AccessorBench
+	{
+	public:
+		AccessorBench(AccessorT& accessor) :
+		m_accessor(accessor)
+		{ }
+
+		inline double operator()()
+		{
+			double sum = 0;
+			for ( m_accessor.begin(); !m_accessor.isEnd(); m_accessor.next() )
+				sum += m_accessor.current().getInput()[0];
+			return sum;
+		}
+
+	protected:
+		AccessorT& m_accessor;
+
+	private:
+		AccessorBench& operator=(const AccessorBench&);
+	};
+
+
+	/** Evaluation of the network for all the patterns. */
+	template <typename NetworkT>
+	class EvalBench
+	{
+	public:
+		EvalBench(NetworkT& network, const Data& data) :
+		m_network(network), m_data(data)
+		{ }
+
+		inline double operator()()
+		{
+			double sum = 0;
+			for (size_t p = 0; p < m_data.size(); ++p)
+				sum += m_network.eval( m_data[p].getInput() )[0];
+			return sum;
+		}
+
+	protected:
+		NetworkT& m_network;
+		const Data& m_data;
+
+	private:
+		EvalBench& operator=(const EvalBench&);
+	};
+
+
+	/** One cycle of the standard back-propagation over all the patterns
+	(optionally with the fused gradient and update). */
+	template <typename NetworkT>
+	class TrainBench
+	{
+	public:
+		typedef BackPropBase<NetworkT, DeltaGradientEvaluator, StandardUpdater> BackProp;
+
+		TrainBench(NetworkT& network, const Data& data, bool fused = false) :
+		m_backProp(network), m_accessor(data)
+		{
+			m_backProp.setLearningRate(0.01f);
+			m_backProp.setFusedUpdate(fused);
+		}
+
+		inline double operator()()
+		{
+			m_backProp.run(m_accessor);
+			return 0;
+		}
+
+	protected:
+		BackProp m_backProp;
+		SequentialAccessor<Data> m_accessor;
+	};
+
+
+	// single groups of benchmarks
+
+	void benchCombinators(BenchmarkRunner& runner)
+	{
+		const size_t LENS[] = { 4, 16, 64, 256, 1024 };
+		for (size_t i = 0; i < sizeof(LENS) / sizeof(LENS[0]); ++i) {
+			CombinatorBench< DotProduct<float> > dot(LENS[i]);
+			runner.run("combinator", "DotProduct", LENS[i], dot, LENS[i]);
+			CombinatorBench< DotProductSSE<float> > dotSSE(LENS[i]);
+			runner.run("combinator", "DotProductSSE", LENS[i], dotSSE, LENS[i]);
+		}
+	}
+
+	/** Scalar and bulk versions of a function and of its derivation. */
+	template <typename FuncT>
+	void benchPiecewiseLinearFunc(BenchmarkRunner& runner, const std::string& name, size_t len)
+	{
+		ActivationBench<FuncT, false> func(len);
+		runner.run("activation", name, len, func, len);
+		ActivationBulkBench<FuncT, false> bulk(len);
+		runner.run("activation", name + "(bulk)", len, bulk, len);
+		ActivationBench<FuncT, true> der(len);
+		runner.run("activation", name + "::valDerivation", len, der, len);
+		ActivationBulkBench<FuncT, true> bulkDer(len);
+		runner.run("activation", name + "::valDerivation(bulk)", len, bulkDer, len);
+	}
+
+	void benchActivationFuncs(BenchmarkRunner& runner)
+	{
+		const size_t LEN = 1024;
+		ActivationBench<SigmoidFunc<float>, false> sigmoid(LEN);
+		runner.run("activation", "SigmoidFunc", LEN, sigmoid, LEN);
+		ActivationBench<SymmetricSigmoidFunc<float>, false> symSigmoid(LEN);
+		runner.run("activation", "SymmetricSigmoidFunc", LEN, symSigmoid, LEN);
+		ActivationBench<TabbedSigmoidFunc<float>, false> tabSigmoid(LEN);
+		runner.run("activation", "TabbedSigmoidFunc", LEN, tabSigmoid, LEN);
+		ActivationBench<HeavisideStepFunc<float>, false> heaviside(LEN);
+		runner.run("activation", "HeavisideStepFunc", LEN, heaviside, LEN);
+
+		ActivationBench<SigmoidFunc<float>, true> sigmoidDer(LEN);
+		runner.run("activation", "SigmoidFunc::valDerivation", LEN, sigmoidDer, LEN);
+		ActivationBench<SymmetricSigmoidFunc<float>, true> symSigmoidDer(LEN);
+		runner.run("activation", "SymmetricSigmoidFunc::valDerivation", LEN, symSigmoidDer, LEN);
+		ActivationBench<TabbedSigmoidFunc<float>, true> tabSigmoidDer(LEN);
+		runner.run("activation", "TabbedSigmoidFunc::valDerivation", LEN, tabSigmoidDer, LEN);
+
+		benchPiecewiseLinearFunc< ReLUFunc<float> >(runner, "ReLUFunc", LEN);
+		benchPiecewiseLinearFunc< LeakyReLUFunc<float> >(runner, "LeakyReLUFunc", LEN);
+		benchPiecewiseLinearFunc< HardSigmoidFunc<float> >(runner, "HardSigmoidFunc", LEN);
+		benchPiecewiseLinearFunc< SymmetricHardSigmoidFunc<float> >(runner, "SymmetricHardSigmoidFunc", LEN);
+	}
+
+	template <template <typename> class UpdaterT>
+	void benchUpdater(BenchmarkRunner& runner, const char* name, Network& network)
+	{
+		if ( !runner.isEnabled("updater", name) )
+			return;
+		UpdaterBench<UpdaterT> bench(network);
+		runner.run( "updater", name, network.getWeightsCount(), bench, network.getWeightsCount() );
+	}
+
+	void benchUpdaters(BenchmarkRunner& runner)
+	{
+		Network network( 64, getLayersSizes(64, 2, 8) );
+		network.initWeightsUniform( Range<float>(-1, 1) );
+
+		benchUpdater<StandardUpdater>(runner, "StandardUpdater", network);
+		benchUpdater<SilvaAlmeidaUpdater>(runner, "SilvaAlmeidaUpdater", network);
+		benchUpdater<DeltaBarDeltaUpdater>(runner, "DeltaBarDeltaUpdater", network);
+		benchUpdater<SuperSABUpdater>(runner, "SuperSABUpdater", network);
+		benchUpdater<QuickpropUpdater>(runner, "QuickpropUpdater", network);
+		benchUpdater<RpropUpdater>(runner, "RpropUpdater", network);
+		benchUpdater<QRpropUpdater>(runner, "QRpropUpdater", network);
+		benchUpdater<AdamUpdater>(runner, "AdamUpdater", network);
+		benchUpdater<AdamWUpdater>(runner, "AdamWUpdater", network);
+		benchUpdater<RMSPropUpdater>(runner, "RMSPropUpdater", network);
+		benchUpdater<AdaGradUpdater>(runner, "AdaGradUpdater", network);
+	}
+
+	void benchGradient(BenchmarkRunner& runner)
+	{
+		const size_t WIDTHS[] = { 8, 32, 128 };
+		for (size_t i = 0; i < sizeof(WIDTHS) / sizeof(WIDTHS[0]); ++i) {
+			if ( !runner.isEnabled("gradient", "DeltaGradientEvaluator") )
+				return;
+			Network network( WIDTHS[i], getLayersSizes(WIDTHS[i], 2, 4) );
+			network.initWeightsUniform( Range<float>(-1, 1) );
+			Data data(WIDTHS[i], 4);
+			fillRandom(data, 1);
+
+			GradientBench bench(network, data);
+			runner.run( "gradient", "DeltaGradientEvaluator", network.getWeightsCount(), bench,
+				network.getWeightsCount() );
+		}
+	}
+
+	void benchData(BenchmarkRunner& runner)
+	{
+		const size_t PATTERNS_COUNT = 1000;
+		if ( runner.isEnabled("data", "InOutData::load") ) {
+			LoadBench load(16, 4, PATTERNS_COUNT);
+			runner.run("data", "InOutData::load", PATTERNS_COUNT, load, PATTERNS_COUNT);
+		}
+
+		Data data(16, 4);
+		fillRandom(data, PATTERNS_COUNT);
+
+		SequentialAccessor<Data> seq(data);
+		AccessorBench< SequentialAccessor<Data> > seqBench(seq);
+		runner.run("data", "SequentialAccessor", PATTERNS_COUNT, seqBench, PATTERNS_COUNT);
+
+		RandomAccessor<Data> rnd(data, PATTERNS_COUNT);
+		AccessorBench< RandomAccessor<Data> > rndBench(rnd);
+		runner.run("data", "RandomAccessor", PATTERNS_COUNT, rndBench, PATTERNS_COUNT);
+
+		IterCycleAccessor<Data> iter(data, 2, 1);
+		AccessorBench< IterCycleAccessor<Data> > iterBench(iter);
+		runner.run("data", "IterCycleAccessor", 2 * PATTERNS_COUNT, iterBench, 2 * PATTERNS_COUNT);
+	}
+
+	/** Patterns per second of the evaluation and the training over a grid
+	of widths and depths of the network. */
+	template <typename NetworkT>
+	void benchEndToEnd(BenchmarkRunner& runner, const std::string& suffix)
+	{
+		const size_t WIDTHS[] = { 8, 32, 128 };
+		const size_t DEPTHS[] = { 1, 2, 4 };
+		const size_t PATTERNS_COUNT = 256;
+		const size_t OUTPUTS_COUNT = 4;
+
+		for (size_t w = 0; w < sizeof(WIDTHS) / sizeof(WIDTHS[0]); ++w)
+			for (size_t d = 0; d < sizeof(DEPTHS) / sizeof(DEPTHS[0]); ++d)
+			{
+				const std::string name = "w" + toString(WIDTHS[w]) + "_d" + toString(DEPTHS[d]) + suffix;
+				if ( !runner.isEnabled("eval", name) && !runner.isEnabled("train", name) &&
+					!runner.isEnabled("train_fused", name) )
+					continue;
+
+				NetworkT network( WIDTHS[w], getLayersSizes(WIDTHS[w], DEPTHS[d], OUTPUTS_COUNT) );
+				network.initWeightsUniform( Range<float>(-1, 1) );
+				Data data(WIDTHS[w], OUTPUTS_COUNT);
+				fillRandom(data, PATTERNS_COUNT);
+
+				EvalBench<NetworkT> eval(network, data);
+				runner.run("eval", name, network.getWeightsCount(), eval, PATTERNS_COUNT);
+				TrainBench<NetworkT> train(network, data);
+				runner.run("train", name, network.getWeightsCount(), train, PATTERNS_COUNT);
+				TrainBench<NetworkT> trainFused(network, data, true);
+				runner.run("train_fused", name, network.getWeightsCount(), trainFused, PATTERNS_COUNT);
+			}
+	}
+
+	/** Get value of an argument of the form --name=value (NULL if it doesn't match). */
+	const char* getArgValue(const char *arg, const char *name)
+	{
+		const size_t len = ::strlen(name);
+		return ( ::strncmp(arg, name, len) == 0 && arg[len] == '=' ) ? arg + len + 1 : NULL;
+	}
+
+}
+
+int main(int argc, char *argv[])
+{
+	bool json = false;
+	double minSeconds = BenchmarkRunner::DEF_MIN_SECONDS;
+	size_t repeats = BenchmarkRunner::DEF_REPEATS;
+	std::string filter;
+	const char *output = NULL;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const char *val;
+		if ( ::strcmp(argv[i], "--json") == 0 )
+			json = true;
+		else if ( (val = getArgValue(argv[i], "--min-time")) != NULL )
+			minSeconds = ::atof(val);
+		else if ( (val = getArgValue(argv[i], "--repeats")) != NULL )
+			repeats = static_cast<size_t>( ::atoi(val) );
+		else if ( (val = getArgValue(argv[i], "--filter")) != NULL )
+			filter = val;
+		else if ( (val = getArgValue(argv[i], "--output")) != NULL )
+			output = val;
+		else {
+			std::cerr << "usage: " << argv[0] << " [--json] [--min-time=SECONDS] [--repeats=COUNT]"
+				" [--filter=TEXT] [--output=FILE]" << std::endl;
+			return 1;
+		}
+	}
+
+	::srand(SEED);
+	BenchmarkRunner runner(minSeconds, repeats, filter);
+
+	benchCombinators(runner);
+	benchActivationFuncs(runner);
+	benchUpdaters(runner);
+	benchGradient(runner);
+	benchData(runner);
+	benchEndToEnd<Network>(runner, "");
+	benchEndToEnd<NetworkSSE>(runner, "_sse");
+
+	std::ofstream file;
+	if (output != NULL)
+		file.open(output);
+	std::ostream& os = (output != NULL) ? file : std::cout;
+	json ? runner.printJSON(os) : runner.printCSV(os);
+
+	return 0;
+}
@@ -1,20 +1,20 @@
-#ifndef _COMBINATOR_BASE_H_
-#define _COMBINATOR_BASE_H_
-
-namespace NNLib
-{
-
-	/**
-	Base template class for every combinator.
-	*/
-	template <typename T>
-	class CombinatorBase
-	{
-	public:
-		typedef T InputType;
-		typedef T OutputType;
-	};
-
-}
-
+#ifndef _COMBINATOR_BASE_H_
+#define _COMBINATOR_BASE_H_
+
+namespace NNLib
+{
+
+	/**
+	Base template class for every combinator.
+	*/
+	template <typename T>
+	class CombinatorBase
+	{
+	public:
+		typedef T InputType;
+		typedef T OutputType;
+	};
+
+}
+
 #endif
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include <xmmintrin.h>
 #include "combinators/combinatorBase.h"
+#include "common/sparseVector.h"
 
 namespace NNLib
 {
@@ -45,7 +46,7 @@ namespace NNLib
 			if ( (len / 4) != 0 )
 			{
 				mres = _mm_load_ss(&z);
-				for (size_t i = 0; i < len; i += 4) {
+				for (size_t i = 0; i < len - len % 4; i += 4) {
 					mres = _mm_add_ps( mres,
 						_mm_mul_ps( _mm_loadu_ps(&x[i]), _mm_loadu_ps(&y[i]) ) );
 				}
@@ -70,6 +71,13 @@ namespace NNLib
 			return sum;
 		}
 
+		/** Combine the sparse vector with the values of y at its indices (the
+		values are scattered so they are summed without SSE). */
+		inline OutputType combine(const SparseVector<InputType>& x, const InputType y[]) const
+		{
+			return x.dot(y);
+		}
+
 		inline OutputType operator()(const InputType x[], const InputType y[], size_t len) const
 		{
 			return combine(x, y, len);
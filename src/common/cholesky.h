@@ -0,0 +1,73 @@
+#ifndef _CHOLESKY_H_
+#define _CHOLESKY_H_
+
+#include <cmath>
+#include <cstddef>
+
+namespace NNLib
+{
+
+	/**
+	Cholesky decomposition A + shift * I = L * L^T of a symmetric positive
+	definite matrix. The matrix A is stored in the upper triangle (including the
+	diagonal) of the row-major n x n array. The factor L is stored to its strict
+	lower triangle and to the given array of the diagonal, so A stays untouched
+	and can be factored again with another shift. Rows of L are computed one by
+	one by dot products of the previous rows (contiguous in memory). Return false
+	if the matrix isn't positive definite.
+	*/
+	template <typename T>
+	bool choleskyFactor(T a[], size_t n, T shift, T diagonal[])
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			T *rowI = a + i * n;
+			for (size_t j = 0; j < i; ++j)
+			{
+				const T *rowJ = a + j * n;
+				T sum = rowJ[i];
+				for (size_t k = 0; k < j; ++k)
+					sum -= rowI[k] * rowJ[k];
+				rowI[j] = sum / diagonal[j];
+			}
+
+			T sum = rowI[i] + shift;
+			for (size_t k = 0; k < i; ++k)
+				sum -= rowI[k] * rowI[k];
+			if ( !(sum > 0) )
+				return false;
+			diagonal[i] = std::sqrt(sum);
+		}
+		return true;
+	}
+
+	/**
+	Solve L * L^T * x = b for the factor computed by choleskyFactor(). The right
+	side is replaced by the solution.
+	*/
+	template <typename T>
+	void choleskySolve(const T a[], size_t n, const T diagonal[], T b[])
+	{
+		// L * y = b
+		for (size_t i = 0; i < n; ++i)
+		{
+			const T *row = a + i * n;
+			T sum = b[i];
+			for (size_t k = 0; k < i; ++k)
+				sum -= row[k] * b[k];
+			b[i] = sum / diagonal[i];
+		}
+
+		// L^T * x = y by rows of L
+		for (size_t i = n; i > 0; --i)
+		{
+			const T *row = a + (i - 1) * n;
+			b[i - 1] /= diagonal[i - 1];
+			for (size_t k = 0; k + 1 < i; ++k)
+				b[k] -= row[k] * b[i - 1];
+		}
+	}
+
+}
+
+#endif
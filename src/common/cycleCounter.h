@@ -0,0 +1,59 @@
+#ifndef _CYCLE_COUNTER_H_
+#define _CYCLE_COUNTER_H_
+
+#include <chrono>
+
+#if defined _MSC_VER
+#	include <intrin.h>
+#	define NNLIB_HAS_RDTSC
+#elif defined __GNUC__ && ( defined __i386__ || defined __x86_64__ )
+#	include <x86intrin.h>
+#	define NNLIB_HAS_RDTSC
+#endif
+
+namespace NNLib
+{
+
+	typedef unsigned long long CycleType;
+
+	/** Read the time stamp counter of the processor (a few cycles). If it isn't
+	available, nanoseconds of a monotonic clock are returned instead. */
+	inline CycleType readCycleCounter()
+	{
+		#ifdef NNLIB_HAS_RDTSC
+			return static_cast<CycleType>( __rdtsc() );
+		#else
+			return static_cast<CycleType>( std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch() ).count() );
+		#endif
+	}
+
+	/** Measure count of cycles of readCycleCounter() per second against
+	a monotonic clock (takes about 20 ms). */
+	inline double measureCyclesPerSecond()
+	{
+		#ifdef NNLIB_HAS_RDTSC
+			typedef std::chrono::steady_clock Clock;
+			const Clock::time_point start = Clock::now();
+			const CycleType startCycles = readCycleCounter();
+			Clock::time_point now;
+			do {
+				now = Clock::now();
+			} while ( now - start < std::chrono::milliseconds(20) );
+			const CycleType cycles = readCycleCounter() - startCycles;
+			return cycles / std::chrono::duration<double>(now - start).count();
+		#else
+			return 1e9;
+		#endif
+	}
+
+	/** Get count of cycles of readCycleCounter() per second (measured once). */
+	inline double getCyclesPerSecond()
+	{
+		static const double s_frequency = measureCyclesPerSecond();
+		return s_frequency;
+	}
+
+}
+
+#endif
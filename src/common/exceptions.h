@@ -1,77 +1,124 @@
-#ifndef _EXCEPTIONS_H_
-#define _EXCEPTIONS_H_
-
-#include <stdexcept>
-#include "common/strings.h"
-
-namespace NNLib
-{
-
-	/**
-	Exception that should be thrown when an index exceeds bounds of an array.
-	*/
-	class IndexOutOfArray :
-		public std::out_of_range
-	{
-	public:
-		IndexOutOfArray(size_t index, size_t size) :
-		std::out_of_range( createMsg(index, size) ),
-		m_index(index), m_size(size)
-		{ }
-
-		inline size_t getIndex() const { return m_index; }
-		inline size_t getArraySize() const { return m_size; }
-
-	protected:
-		size_t m_index;
-		size_t m_size;
-
-		static std::string createMsg(size_t index, size_t size)
-		{
-			return TO_STRING("IndexOutOfArray Exception: index " << index <<
-				" is out of an array's bounds 0.." << size - 1);
-		}
-	};
-
-
-	/**
-	Unexpected null pointer exception.
-	*/
-	class NullPointerException :
-		public std::runtime_error
-	{
-	public:
-		NullPointerException(const std::string& msg) :
-		std::runtime_error( TO_STRING("NullPointerException: " << msg) )
-		{ }
-	};
-
-	/**
-	Layers don't match on each other.
-	*/
-	class NonConsistentLayersException :
-		public std::runtime_error
-	{
-	public:
-		NonConsistentLayersException(size_t outputs, size_t inputs) :
-		std::runtime_error( createMsg(outputs, inputs) ),
-		m_outputs(outputs), m_inputs(inputs)
-		{ }
-
-		inline size_t getOutputs() const { return m_outputs; }
-		inline size_t getInputs() const { return m_inputs; }
-
-	protected:
-		size_t m_outputs;
-		size_t m_inputs;
-
-		static std::string createMsg(size_t outputs, size_t inputs)
-		{
-			return TO_STRING("NonConsistentLayersException: layer with " << outputs <<
-				" outputs can't be connected with a layer with " << inputs << " inputs");
-		}
-	};
-
-}
-
+#ifndef _EXCEPTIONS_H_
+#define _EXCEPTIONS_H_
+
+#include <stdexcept>
+#include "common/strings.h"
+
+namespace NNLib
+{
+
+	/**
+	Exception that should be thrown when an index exceeds bounds of an array.
+	*/
+	class IndexOutOfArray :
+		public std::out_of_range
+	{
+	public:
+		IndexOutOfArray(size_t index, size_t size) :
+		std::out_of_range( createMsg(index, size) ),
+		m_index(index), m_size(size)
+		{ }
+
+		inline size_t getIndex() const { return m_index; }
+		inline size_t getArraySize() const { return m_size; }
+
+	protected:
+		size_t m_index;
+		size_t m_size;
+
+		static std::string createMsg(size_t index, size_t size)
+		{
+			return TO_STRING("IndexOutOfArray Exception: index " << index <<
+				" is out of an array's bounds 0.." << size - 1);
+		}
+	};
+
+
+	/**
+	Unexpected null pointer exception.
+	*/
+	class NullPointerException :
+		public std::runtime_error
+	{
+	public:
+		NullPointerException(const std::string& msg) :
+		std::runtime_error( TO_STRING("NullPointerException: " << msg) )
+		{ }
+	};
+
+	/**
+	Layers don't match on each other.
+	*/
+	class NonConsistentLayersException :
+		public std::runtime_error
+	{
+	public:
+		NonConsistentLayersException(size_t outputs, size_t inputs) :
+		std::runtime_error( createMsg(outputs, inputs) ),
+		m_outputs(outputs), m_inputs(inputs)
+		{ }
+
+		inline size_t getOutputs() const { return m_outputs; }
+		inline size_t getInputs() const { return m_inputs; }
+
+	protected:
+		size_t m_outputs;
+		size_t m_inputs;
+
+		static std::string createMsg(size_t outputs, size_t inputs)
+		{
+			return TO_STRING("NonConsistentLayersException: layer with " << outputs <<
+				" outputs can't be connected with a layer with " << inputs << " inputs");
+		}
+	};
+
+
+	/**
+	Size of a buffer doesn't match the object it should be used with.
+	*/
+	class SizeMismatchException :
+		public std::runtime_error
+	{
+	public:
+		SizeMismatchException(size_t expected, size_t given) :
+		std::runtime_error( createMsg(expected, given) ),
+		m_expected(expected), m_given(given)
+		{ }
+
+		inline size_t getExpected() const { return m_expected; }
+		inline size_t getGiven() const { return m_given; }
+
+	protected:
+		size_t m_expected;
+		size_t m_given;
+
+		static std::string createMsg(size_t expected, size_t given)
+		{
+			return TO_STRING("SizeMismatchException: size " << given <<
+				" was given but " << expected << " was expected");
+		}
+	};
+
+
+	/**
+	All the slots for readers of a shared object are taken.
+	*/
+	class ReadersLimitException :
+		public std::runtime_error
+	{
+	public:
+		ReadersLimitException(size_t limit) :
+		std::runtime_error( TO_STRING("ReadersLimitException: all " << limit <<
+			" slots for readers are taken") ),
+		m_limit(limit)
+		{ }
+
+		inline size_t getLimit() const { return m_limit; }
+
+	protected:
+		size_t m_limit;
+	};
+
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef _MEMORY_H_
+#define _MEMORY_H_
+
+#include <new>
+#include <cstdlib>
+
+#if defined _MSC_VER
+#	include <malloc.h>
+#elif defined __linux__
+#	include <sys/mman.h>
+#endif
+
+namespace NNLib
+{
+
+	/** Size of a cache line. */
+	const size_t CACHE_LINE_SIZE = 64;
+
+	/** Alignment of SIMD vectors (SSE). */
+	const size_t SIMD_ALIGNMENT = 16;
+
+	/** Size of a transparent huge page (of the x86 architectures). */
+	const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+	/** Round the size up to a multiple of the alignment (a power of two). */
+	inline size_t alignSize(size_t size, size_t alignment)
+	{
+		return (size + alignment - 1) & ~(alignment - 1);
+	}
+
+	/** Round the length of an array of the given type up so that the array
+	takes a whole count of SIMD vectors (if the type fits them). */
+	template <typename T>
+	inline size_t getPaddedLength(size_t len)
+	{
+		return (SIMD_ALIGNMENT % sizeof(T) == 0) ?
+			alignSize(len * sizeof(T), SIMD_ALIGNMENT) / sizeof(T) : len;
+	}
+
+	/** Allocate a block of the given size aligned to the given power of two
+	(at least pointer size). Throw std::bad_alloc if it fails. The block has
+	to be freed by freeAligned(). */
+	inline void* allocateAligned(size_t size, size_t alignment)
+	{
+		void *ptr = NULL;
+		#if defined _MSC_VER
+			ptr = ::_aligned_malloc(size, alignment);
+		#else
+			if ( ::posix_memalign(&ptr, alignment, size) != 0 )
+				ptr = NULL;
+		#endif
+		if (ptr == NULL)
+			throw std::bad_alloc();
+		return ptr;
+	}
+
+	inline void freeAligned(void *ptr)
+	{
+		#if defined _MSC_VER
+			::_aligned_free(ptr);
+		#else
+			::free(ptr);
+		#endif
+	}
+
+	/** Allocate a block which can be backed by transparent huge pages - blocks
+	of at least a huge page are aligned to the huge page size and the system
+	is advised to use huge pages for them (where it is supported). Smaller
+	blocks are aligned to the cache line. */
+	inline void* allocateHugePageFriendly(size_t size)
+	{
+		if (size < HUGE_PAGE_SIZE)
+			return allocateAligned( alignSize(size, CACHE_LINE_SIZE), CACHE_LINE_SIZE );
+
+		size = alignSize(size, HUGE_PAGE_SIZE);
+		void *ptr = allocateAligned(size, HUGE_PAGE_SIZE);
+		#if defined __linux__ && defined MADV_HUGEPAGE
+			::madvise(ptr, size, MADV_HUGEPAGE);   // only a hint, a failure doesn't matter
+		#endif
+		return ptr;
+	}
+
+}
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef _PERF_COUNTERS_H_
+#define _PERF_COUNTERS_H_
+
+#if defined __linux__
+#	include <cstring>
+#	include <unistd.h>
+#	include <sys/syscall.h>
+#	include <linux/perf_event.h>
+#	define NNLIB_HAS_PERF_EVENTS
+#endif
+
+namespace NNLib
+{
+
+	/** Hardware events counted by PerfCounters. */
+	enum PerfEvent
+	{
+		PERF_CYCLES,
+		PERF_INSTRUCTIONS,
+		PERF_CACHE_MISSES,
+		PERF_BRANCH_MISSES,
+		PERF_EVENTS_COUNT
+	};
+
+	/** Get name of the given event. */
+	inline const char* getPerfEventName(PerfEvent event)
+	{
+		static const char* NAMES[PERF_EVENTS_COUNT] =
+			{ "cycles", "instructions", "cacheMisses", "branchMisses" };
+		return NAMES[event];
+	}
+
+	typedef unsigned long long PerfValueType;
+
+
+	/** Values of all the events (e.g. a difference of two readings). */
+	struct PerfValues
+	{
+		PerfValueType values[PERF_EVENTS_COUNT];
+
+		PerfValues()
+		{
+			for (size_t event = 0; event < PERF_EVENTS_COUNT; ++event)
+				values[event] = 0;
+		}
+
+		inline PerfValueType operator[](size_t event) const { return values[event]; }
+		inline PerfValueType& operator[](size_t event) { return values[event]; }
+
+		PerfValues& operator+=(const PerfValues& other)
+		{
+			for (size_t event = 0; event < PERF_EVENTS_COUNT; ++event)
+				values[event] += other.values[event];
+			return *this;
+		}
+
+		PerfValues operator-(const PerfValues& other) const
+		{
+			PerfValues diff;
+			for (size_t event = 0; event < PERF_EVENTS_COUNT; ++event)
+				diff.values[event] = values[event] - other.values[event];
+			return diff;
+		}
+	};
+
+
+	/**
+	Hardware performance counters of the calling thread (user space only) read
+	by the Linux perf_event_open interface as one group. Counters which cannot
+	be opened (other systems, no permission, a virtual machine without a PMU)
+	are just not available - reading them gives zeros. The object has to be
+	read by the thread which created it.
+	*/
+	class PerfCounters
+	{
+	public:
+		PerfCounters()
+		{
+			for (size_t event = 0; event < PERF_EVENTS_COUNT; ++event)
+				m_fds[event] = -1;
+			m_openedCount = 0;
+
+			#ifdef NNLIB_HAS_PERF_EVENTS
+				static const unsigned long long CONFIGS[PERF_EVENTS_COUNT] = {
+					PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+					PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+
+				for (size_t event = 0; event < PERF_EVENTS_COUNT; ++event)
+				{
+					perf_event_attr attr;
+					::memset(&attr, 0, sizeof(attr));
+					attr.size = sizeof(attr);
+					attr.type = PERF_TYPE_HARDWARE;
+					attr.config = CONFIGS[event];
+					attr.read_format = PERF_FORMAT_GROUP;
+					attr.exclude_kernel = 1;
+					attr.exclude_hv = 1;
+
+					// the first opened counter leads the group
+					const int leader = (m_openedCount > 0) ? m_fds[ m_order[0] ] : -1;
+					const long fd = ::syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+					if (fd >= 0) {
+						m_fds[event] = static_cast<int>(fd);
+						m_order[m_openedCount++] = event;
+					}
+					else if (event == PERF_CYCLES)
+						break;   // without cycles the other counters are useless
+				}
+			#endif
+		}
+
+		~PerfCounters()
+		{
+			#ifdef NNLIB_HAS_PERF_EVENTS
+				for (size_t event = 0; event < PERF_EVENTS_COUNT; ++event)
+					if (m_fds[event] >= 0)
+						::close(m_fds[event]);
+			#endif
+		}
+
+		/** Check whether at least the cycles are counted. */
+		inline bool isAvailable() const { return m_openedCount > 0; }
+
+		inline bool isAvailable(PerfEvent event) const { return m_fds[event] >= 0; }
+
+		/** Read current values of all the counters (zeros for the not available ones). */
+		void read(PerfValues& values) const
+		{
+			#ifdef NNLIB_HAS_PERF_EVENTS
+				if ( !isAvailable() )
+					return;
+				PerfValueType buffer[PERF_EVENTS_COUNT + 1];
+				const ssize_t size = static_cast<ssize_t>( (m_openedCount + 1) * sizeof(PerfValueType) );
+				if ( ::read(m_fds[ m_order[0] ], buffer, size) != size )
+					return;
+				for (size_t i = 0; i < m_openedCount; ++i)
+					values[ m_order[i] ] = buffer[i + 1];
+			#else
+				(void)values;
+			#endif
+		}
+
+	protected:
+		/** File descriptors of the single events (-1 if not opened). */
+		int m_fds[PERF_EVENTS_COUNT];
+
+		/** Events in the order of opening (which is the order of values read from the group). */
+		size_t m_order[PERF_EVENTS_COUNT];
+		size_t m_openedCount;
+
+	private:
+		PerfCounters(const PerfCounters&);
+		PerfCounters& operator=(const PerfCounters&);
+	};
+
+}
+
+#endif
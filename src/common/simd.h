@@ -0,0 +1,18 @@
+#ifndef _SIMD_H_
+#define _SIMD_H_
+
+// SSE instructions are used where the compiler targets them (always on x86-64)
+#if defined __SSE__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 1)
+#	include <xmmintrin.h>
+#	define NNLIB_HAS_SSE
+#endif
+
+namespace NNLib
+{
+
+	/** Count of floats in one SSE vector. */
+	const size_t SSE_FLOATS = 4;
+
+}
+
+#endif
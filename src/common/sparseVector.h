@@ -0,0 +1,57 @@
+#ifndef _SPARSE_VECTOR_H_
+#define _SPARSE_VECTOR_H_
+
+#include <ostream>
+
+namespace NNLib
+{
+
+	/**
+	Sparse vector - only the non-zero values are stored together with their
+	indices (in an increasing order). The vector doesn't own the arrays.
+	*/
+	template <typename T>
+	struct SparseVector
+	{
+		typedef T ValueType;
+
+		/** Indices of the non-zero values. */
+		const size_t *indices;
+
+		/** The non-zero values. */
+		const ValueType *values;
+
+		/** Count of the non-zero values. */
+		size_t count;
+
+		SparseVector() :
+		indices(NULL), values(NULL), count(0)
+		{ }
+
+		SparseVector(const size_t ind[], const ValueType val[], size_t cnt) :
+		indices(ind), values(val), count(cnt)
+		{ }
+
+		/** Compute dot product with the given dense vector. */
+		inline ValueType dot(const ValueType dense[]) const
+		{
+			ValueType sum = 0;
+			for (size_t k = 0; k < count; ++k)
+				sum += values[k] * dense[ indices[k] ];
+			return sum;
+		}
+	};
+
+
+	/** Print the non-zero values as index:value pairs. */
+	template <typename T>
+	std::ostream& operator<<(std::ostream& os, const SparseVector<T>& vec)
+	{
+		for (size_t k = 0; k < vec.count; ++k)
+			os << vec.indices[k] << ":" << vec.values[k] << " ";
+		return os;
+	}
+
+}
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef _SPSC_QUEUE_H_
+#define _SPSC_QUEUE_H_
+
+#include <new>
+#include <cstddef>
+#include <vector>
+#include <atomic>
+#include <type_traits>
+
+namespace NNLib
+{
+
+	/**
+	Bounded lock-free queue for exactly one producer thread and one consumer
+	thread. Capacity is rounded up to a power of two. Items are copy-constructed
+	in place and destroyed by pop() so the type doesn't have to be default
+	constructible or assignable. Nothing ever blocks - push() fails if the queue
+	is full and front() returns NULL if it is empty.
+	*/
+	template <typename T>
+	class SPSCQueue
+	{
+	public:
+		typedef T ValueType;
+
+		SPSCQueue(size_t capacity) :
+		m_mask( roundCapacity(capacity) - 1 ), m_slots(m_mask + 1), m_head(0), m_tail(0)
+		{ }
+
+		~SPSCQueue()
+		{
+			while ( front() != NULL )
+				pop();
+		}
+
+		/** Add copy of the item to the queue (producer only). Return false if
+		the queue is full and the item wasn't added. */
+		bool push(const ValueType& item)
+		{
+			const size_t tail = m_tail.load(std::memory_order_relaxed);
+			if ( tail - m_head.load(std::memory_order_acquire) > m_mask )
+				return false;
+			new ( &m_slots[tail & m_mask] ) ValueType(item);
+			m_tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		/** Get the oldest item (consumer only) or NULL if the queue is empty. */
+		ValueType* front()
+		{
+			const size_t head = m_head.load(std::memory_order_relaxed);
+			if ( head == m_tail.load(std::memory_order_acquire) )
+				return NULL;
+			return reinterpret_cast<ValueType*>( &m_slots[head & m_mask] );
+		}
+
+		/** Remove the oldest item (consumer only). The queue mustn't be empty. */
+		void pop()
+		{
+			const size_t head = m_head.load(std::memory_order_relaxed);
+			reinterpret_cast<ValueType*>( &m_slots[head & m_mask] )->~ValueType();
+			m_head.store(head + 1, std::memory_order_release);
+		}
+
+		inline size_t getCapacity() const { return m_mask + 1; }
+
+	protected:
+		typedef typename std::aligned_storage<sizeof(ValueType),
+			std::alignment_of<ValueType>::value>::type Slot;
+
+		/** Size of a cache line - head and tail are on separate lines so the
+		producer and the consumer don't invalidate each other's cache. */
+		static const size_t CACHE_LINE = 64;
+
+		const size_t m_mask;
+		std::vector<Slot> m_slots;
+
+		alignas(CACHE_LINE) std::atomic<size_t> m_head;
+		alignas(CACHE_LINE) std::atomic<size_t> m_tail;
+
+		static size_t roundCapacity(size_t capacity)
+		{
+			size_t rounded = 1;
+			while (rounded < capacity)
+				rounded <<= 1;
+			return rounded;
+		}
+
+	private:
+		SPSCQueue(const SPSCQueue&);
+		SPSCQueue& operator=(const SPSCQueue&);
+	};
+
+}
+
+#endif
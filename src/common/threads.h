@@ -0,0 +1,62 @@
+#ifndef _THREADS_H_
+#define _THREADS_H_
+
+#include <vector>
+#include <thread>
+#include <functional>
+
+namespace NNLib
+{
+
+	/** Get count of threads that can run concurrently (at least 1). */
+	inline size_t getHardwareThreadsCount()
+	{
+		const size_t count = std::thread::hardware_concurrency();
+		return (count > 0) ? count : 1;
+	}
+
+	/** Get the begin of the block of the given thread when the range [0, count)
+	is split into the given count of contiguous blocks of similar lengths. */
+	inline size_t getBlockBegin(size_t count, size_t threadsCount, size_t thread)
+	{
+		return (count / threadsCount) * thread + ( (thread < count % threadsCount) ?
+			thread : count % threadsCount );
+	}
+
+	/** Get count of threads that parallelFor() really uses for the given range. */
+	inline size_t getUsedThreadsCount(size_t count, size_t threadsCount)
+	{
+		if (threadsCount == 0)
+			threadsCount = getHardwareThreadsCount();
+		if (threadsCount > count)
+			threadsCount = (count > 0) ? count : 1;
+		return threadsCount;
+	}
+
+	/**
+	Split the range [0, count) into the given count of contiguous blocks and call
+	func(thread, begin, end) for each of them in a separate thread. The calling
+	thread processes the first block and waits for all the others. The function
+	is called concurrently so it has to use only data owned by the given thread.
+	*/
+	template <typename Function>
+	void parallelFor(size_t count, size_t threadsCount, Function& func)
+	{
+		threadsCount = getUsedThreadsCount(count, threadsCount);
+
+		std::vector<std::thread> threads;
+		threads.reserve(threadsCount - 1);
+		for (size_t thread = 1; thread < threadsCount; ++thread)
+			threads.push_back( std::thread( std::ref(func), thread,
+				getBlockBegin(count, threadsCount, thread),
+				getBlockBegin(count, threadsCount, thread + 1) ) );
+
+		func( 0, 0, getBlockBegin(count, threadsCount, 1) );
+
+		for (size_t thread = 0; thread < threads.size(); ++thread)
+			threads[thread].join();
+	}
+
+}
+
+#endif
@@ -0,0 +1,259 @@
+#ifndef _BATCH_DATA_ON_NETWORK_STATS_H_
+#define	_BATCH_DATA_ON_NETWORK_STATS_H_
+
+#include <cmath>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <ostream>
+#include <algorithm>
+#include "backPropagation/accumulator.h"
+#include "feedForward/networkBufferAllocator.h"
+#include "common/threads.h"
+#include "common/utils.h"
+
+namespace NNLib
+{
+
+	/**
+	Aggregate statistics of errors of a network on some data. Statistics computed
+	on separate parts of the data (e.g. in separate threads) can be merged.
+	*/
+	template <typename T>
+	class ErrorStats
+	{
+	public:
+		typedef T ErrorType;
+		typedef T OutputType;
+
+		ErrorStats(size_t outputsCount = 0)
+		{
+			reset(outputsCount);
+		}
+
+		void reset(size_t outputsCount)
+		{
+			m_max.reset();
+			m_min.reset();
+			m_sum.reset();
+			m_mean.reset();
+			m_variance.reset();
+			m_quantiles.reset();
+			m_outputsMean.assign( outputsCount, MeanAccumulator<ErrorType>() );
+			m_outputsMax.assign( outputsCount, MaxAccumulator<ErrorType>() );
+		}
+
+		/** Accumulate the error of a single pattern together with the absolute
+		errors of all the outputs. */
+		inline void accum(ErrorType err, const OutputType real[], const OutputType expected[])
+		{
+			m_max.accum(err);
+			m_min.accum(err);
+			m_sum.accum(err);
+			m_mean.accum(err);
+			m_variance.accum(err);
+			m_quantiles.accum(err);
+
+			for (size_t i = 0; i < getOutputsCount(); ++i) {
+				ErrorType outErr = std::abs( real[i] - expected[i] );
+				m_outputsMean[i].accum(outErr);
+				m_outputsMax[i].accum(outErr);
+			}
+		}
+
+		/** Add statistics computed on another part of the data. */
+		void merge(const ErrorStats& other)
+		{
+			m_max.merge(other.m_max);
+			m_min.merge(other.m_min);
+			m_sum.merge(other.m_sum);
+			m_mean.merge(other.m_mean);
+			m_variance.merge(other.m_variance);
+			m_quantiles.merge(other.m_quantiles);
+
+			for (size_t i = 0; i < getOutputsCount(); ++i) {
+				m_outputsMean[i].merge( other.m_outputsMean[i] );
+				m_outputsMax[i].merge( other.m_outputsMax[i] );
+			}
+		}
+
+		inline size_t getCount() const { return m_variance.getCount(); }
+		inline ErrorType getMax() const { return m_max.getAccumVal(); }
+		inline ErrorType getMin() const { return m_min.getAccumVal(); }
+		inline ErrorType getSum() const { return m_sum.getAccumVal(); }
+		inline ErrorType getMean() const { return m_mean.getAccumVal(); }
+		inline ErrorType getStdDev() const { return m_variance.getStdDev(); }
+
+		/** Get the error which is greater or equal to the given fraction (0..1)
+		of all the errors (with the relative accuracy of the quantile sketch). */
+		inline ErrorType getPercentile(double fraction) const { return m_quantiles.getQuantile(fraction); }
+
+		inline size_t getOutputsCount() const { return m_outputsMean.size(); }
+		inline ErrorType getOutputMean(size_t output) const { return m_outputsMean[output].getAccumVal(); }
+		inline ErrorType getOutputMax(size_t output) const { return m_outputsMax[output].getAccumVal(); }
+
+	protected:
+		MaxAccumulator<ErrorType> m_max;
+		MinAccumulator<ErrorType> m_min;
+		SumAccumulator<ErrorType> m_sum;
+		MeanAccumulator<ErrorType> m_mean;
+		VarianceAccumulator<ErrorType> m_variance;
+		QuantileAccumulator<ErrorType> m_quantiles;
+
+		/** Absolute errors of the single outputs. */
+		std::vector< MeanAccumulator<ErrorType> > m_outputsMean;
+		std::vector< MaxAccumulator<ErrorType> > m_outputsMax;
+	};
+
+
+	/** Print the statistics to the given output stream. */
+	template <typename T>
+	std::ostream& operator<<(std::ostream& os, const ErrorStats<T>& stats)
+	{
+		os << "count=" << stats.getCount() << " max=" << stats.getMax() <<
+			" min=" << stats.getMin() << " sum=" << stats.getSum() <<
+			" mean=" << stats.getMean() << " std=" << stats.getStdDev() << " p50=" << stats.getPercentile(0.5) <<
+			" p90=" << stats.getPercentile(0.9) << " p99=" << stats.getPercentile(0.99) << "\n";
+		for (size_t i = 0; i < stats.getOutputsCount(); ++i)
+			os << "output " << (i + 1) << ": mean=" << stats.getOutputMean(i) <<
+				" max=" << stats.getOutputMax(i) << "\n";
+		return os;
+	}
+
+
+	/**
+	Quiet evaluation of a network on the whole data container. The data are split
+	among more threads, each thread evaluates its part in batches using its own
+	buffers and accumulates its own statistics which are merged at the end.
+	Per-pattern results are written only if a dump stream is set - every thread
+	formats them to its own buffer and the buffers are written in the data order.
+	*/
+	template <typename NetworkT,
+		typename ContT,
+		template <typename> class DistanceT>
+	class BatchDataOnNetworkStats :
+		protected DistanceT<typename NetworkT::OutputType>
+	{
+	public:
+		typedef NetworkT NetworkType;
+		typedef typename NetworkType::InputType InputType;
+		typedef typename NetworkType::OutputType OutputType;
+		typedef typename NetworkType::OutputType ErrorType;
+		typedef ContT ContainerType;
+		typedef typename ContainerType::value_type DataType;
+		typedef ErrorStats<ErrorType> StatsType;
+
+		static const size_t DEF_BATCH_SIZE = 64;
+
+		/** Zero count of threads means to use all the hardware threads. */
+		BatchDataOnNetworkStats(const NetworkType& network, const ContainerType& data,
+			size_t threadsCount = 0, size_t batchSize = DEF_BATCH_SIZE) :
+		m_network(network), m_data(data), m_threadsCount(threadsCount),
+		m_batchSize( (batchSize > 0) ? batchSize : 1 ), m_dump(NULL)
+		{ }
+
+		/** Set stream for per-pattern results (NULL for no per-pattern output). */
+		inline void setDumpStream(std::ostream *os) { m_dump = os; }
+
+		/** Evaluate the network on all the data and return the statistics. */
+		const StatsType& eval()
+		{
+			const size_t threadsCount = getUsedThreadsCount(m_data.size(), m_threadsCount);
+			m_threadsStats.assign( threadsCount, StatsType( m_network.getOutputsCount() ) );
+			m_threadsDumps.assign( threadsCount, std::string() );
+
+			parallelFor(m_data.size(), threadsCount, *this);
+
+			// merge results of the threads in the data order
+			m_stats.reset( m_network.getOutputsCount() );
+			for (size_t thread = 0; thread < threadsCount; ++thread) {
+				m_stats.merge( m_threadsStats[thread] );
+				if (m_dump != NULL)
+					*m_dump << m_threadsDumps[thread];
+			}
+			m_threadsStats.clear();
+			m_threadsDumps.clear();
+
+			return m_stats;
+		}
+
+		inline const StatsType& getStats() const { return m_stats; }
+
+		/** Evaluate patterns [begin, end) in the given thread (used by parallelFor). */
+		void operator()(size_t thread, size_t begin, size_t end)
+		{
+			const size_t inputsCount = m_network.getInputsCount();
+			const size_t outputsCount = m_network.getOutputsCount();
+			StatsType& stats = m_threadsStats[thread];
+			std::ostringstream dump;
+
+			OutputType **buffer = createOutputsBuffer<OutputType>(m_network, m_batchSize);
+			std::vector<InputType> inputs(m_batchSize * inputsCount);
+
+			for (size_t first = begin; first < end; first += m_batchSize)
+			{
+				const size_t count = std::min(m_batchSize, end - first);
+
+				// gather inputs of the batch to a single matrix
+				for (size_t p = 0; p < count; ++p)
+					copyArray( m_data[first + p].getInput(), &inputs[p * inputsCount], inputsCount );
+
+				const OutputType *outputs = m_network.evalBatch(&inputs[0], count, buffer);
+
+				for (size_t p = 0; p < count; ++p, outputs += outputsCount + 1)
+				{
+					const DataType& pattern = m_data[first + p];
+					ErrorType err = this->distance(outputs, pattern.getOutput(), outputsCount);
+					stats.accum(err, outputs, pattern.getOutput());
+
+					if (m_dump != NULL) {
+						print(dump, pattern.getInput(), inputsCount);
+						dump << DELIM;
+						print(dump, pattern.getOutput(), outputsCount);
+						dump << DELIM;
+						print(dump, outputs, outputsCount);
+						dump << DELIM << err << "\n";
+					}
+				}
+			}
+
+			deleteOutputsBuffer(buffer);
+			if (m_dump != NULL)
+				m_threadsDumps[thread] = dump.str();
+		}
+
+	protected:
+		const NetworkType& m_network;
+		const ContainerType& m_data;
+		const size_t m_threadsCount;
+		const size_t m_batchSize;
+
+		/** Stream for per-pattern results (NULL if they shouldn't be written). */
+		std::ostream *m_dump;
+
+		/** Merged statistics of all the threads. */
+		StatsType m_stats;
+
+		// partial results of the single threads
+		std::vector<StatsType> m_threadsStats;
+		std::vector<std::string> m_threadsDumps;
+
+		static const char* DELIM;
+
+		template <typename V>
+		inline void print(std::ostream& os, const V arr[], size_t len) const
+		{
+			for (size_t i = 0; i < len; ++i)
+				os << arr[i] << " ";
+		}
+
+	private:
+		BatchDataOnNetworkStats& operator=(const BatchDataOnNetworkStats&);
+	};
+
+	template <typename N, typename C, template <typename> class D>
+	const char* BatchDataOnNetworkStats<N,C,D>::DELIM = "  ";
+
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef _ERROR_EVALUATOR_H_
 #define	_ERROR_EVALUATOR_H_
 
+#include "common/sparseVector.h"
 #include "backPropagation/accumulator.h"
 
 namespace NNLib
@@ -71,6 +72,12 @@ namespace NNLib
 				os << arr[i] << " ";
 		}
 
+		template <typename T>
+		inline void print(std::ostream& os, const SparseVector<T>& vec, size_t) const
+		{
+			os << vec;
+		}
+
 	private:
 		DataOnNetworkStats& operator=(DataOnNetworkStats&);
 	};
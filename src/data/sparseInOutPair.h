@@ -0,0 +1,79 @@
+#ifndef _SPARSE_IN_OUT_PAIR_H_
+#define _SPARSE_IN_OUT_PAIR_H_
+
+#include "common/utils.h"
+#include "common/sparseVector.h"
+#include "data/inOutData.h"
+
+namespace NNLib
+{
+
+	/**
+	Input and expected output pair with a sparse input vector (for inputs
+	consisting mostly of zeros) and a dense output. It can be stored in
+	InOutData. Networks evaluate the sparse input directly and the first layer
+	of their gradient is evaluated and updated only for the non-zero inputs.
+	The bias input has to be present among the non-zero values as well.
+	*/
+	template <typename T>
+	class SparseInOutPair
+	{
+	public:
+		typedef T InputType;
+		typedef T OutputType;
+		typedef SparseVector<InputType> InputVector;
+		typedef const OutputType* OutputVector;
+
+		SparseInOutPair(InputVector input, OutputVector output) :
+		m_input(input), m_output(output)
+		{ }
+
+		inline const InputVector& getInput() const { return m_input; }
+		inline OutputVector getOutput() const { return m_output; }
+
+		/** Create a copy of the given sparse input. */
+		static InputVector copyInput(const InputVector& input, size_t)
+		{
+			return InputVector( createAndCopyArray(input.indices, input.count),
+				createAndCopyArray(input.values, input.count), input.count );
+		}
+
+		/** Create a sparse input from the given dense one. */
+		static InputVector createInput(const InputType dense[], size_t len)
+		{
+			size_t count = 0;
+			for (size_t i = 0; i < len; ++i)
+				if (dense[i] != 0)
+					++count;
+
+			size_t *indices = new size_t[count];
+			InputType *values = new InputType[count];
+			for (size_t i = 0, k = 0; i < len; ++i) {
+				if (dense[i] != 0) {
+					indices[k] = i;
+					values[k++] = dense[i];
+				}
+			}
+			return InputVector(indices, values, count);
+		}
+
+	private:
+		friend class InOutData< SparseInOutPair<T> >;
+
+		void deleteData()
+		{
+			delete [] m_input.indices;
+			delete [] m_input.values;
+			delete [] m_output;
+		}
+
+		/** Sparse vector of input data. */
+		InputVector m_input;
+
+		/** Vector of output data. */
+		OutputVector m_output;
+	};
+
+}
+
+#endif
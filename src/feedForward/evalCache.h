@@ -0,0 +1,315 @@
+#ifndef _EVAL_CACHE_H_
+#define _EVAL_CACHE_H_
+
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <cstring>
+#include "common/memory.h"
+
+namespace NNLib
+{
+
+	/**
+	Cache of outputs of a network for the inputs evaluated recently (e.g. for
+	repeated inference requests). Inputs are hashed by their bytes and the cache
+	is split to shards, each of them a set-associative table of getWays() slots
+	per set with the least recently used slot replaced. Lookups don't take any
+	lock - every slot is guarded by a sequence counter (seqlock) and a reader
+	only retries another slot if a writer was changing it at the same time.
+	Inserts lock their shard only.
+
+	Every cached output is tagged with the version of the weights of the network
+	(see FeedForwardNetwork::getWeightsVersion()) so all of them are invalid as
+	soon as the weights change and they are replaced first. The cache can be used
+	from more threads at once, but the weights mustn't change during the evals.
+	*/
+	template <typename NetworkT>
+	class EvalCache
+	{
+	public:
+		typedef NetworkT NetworkType;
+		typedef typename NetworkType::InputType InputType;
+		typedef typename NetworkType::OutputType OutputType;
+
+		/** Default count of shards. */
+		static const size_t DEF_SHARDS_COUNT;
+
+		/** Count of slots of one set. */
+		static const size_t WAYS = 4;
+
+		/** Create cache for at least the given count of inputs of the network
+		(the capacity is rounded up to whole sets of all the shards). */
+		EvalCache(const NetworkType& network, size_t capacity, size_t shardsCount = DEF_SHARDS_COUNT) :
+		m_network(network),
+		m_inputsCount( network.getInputsCount() ), m_outputsCount( network.getOutputsCount() ),
+		m_shardsCount( std::max<size_t>(shardsCount, 1) ),
+		m_setsCount( std::max<size_t>( (capacity + m_shardsCount * WAYS - 1) / (m_shardsCount * WAYS), 1 ) )
+		{
+			const size_t slotsCount = m_setsCount * WAYS;
+			m_shards = new Shard[m_shardsCount];
+			for (size_t i = 0; i < m_shardsCount; ++i) {
+				Shard& shard = m_shards[i];
+				shard.slots = new Slot[slotsCount];
+				shard.inputs.resize(slotsCount * m_inputsCount);
+				shard.outputs.resize(slotsCount * m_outputsCount);
+			}
+		}
+
+		~EvalCache()
+		{
+			for (size_t i = 0; i < m_shardsCount; ++i)
+				delete [] m_shards[i].slots;
+			delete [] m_shards;
+		}
+
+		/** Copy the outputs (getOutputsCount() values) of the given input to the
+		given array. The network is evaluated with the given buffer created by
+		createOutputsBuffer() only if they aren't cached, so more threads can
+		eval at once, each one with its own buffer. Return whether it was a hit. */
+		bool eval(const InputType input[], OutputType output[], OutputType **buffer)
+		{
+			const size_t version = m_network.getWeightsVersion();
+			const size_t hash = hashInput(input);
+			if ( find(input, hash, version, output) )
+				return true;
+
+			const OutputType *realOutput = m_network.eval(input, buffer);
+			std::copy(realOutput, realOutput + m_outputsCount, output);
+			insert(input, hash, version, output);
+			return false;
+		}
+
+		/** Eval a batch of inputs stored in rows one after another and store the
+		outputs in rows of getOutputsCount() values. Only the inputs which aren't
+		cached are evaluated by FeedForwardNetwork::evalBatch() with the given
+		buffer (created for at least the given count of patterns). Return count
+		of the hits. */
+		size_t evalBatch(const InputType inputs[], size_t count, OutputType outputs[], OutputType **buffer)
+		{
+			const size_t version = m_network.getWeightsVersion();
+			std::vector<size_t> missed, hashes;
+			std::vector<InputType> missedInputs;
+
+			for (size_t p = 0; p < count; ++p)
+			{
+				const InputType *input = inputs + p * m_inputsCount;
+				const size_t hash = hashInput(input);
+				if ( !find(input, hash, version, outputs + p * m_outputsCount) ) {
+					missed.push_back(p);
+					hashes.push_back(hash);
+					missedInputs.insert(missedInputs.end(), input, input + m_inputsCount);
+				}
+			}
+
+			if ( !missed.empty() )
+			{
+				// eval the missed inputs at once, rows of outputs include the bias
+				const OutputType *realOutputs = m_network.evalBatch(&missedInputs[0], missed.size(), buffer);
+				for (size_t i = 0; i < missed.size(); ++i) {
+					const OutputType *realOutput = realOutputs + i * (m_outputsCount + 1);
+					std::copy( realOutput, realOutput + m_outputsCount, outputs + missed[i] * m_outputsCount );
+					insert(&missedInputs[i * m_inputsCount], hashes[i], version, realOutput);
+				}
+			}
+
+			return count - missed.size();
+		}
+
+		/** Copy the cached outputs of the given input to the given array. Return
+		false if they aren't cached for the current weights. */
+		inline bool find(const InputType input[], OutputType output[])
+		{
+			return find( input, hashInput(input), m_network.getWeightsVersion(), output );
+		}
+
+		/** Cache the given outputs of the given input for the current weights. */
+		inline void insert(const InputType input[], const OutputType output[])
+		{
+			insert( input, hashInput(input), m_network.getWeightsVersion(), output );
+		}
+
+		/** Remove all the cached outputs. */
+		void clear()
+		{
+			for (size_t i = 0; i < m_shardsCount; ++i)
+			{
+				Shard& shard = m_shards[i];
+				std::lock_guard<std::mutex> lock(shard.mutex);
+				for (size_t slot = 0; slot < m_setsCount * WAYS; ++slot) {
+					beginWrite(shard.slots[slot]);
+					shard.slots[slot].version.store(INVALID_VERSION, std::memory_order_relaxed);
+					endWrite(shard.slots[slot]);
+				}
+			}
+		}
+
+		inline size_t getCapacity() const { return m_shardsCount * m_setsCount * WAYS; }
+		inline size_t getShardsCount() const { return m_shardsCount; }
+		inline size_t getWays() const { return WAYS; }
+
+		size_t getHitsCount() const
+		{
+			size_t hits = 0;
+			for (size_t i = 0; i < m_shardsCount; ++i)
+				hits += m_shards[i].hits.load(std::memory_order_relaxed);
+			return hits;
+		}
+
+		size_t getMissesCount() const
+		{
+			size_t misses = 0;
+			for (size_t i = 0; i < m_shardsCount; ++i)
+				misses += m_shards[i].misses.load(std::memory_order_relaxed);
+			return misses;
+		}
+
+	protected:
+		/** Version of a slot without any valid outputs. */
+		static const size_t INVALID_VERSION = ~size_t(0);
+
+		/** Slot of the cache (its input and outputs are stored in the shard). */
+		struct Slot
+		{
+			/** Sequence counter - odd while the slot is being written. */
+			std::atomic<size_t> seq;
+			std::atomic<size_t> hash;
+			std::atomic<size_t> version;
+
+			/** Time of the last access (for the replacement). */
+			std::atomic<size_t> stamp;
+
+			Slot() :
+			seq(0), hash(0), version(INVALID_VERSION), stamp(0)
+			{ }
+		};
+
+		/** Shard of the cache - each one on its own cache lines. */
+		struct alignas(CACHE_LINE_SIZE) Shard
+		{
+			Slot *slots;
+			std::vector<InputType> inputs;
+			std::vector<OutputType> outputs;
+
+			/** Lock of the writers. */
+			std::mutex mutex;
+
+			/** Clock for the stamps of the slots. */
+			std::atomic<size_t> clock;
+
+			std::atomic<size_t> hits, misses;
+
+			Shard() :
+			slots(NULL), clock(0), hits(0), misses(0)
+			{ }
+		};
+
+		const NetworkType& m_network;
+		const size_t m_inputsCount, m_outputsCount;
+		const size_t m_shardsCount, m_setsCount;
+		Shard *m_shards;
+
+		/** Hash bytes of the input (FNV-1a). */
+		inline size_t hashInput(const InputType input[]) const
+		{
+			const unsigned char *bytes = reinterpret_cast<const unsigned char*>(input);
+			const size_t len = m_inputsCount * sizeof(InputType);
+			unsigned long long hash = 14695981039346656037ULL;
+			for (size_t i = 0; i < len; ++i)
+				hash = (hash ^ bytes[i]) * 1099511628211ULL;
+			return static_cast<size_t>(hash ^ (hash >> 32));
+		}
+
+		inline Shard& getShard(size_t hash) const { return m_shards[hash % m_shardsCount]; }
+		inline size_t getFirstSlot(size_t hash) const { return ( (hash / m_shardsCount) % m_setsCount ) * WAYS; }
+
+		bool find(const InputType input[], size_t hash, size_t version, OutputType output[])
+		{
+			Shard& shard = getShard(hash);
+			const size_t first = getFirstSlot(hash);
+
+			for (size_t way = first; way < first + WAYS; ++way)
+			{
+				Slot& slot = shard.slots[way];
+				const size_t seq = slot.seq.load(std::memory_order_acquire);
+				if ( (seq & 1) != 0 || slot.hash.load(std::memory_order_relaxed) != hash ||
+					slot.version.load(std::memory_order_relaxed) != version )
+					continue;
+				if ( std::memcmp( &shard.inputs[way * m_inputsCount], input, m_inputsCount * sizeof(InputType) ) != 0 )
+					continue;
+				std::memcpy( output, &shard.outputs[way * m_outputsCount], m_outputsCount * sizeof(OutputType) );
+
+				// the copy is valid only if no writer changed the slot meanwhile
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if ( slot.seq.load(std::memory_order_relaxed) != seq )
+					continue;
+
+				slot.stamp.store( shard.clock.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed );
+				shard.hits.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+
+			shard.misses.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		void insert(const InputType input[], size_t hash, size_t version, const OutputType output[])
+		{
+			Shard& shard = getShard(hash);
+			const size_t first = getFirstSlot(hash);
+			std::lock_guard<std::mutex> lock(shard.mutex);
+
+			// replace a slot of the outputs of an older version or the least recently used one
+			size_t victim = first;
+			for (size_t way = first; way < first + WAYS; ++way)
+			{
+				const Slot& slot = shard.slots[way];
+				if ( slot.version.load(std::memory_order_relaxed) != version ) {
+					victim = way;
+					break;
+				}
+				if ( slot.stamp.load(std::memory_order_relaxed) < shard.slots[victim].stamp.load(std::memory_order_relaxed) )
+					victim = way;
+			}
+
+			Slot& slot = shard.slots[victim];
+			beginWrite(slot);
+			std::memcpy( &shard.inputs[victim * m_inputsCount], input, m_inputsCount * sizeof(InputType) );
+			std::memcpy( &shard.outputs[victim * m_outputsCount], output, m_outputsCount * sizeof(OutputType) );
+			slot.hash.store(hash, std::memory_order_relaxed);
+			slot.version.store(version, std::memory_order_relaxed);
+			slot.stamp.store( shard.clock.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed );
+			endWrite(slot);
+		}
+
+		/** Make the sequence counter of the slot odd before its data are written. */
+		static inline void beginWrite(Slot& slot)
+		{
+			slot.seq.store( slot.seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed );
+			std::atomic_thread_fence(std::memory_order_release);
+		}
+
+		/** Make the sequence counter of the slot even after its data were written. */
+		static inline void endWrite(Slot& slot)
+		{
+			slot.seq.store( slot.seq.load(std::memory_order_relaxed) + 1, std::memory_order_release );
+		}
+
+	private:
+		EvalCache(const EvalCache&);
+		EvalCache& operator=(const EvalCache&);
+	};
+
+	template <typename NetworkT>
+	const size_t EvalCache<NetworkT>::DEF_SHARDS_COUNT = 16;
+
+	template <typename NetworkT>
+	const size_t EvalCache<NetworkT>::WAYS;
+
+	template <typename NetworkT>
+	const size_t EvalCache<NetworkT>::INVALID_VERSION;
+
+}
+
+#endif
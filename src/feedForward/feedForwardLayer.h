@@ -1,168 +1,304 @@
-#ifndef _FEED_FORWARD_LAYER_
-#define _FEED_FORWARD_LAYER_
-
-#include <ostream>
-#include "common/exceptions.h"
-#include "common/utils.h"
-#include "initializers/initializer.h"
-
-namespace NNLib
-{
-
-	/**
-	This class represents a sigle layer of a feed-forward neural network.
-	*/
-	template <typename NeuronT>
-	class FeedForwardLayer
-	{
-	public:
-		typedef NeuronT NeuronType;
-		typedef NeuronType *NeuronPtr;
-		typedef typename NeuronType::InputType InputType;
-		typedef typename NeuronType::OutputType OutputType;
-		typedef typename NeuronType::WeightType WeightType;
-
-		FeedForwardLayer(size_t neuronsCount, size_t inputsCount)
-		{
-			create(neuronsCount, inputsCount);
-		}
-
-		~FeedForwardLayer()
-		{
-			destroy();
-		}
-
-		const OutputType* eval(const InputType input[])
-		{
-			for (size_t i = 0; i < m_neuronsCount; ++i)
-				m_outputsCache[i] = m_neurons[i]->eval(input);
-			return m_outputsCache;
-		}
-
-		void initWeights(const Initializer<WeightType>& initializer)
-		{
-			for (size_t i = 0; i < m_neuronsCount; ++i)
-				initializer(m_neurons[i]->getWeights(), m_inputsCount);
-		}
-
-		/** Get neuron with range checking and not NULL checking. */
-		const NeuronType& getNeuron(size_t index) const
-		{
-			if (index < 0 || index >= m_neuronsCount)
-				throw IndexOutOfArray(index, m_neuronsCount);
-			if (m_neurons[index] == NULL)
-				throw NullPointerException("pointer to NULL couldn't be dereferenced");
-			return (*this)[index];
-		}
-
-		/** Perform the given function on every input weight of this layer. */
-		template <typename Function>
-		inline void forEachWeightForward(Function& func)
-		{
-			for (size_t neuron = 0; neuron < m_neuronsCount; ++neuron)
-				for (size_t input = 0; input < m_inputsCount; ++input)
-					func( (*this)[neuron][input] );
-		}
-
-		/** Perform the given function on every neuron of this layer. */
-		template <typename Function>
-		inline void forEachNeuronForward(Function& func)
-		{
-			for (size_t neuron = 0; neuron < m_neuronsCount; ++neuron)
-				func( (*this)[neuron] );
-		}
-
-		// methods without range checkin and not NULL checking
-		inline const NeuronType& operator[](size_t index) const { return *m_neurons[index]; }
-		inline NeuronType& operator[](size_t index) { return *m_neurons[index]; }
-
-		inline size_t getNeuronsCount() const { return m_neuronsCount; }
-		inline size_t getInputsCount() const { return m_inputsCount; }
-		inline size_t getOutputsCount() const { return m_neuronsCount + 1; }
-		inline size_t getWeightsCount() const { return getNeuronsCount() * getInputsCount(); }
-
-		inline const FeedForwardLayer* getPrevLayer() const { return m_prev; }
-
-		inline const FeedForwardLayer* setPrevLayer(const FeedForwardLayer *prev)
-		{
-			const FeedForwardLayer *old = m_prev;
-			if ( (prev != NULL) && (prev->getOutputsCount() != getInputsCount()) )
-				throw NonConsistentLayersException( prev->getOutputsCount(), getInputsCount() );
-			m_prev = prev;
-			return old;
-		}
-
-		inline const FeedForwardLayer* getNextLayer() const { return m_next; }
-
-		inline const FeedForwardLayer* setNextLayer(const FeedForwardLayer *next)
-		{
-			const FeedForwardLayer *old = m_next;
-			if ( (next != NULL) && (next->getInputsCount() != getOutputsCount()) )
-				throw NonConsistentLayersException( getOutputsCount(), next->getInputsCount() );
-			m_next = next;
-			return old;
-		}
-
-		inline bool isInputLayer() const { return m_prev == NULL; }
-		inline bool isOutputLayer() const { return m_next == NULL; }
-		inline bool isHiddenLayer() const { return !isInputLayer() && !isOutputLayer(); }
-
-		inline const OutputType* getOutputCache() const { return m_outputsCache; }
-
-	protected:
-		/** Count of neurons in this layer. */
-		size_t m_neuronsCount;
-
-		/** Count of inputs for each neuron in this layer. */
-		size_t m_inputsCount;
-
-		/** List of all neurons in this layer. */
-		NeuronPtr *m_neurons;
-
-		/** Input for this layer. */
-		OutputType *m_outputsCache;
-
-		/** Pointer to the previous layer (NULL for the first layer). */
-		const FeedForwardLayer *m_prev;
-
-		/** Pointer to the previous layer (NULL for the last layer). */
-		const FeedForwardLayer *m_next;
-
-	protected:
-		void create(size_t neuronsCount, size_t inputsCount)
-		{
-			m_neuronsCount = neuronsCount;
-			m_inputsCount = inputsCount;
-
-			m_neurons = new NeuronPtr[m_neuronsCount];
-			for (size_t i = 0; i < m_neuronsCount; ++i)
-				m_neurons[i] = new NeuronType(inputsCount);
-
-			m_outputsCache = new OutputType[m_neuronsCount + 1];
-			m_outputsCache[m_neuronsCount] = 1;  // the last output is always 1
-			// and it repesents a bias input for the next layer
-
-			m_prev = m_next = NULL;
-		}
-
-		void destroy()
-		{
-			deleteRange(m_neurons, m_neurons + m_neuronsCount);
-			delete [] m_neurons;
-			delete [] m_outputsCache;
-		}
-	};
-	
-	
-	/** Print neurons of the layer to the given output stream. */
-	template <typename NeuronT>
-	std::ostream& operator<<(std::ostream& os, const FeedForwardLayer<NeuronT>& layer)
-	{
-		for (size_t neuron = 0; neuron < layer.getNeuronsCount(); ++neuron)
-			os << (neuron + 1) << ": " << layer[neuron] << "\n";
-		return os;
-	}
-
-}
-
+#ifndef _FEED_FORWARD_LAYER_
+#define _FEED_FORWARD_LAYER_
+
+#include <new>
+#include <ostream>
+#include <algorithm>
+#include "common/exceptions.h"
+#include "common/utils.h"
+#include "common/memory.h"
+#include "common/sparseVector.h"
+#include "initializers/initializer.h"
+
+namespace NNLib
+{
+
+	/**
+	This class represents a sigle layer of a feed-forward neural network.
+	Weights of all its neurons are stored in one block, every neuron in a row
+	padded with zeros to a whole count of SIMD vectors (getWeightsStride()).
+	A frozen layer is evaluated as usual but its weights aren't trained.
+	*/
+	template <typename NeuronT>
+	class FeedForwardLayer
+	{
+	public:
+		typedef NeuronT NeuronType;
+		typedef NeuronType *NeuronPtr;
+		typedef typename NeuronType::InputType InputType;
+		typedef typename NeuronType::OutputType OutputType;
+		typedef typename NeuronType::WeightType WeightType;
+
+		FeedForwardLayer(size_t neuronsCount, size_t inputsCount)
+		{
+			create(neuronsCount, inputsCount);
+		}
+
+		/** Constructor of a layer placed in the given external memory (e.g. an
+		arena of the whole network) - an array for pointers to the neurons,
+		uninitialized memory for the neurons themselves, weights block of
+		getWeightsBlockSize() values and the outputs cache (including the bias
+		output). Nothing of it is deleted by the layer. */
+		FeedForwardLayer(size_t neuronsCount, size_t inputsCount, NeuronPtr *neuronPtrs,
+			void *neurons, WeightType *weights, OutputType *outputsCache)
+		{
+			create(neuronsCount, inputsCount, neuronPtrs, neurons, weights, outputsCache);
+		}
+
+		~FeedForwardLayer()
+		{
+			destroy();
+		}
+
+		const OutputType* eval(const InputType input[])
+		{
+			for (size_t i = 0; i < m_neuronsCount; ++i)
+				m_outputsCache[i] = m_neurons[i]->eval(input);
+			return m_outputsCache;
+		}
+
+		/** Eval the layer for the given sparse input. Only the weights of the
+		non-zero inputs are read so the cost is proportional to their count (the
+		bias input has to be among them). */
+		const OutputType* eval(const SparseVector<InputType>& input)
+		{
+			for (size_t i = 0; i < m_neuronsCount; ++i)
+				m_outputsCache[i] = m_neurons[i]->eval(input);
+			return m_outputsCache;
+		}
+
+		/** Eval the layer for the given input and store its outputs (including
+		the bias output) to the given array instead of the cache. */
+		const OutputType* eval(const InputType input[], OutputType output[]) const
+		{
+			for (size_t i = 0; i < m_neuronsCount; ++i)
+				output[i] = m_neurons[i]->eval(input);
+			output[m_neuronsCount] = 1;
+			return output;
+		}
+
+		/** Eval the layer for a batch of inputs stored in rows of the given length
+		one after another. Outputs are stored in rows of getOutputsCount() values.
+		Each neuron is evaluated for the whole batch at once so its weights stay
+		in the cache. */
+		const OutputType* evalBatch(const InputType inputs[], size_t count, OutputType outputs[]) const
+		{
+			const size_t outputsCount = getOutputsCount();
+			for (size_t i = 0; i < m_neuronsCount; ++i)
+			{
+				const NeuronType& neuron = *m_neurons[i];
+				const InputType *input = inputs;
+				OutputType *output = outputs + i;
+				for (size_t p = 0; p < count; ++p, input += m_inputsCount, output += outputsCount)
+					*output = neuron.eval(input);
+			}
+
+			for (size_t p = 0; p < count; ++p)
+				outputs[p * outputsCount + m_neuronsCount] = 1;
+			return outputs;
+		}
+
+		void initWeights(const Initializer<WeightType>& initializer)
+		{
+			for (size_t i = 0; i < m_neuronsCount; ++i)
+				initializer(m_neurons[i]->getWeights(), m_inputsCount);
+		}
+
+		/** Get neuron with range checking and not NULL checking. */
+		const NeuronType& getNeuron(size_t index) const
+		{
+			if (index < 0 || index >= m_neuronsCount)
+				throw IndexOutOfArray(index, m_neuronsCount);
+			if (m_neurons[index] == NULL)
+				throw NullPointerException("pointer to NULL couldn't be dereferenced");
+			return (*this)[index];
+		}
+
+		/** Perform the given function on every input weight of this layer. */
+		template <typename Function>
+		inline void forEachWeightForward(Function& func)
+		{
+			for (size_t neuron = 0; neuron < m_neuronsCount; ++neuron)
+				for (size_t input = 0; input < m_inputsCount; ++input)
+					func( (*this)[neuron][input] );
+		}
+
+		/** Perform the given function on every neuron of this layer. */
+		template <typename Function>
+		inline void forEachNeuronForward(Function& func)
+		{
+			for (size_t neuron = 0; neuron < m_neuronsCount; ++neuron)
+				func( (*this)[neuron] );
+		}
+
+		// methods without range checkin and not NULL checking
+		inline const NeuronType& operator[](size_t index) const { return *m_neurons[index]; }
+		inline NeuronType& operator[](size_t index) { return *m_neurons[index]; }
+
+		inline size_t getNeuronsCount() const { return m_neuronsCount; }
+		inline size_t getInputsCount() const { return m_inputsCount; }
+		inline size_t getOutputsCount() const { return m_neuronsCount + 1; }
+		inline size_t getWeightsCount() const { return getNeuronsCount() * getInputsCount(); }
+
+		/** Get count of values between weights of two neighbouring neurons. */
+		inline size_t getWeightsStride() const { return m_weightsStride; }
+
+		/** Get count of values of the block of weights (including the padding). */
+		inline size_t getWeightsBlockSize() const { return getNeuronsCount() * getWeightsStride(); }
+
+		/** Get the block of weights of all the neurons. */
+		inline const WeightType* getWeights() const { return m_weights; }
+		inline WeightType* getWeights() { return m_weights; }
+
+		/** Get stride of weights of a layer with the given count of inputs. */
+		static inline size_t getWeightsStride(size_t inputsCount)
+		{
+			return getPaddedLength<WeightType>(inputsCount);
+		}
+
+		inline const FeedForwardLayer* getPrevLayer() const { return m_prev; }
+
+		inline const FeedForwardLayer* setPrevLayer(const FeedForwardLayer *prev)
+		{
+			const FeedForwardLayer *old = m_prev;
+			if ( (prev != NULL) && (prev->getOutputsCount() != getInputsCount()) )
+				throw NonConsistentLayersException( prev->getOutputsCount(), getInputsCount() );
+			m_prev = prev;
+			return old;
+		}
+
+		inline const FeedForwardLayer* getNextLayer() const { return m_next; }
+
+		inline const FeedForwardLayer* setNextLayer(const FeedForwardLayer *next)
+		{
+			const FeedForwardLayer *old = m_next;
+			if ( (next != NULL) && (next->getInputsCount() != getOutputsCount()) )
+				throw NonConsistentLayersException( getOutputsCount(), next->getInputsCount() );
+			m_next = next;
+			return old;
+		}
+
+		inline bool isInputLayer() const { return m_prev == NULL; }
+		inline bool isOutputLayer() const { return m_next == NULL; }
+		inline bool isHiddenLayer() const { return !isInputLayer() && !isOutputLayer(); }
+
+		inline const OutputType* getOutputCache() const { return m_outputsCache; }
+
+		/** Set the cached outputs (without the bias one) to the given values, e.g.
+		to the outputs of the same input saved earlier. */
+		inline void restoreOutputCache(const OutputType outputs[])
+		{
+			std::copy(outputs, outputs + m_neuronsCount, m_outputsCache);
+		}
+
+		/** Frozen layer is skipped by the gradient evaluators and updaters. */
+		inline bool isFrozen() const { return m_frozen; }
+		inline void setFrozen(bool frozen) { m_frozen = frozen; }
+
+	protected:
+		/** Count of neurons in this layer. */
+		size_t m_neuronsCount;
+
+		/** Count of inputs for each neuron in this layer. */
+		size_t m_inputsCount;
+
+		/** List of all neurons in this layer. */
+		NeuronPtr *m_neurons;
+
+		/** Block of weights of all the neurons in padded rows. */
+		WeightType *m_weights;
+		size_t m_weightsStride;
+
+		/** Input for this layer. */
+		OutputType *m_outputsCache;
+
+		/** Pointer to the previous layer (NULL for the first layer). */
+		const FeedForwardLayer *m_prev;
+
+		/** Pointer to the previous layer (NULL for the last layer). */
+		const FeedForwardLayer *m_next;
+
+		/** Whether the neurons, weights and cache are placed in an external memory. */
+		bool m_external;
+
+		/** Whether the weights of the layer are excluded from training. */
+		bool m_frozen;
+
+	protected:
+		void create(size_t neuronsCount, size_t inputsCount)
+		{
+			m_neuronsCount = neuronsCount;
+			m_inputsCount = inputsCount;
+
+			m_weightsStride = getWeightsStride(inputsCount);
+			m_weights = static_cast<WeightType*>( allocateAligned(
+				std::max<size_t>(getWeightsBlockSize(), 1) * sizeof(WeightType), CACHE_LINE_SIZE ) );
+			std::fill( m_weights, m_weights + getWeightsBlockSize(), WeightType() );
+
+			m_neurons = new NeuronPtr[m_neuronsCount];
+			for (size_t i = 0; i < m_neuronsCount; ++i)
+				m_neurons[i] = new NeuronType(inputsCount, m_weights + i * m_weightsStride);
+
+			m_outputsCache = new OutputType[m_neuronsCount + 1];
+			m_outputsCache[m_neuronsCount] = 1;  // the last output is always 1
+			// and it repesents a bias input for the next layer
+
+			m_prev = m_next = NULL;
+			m_external = false;
+			m_frozen = false;
+		}
+
+		void create(size_t neuronsCount, size_t inputsCount, NeuronPtr *neuronPtrs,
+			void *neurons, WeightType *weights, OutputType *outputsCache)
+		{
+			m_neuronsCount = neuronsCount;
+			m_inputsCount = inputsCount;
+
+			m_weightsStride = getWeightsStride(inputsCount);
+			m_weights = weights;
+			std::fill( m_weights, m_weights + getWeightsBlockSize(), WeightType() );
+
+			m_neurons = neuronPtrs;
+			NeuronType *neuronsArr = static_cast<NeuronType*>(neurons);
+			for (size_t i = 0; i < m_neuronsCount; ++i)
+				m_neurons[i] = new (neuronsArr + i) NeuronType(inputsCount, m_weights + i * m_weightsStride);
+
+			m_outputsCache = outputsCache;
+			m_outputsCache[m_neuronsCount] = 1;
+
+			m_prev = m_next = NULL;
+			m_external = true;
+			m_frozen = false;
+		}
+
+		void destroy()
+		{
+			if (m_external) {
+				for (size_t i = 0; i < m_neuronsCount; ++i)
+					m_neurons[i]->~NeuronType();
+				return;
+			}
+			deleteRange(m_neurons, m_neurons + m_neuronsCount);
+			delete [] m_neurons;
+			delete [] m_outputsCache;
+			freeAligned(m_weights);
+		}
+
+	private:
+		FeedForwardLayer(const FeedForwardLayer&);
+		FeedForwardLayer& operator=(const FeedForwardLayer&);
+	};
+	
+	
+	/** Print neurons of the layer to the given output stream. */
+	template <typename NeuronT>
+	std::ostream& operator<<(std::ostream& os, const FeedForwardLayer<NeuronT>& layer)
+	{
+		for (size_t neuron = 0; neuron < layer.getNeuronsCount(); ++neuron)
+			os << (neuron + 1) << ": " << layer[neuron] << "\n";
+		return os;
+	}
+
+}
+
 #endif
\ No newline at end of file
@@ -1,172 +1,480 @@
-#ifndef _FEED_FORWARD_NETWORK_
-#define _FEED_FORWARD_NETWORK_
-
-#include <vector>
-#include "common/exceptions.h"
-#include "common/utils.h"
-#include "common/random.h"
-#include "initializers/randomInitializer.h"
-
-namespace NNLib
-{
-
-	/**
-	This class represents a whole feed-forward neural network.
-	*/
-	template <typename LayerT>
-	class FeedForwardNetwork
-	{
-	public:
-		typedef LayerT LayerType;
-		typedef LayerType *LayerPtr;
-		typedef typename LayerType::NeuronType NeuronType;
-		typedef typename LayerType::InputType InputType;
-		typedef typename LayerType::OutputType OutputType;
-		typedef typename NeuronType::WeightType WeightType;
-		typedef typename std::vector<LayerPtr> LayersList;
-		typedef std::vector<size_t> LayersSizes;
-
-		FeedForwardNetwork()
-		{ }
-
-		FeedForwardNetwork(size_t inputsCount, const LayersSizes& sizes)
-		{
-			create(inputsCount, sizes);
-		}
-
-		~FeedForwardNetwork()
-		{
-			destroy();
-		}
-
-		const OutputType* eval(const InputType inputs[])
-		{
-			typename LayersList::iterator end = m_layers.end();
-			for (typename LayersList::iterator it = m_layers.begin(); it != end; ++it)
-				inputs = (*it)->eval(inputs);
-			return inputs;
-		}
-
-		void initWeights(const Initializer<WeightType>& initializer)
-		{
-			typename LayersList::iterator end = m_layers.end();
-			for (typename LayersList::iterator it = m_layers.begin(); it != end; ++it)
-				(*it)->initWeights(initializer);
-		}
-
-		void initWeightsUniform(const Range<WeightType>& weightsRange)
-		{
-			RandomUniform<WeightType> random(weightsRange);
-			RandomInitializer<WeightType> init(random);
-			initWeights(init);
-		}
-
-		void pushLayer(LayerType *layer)
-		{
-			if (layer == NULL)
-				throw NullPointerException("pointer to a layer to be added is NULL");
-			
-			// bind the last layer with the newly added
-			LayerType *last = m_layers.empty() ? NULL : m_layers.back();
-			if (last != NULL)
-				last->setNextLayer(layer);
-			layer->setPrevLayer(last);
-
-			m_layers.push_back(layer);
-		}
-		
-		/** Perform the given function on every input weight of the network. */
-		template <typename Function>
-		inline void forEachWeightForward(Function& func)
-		{
-			const size_t layersCount = getLayersCount();
-			for (size_t layer = 0; layer < layersCount; ++layer)
-				(*this)[layer].forEachWeightForward(func);
-		}
-
-		/** Perform the given function on every neuron of the network. */
-		template <typename Function>
-		inline void forEachNeuronForward(Function& func)
-		{
-			const size_t layersCount = getLayersCount();
-			for (size_t layer = 0; layer < layersCount; ++layer)
-				(*this)[layer].forEachNeuronForward(func);
-		}
-
-		const LayerType& getLayer(size_t index) const
-		{
-			if (index < 0 || index >= m_layers.size())
-				throw IndexOutOfArray(index, m_layers.size());
-			if (m_layers[index] == NULL)
-				throw NullPointerException("pointer to NULL couldn't be dereferenced");
-			return (*this)[index];
-		}
-
-		inline const LayerType& operator[](size_t index) const { return *m_layers[index]; }
-		inline LayerType& operator[](size_t index) { return *m_layers[index]; }
-
-		inline size_t getLayersCount() const { return m_layers.size(); }
-
-		inline size_t getInputsCount() const { return m_layers.front()->getInputsCount(); }
-		inline size_t getOutputsCount() const { return m_layers.back()->getNeuronsCount(); }
-
-		size_t getNeuronsCount() const
-		{
-			size_t neuronsSum = 0;
-			for (size_t layer = 0; layer < getLayersCount(); ++layer)
-				neuronsSum += (*this)[layer].getNeuronsCount();
-			return neuronsSum;
-		}
-
-		size_t getWeightsCount() const
-		{
-			size_t weightsSum = 0;
-			for (size_t layer = 0; layer < getLayersCount(); ++layer)
-				weightsSum += (*this)[layer].getWeightsCount();
-			return weightsSum;
-		}
-
-		inline const OutputType* getOutputCache() const
-		{
-			return m_layers.back()->getOutputCache();
-		}
-
-	protected:
-		/** List of all the layers of the network. */
-		LayersList m_layers;
-
-	protected:
-		void create(size_t inputsCount, const LayersSizes& sizes)
-		{
-			// create the first layer with the given count of inputs
-			LayerPtr layer = new LayerType(sizes[0], inputsCount);
-			pushLayer(layer);
-
-			// create next layers - each one has number of inputs that is equal to the number
-			// of outputs of the previous layer
-			for (size_t i = 1; i < sizes.size(); ++i) {
-				layer = new LayerType( sizes[i], layer->getOutputsCount() );
-				pushLayer(layer);
-			}
-		}
-
-		void destroy()
-		{
-			deleteRange(m_layers.begin(), m_layers.end());
-			m_layers.clear();
-		}
-	};
-	
-	
-	/** Print all the layers of the network to the given output stream. */
-	template <typename LayerT>
-	std::ostream& operator<<(std::ostream& os, const FeedForwardNetwork<LayerT>& net)
-	{
-		for (size_t layer = 0; layer < net.getLayersCount(); ++layer)
-			os << "Layer " << (layer + 1) << ":\n" << net[layer];
-		return os;
-	}
-
-}
-
+#ifndef _FEED_FORWARD_NETWORK_
+#define _FEED_FORWARD_NETWORK_
+
+#include <vector>
+#include <cstring>
+#include "common/exceptions.h"
+#include "common/utils.h"
+#include "common/memory.h"
+#include "common/random.h"
+#include "common/sparseVector.h"
+#include "feedForward/networkBufferAllocator.h"
+#include "initializers/randomInitializer.h"
+
+namespace NNLib
+{
+
+	/**
+	This class represents a whole feed-forward neural network. A network created
+	from layers sizes keeps all its layers, neurons, weights and outputs caches
+	in a single aligned block (arena) - blocks of weights of the single layers
+	are stored one after another. Layers added by pushLayer() are owned by the
+	network too but allocated separately.
+
+	All the weights can be saved to a flat buffer of getWeightsSize() values and
+	restored from it (e.g. to keep the best weights found during training) and
+	a copy of the network is a deep one - it's created from layers sizes and
+	its weights are copied in one go.
+	*/
+	template <typename LayerT>
+	class FeedForwardNetwork
+	{
+	public:
+		typedef LayerT LayerType;
+		typedef LayerType *LayerPtr;
+		typedef typename LayerType::NeuronType NeuronType;
+		typedef typename LayerType::InputType InputType;
+		typedef typename LayerType::OutputType OutputType;
+		typedef typename NeuronType::WeightType WeightType;
+		typedef typename std::vector<LayerPtr> LayersList;
+		typedef std::vector<size_t> LayersSizes;
+
+		FeedForwardNetwork() :
+		m_arena(NULL), m_arenaLayersCount(0), m_weightsVersion(0)
+		{ }
+
+		FeedForwardNetwork(size_t inputsCount, const LayersSizes& sizes) :
+		m_arena(NULL), m_arenaLayersCount(0), m_weightsVersion(0)
+		{
+			create(inputsCount, sizes);
+		}
+
+		/** Create a deep copy of the given network. */
+		FeedForwardNetwork(const FeedForwardNetwork& other) :
+		m_arena(NULL), m_arenaLayersCount(0), m_weightsVersion(0)
+		{
+			copy(other);
+		}
+
+		~FeedForwardNetwork()
+		{
+			destroy();
+		}
+
+		/** Copy the given network. If both the networks have the same layers sizes
+		only the weights and the frozen flags are copied, otherwise the network
+		is recreated. */
+		FeedForwardNetwork& operator=(const FeedForwardNetwork& other)
+		{
+			if (this == &other)
+				return *this;
+			if ( getLayersSizes() == other.getLayersSizes() && getLayersCount() > 0 &&
+				getInputsCount() == other.getInputsCount() ) {
+				copyWeights(other);
+				copyFrozen(other);
+			}
+			else {
+				destroy();
+				copy(other);
+			}
+			return *this;
+		}
+
+		/** Create a deep copy of this network on heap. */
+		FeedForwardNetwork* clone() const
+		{
+			return new FeedForwardNetwork(*this);
+		}
+
+		const OutputType* eval(const InputType inputs[])
+		{
+			typename LayersList::iterator end = m_layers.end();
+			for (typename LayersList::iterator it = m_layers.begin(); it != end; ++it)
+				inputs = (*it)->eval(inputs);
+			return inputs;
+		}
+
+		/** Eval the network for the given sparse input. Only the first layer works
+		with the non-zero inputs, the other layers are evaluated as usual. */
+		const OutputType* eval(const SparseVector<InputType>& inputs)
+		{
+			const size_t layersCount = getLayersCount();
+			const OutputType *outputs = (*this)[0].eval(inputs);
+			for (size_t layer = 1; layer < layersCount; ++layer)
+				outputs = (*this)[layer].eval(outputs);
+			return outputs;
+		}
+
+		/** Eval the network without touching its caches. Outputs of the layers are
+		stored to the given buffer created by createOutputsBuffer() so more threads
+		can evaluate the same network at once, each one with its own buffer. */
+		const OutputType* eval(const InputType inputs[], OutputType **buffer) const
+		{
+			const size_t layersCount = getLayersCount();
+			for (size_t layer = 0; layer < layersCount; ++layer)
+				inputs = (*this)[layer].eval(inputs, buffer[layer]);
+			return inputs;
+		}
+
+		/** Eval the network for a batch of inputs stored in rows one after another.
+		The buffer has to be created by createOutputsBuffer() for at least the given
+		count of patterns. Returned outputs are stored in rows of length
+		getOutputsCount() + 1 (the last value of each row is the bias output). */
+		const OutputType* evalBatch(const InputType inputs[], size_t count, OutputType **buffer) const
+		{
+			const size_t layersCount = getLayersCount();
+			for (size_t layer = 0; layer < layersCount; ++layer)
+				inputs = (*this)[layer].evalBatch(inputs, count, buffer[layer]);
+			return inputs;
+		}
+
+		void initWeights(const Initializer<WeightType>& initializer)
+		{
+			notifyWeightsChanged();
+			typename LayersList::iterator end = m_layers.end();
+			for (typename LayersList::iterator it = m_layers.begin(); it != end; ++it)
+				(*it)->initWeights(initializer);
+		}
+
+		void initWeightsUniform(const Range<WeightType>& weightsRange)
+		{
+			RandomUniform<WeightType> random(weightsRange);
+			RandomInitializer<WeightType> init(random);
+			initWeights(init);
+		}
+
+		void pushLayer(LayerType *layer)
+		{
+			if (layer == NULL)
+				throw NullPointerException("pointer to a layer to be added is NULL");
+			
+			// bind the last layer with the newly added
+			LayerType *last = m_layers.empty() ? NULL : m_layers.back();
+			if (last != NULL)
+				last->setNextLayer(layer);
+			layer->setPrevLayer(last);
+
+			m_layers.push_back(layer);
+		}
+		
+		/** Perform the given function on every input weight of the network. */
+		template <typename Function>
+		inline void forEachWeightForward(Function& func)
+		{
+			notifyWeightsChanged();
+			const size_t layersCount = getLayersCount();
+			for (size_t layer = 0; layer < layersCount; ++layer)
+				(*this)[layer].forEachWeightForward(func);
+		}
+
+		/** Perform the given function func(weights, index, count) on the block of
+		weights of every layer. The index is the position of the block in the flat
+		layout of the whole network used by WeightsBuffer, the count includes the
+		padding of the rows (which is always zero). */
+		template <typename Function>
+		inline void forEachWeightsBlock(Function& func)
+		{
+			notifyWeightsChanged();
+			const size_t layersCount = getLayersCount();
+			size_t index = 0;
+			for (size_t layer = 0; layer < layersCount; ++layer) {
+				LayerType& l = (*this)[layer];
+				func( l.getWeights(), index, l.getWeightsBlockSize() );
+				index += l.getWeightsBlockSize();
+			}
+		}
+
+		/** Perform the given function func(layer, index) on every layer from the
+		first one to the last one. */
+		template <typename Function>
+		inline void forEachLayer(Function& func)
+		{
+			notifyWeightsChanged();
+			const size_t layersCount = getLayersCount();
+			for (size_t layer = 0; layer < layersCount; ++layer)
+				func( (*this)[layer], layer );
+		}
+
+		template <typename Function>
+		inline void forEachLayer(Function& func) const
+		{
+			const size_t layersCount = getLayersCount();
+			for (size_t layer = 0; layer < layersCount; ++layer)
+				func( (*this)[layer], layer );
+		}
+
+		/** Perform the given function func(layer, index) on every layer from the
+		last one to the first one. */
+		template <typename Function>
+		inline void forEachLayerBackward(Function& func) const
+		{
+			for (size_t layer = getLayersCount(); layer > 0; --layer)
+				func( (*this)[layer-1], layer - 1 );
+		}
+
+		/** Perform the given function on every neuron of the network. */
+		template <typename Function>
+		inline void forEachNeuronForward(Function& func)
+		{
+			notifyWeightsChanged();
+			const size_t layersCount = getLayersCount();
+			for (size_t layer = 0; layer < layersCount; ++layer)
+				(*this)[layer].forEachNeuronForward(func);
+		}
+
+		const LayerType& getLayer(size_t index) const
+		{
+			if (index < 0 || index >= m_layers.size())
+				throw IndexOutOfArray(index, m_layers.size());
+			if (m_layers[index] == NULL)
+				throw NullPointerException("pointer to NULL couldn't be dereferenced");
+			return (*this)[index];
+		}
+
+		inline const LayerType& operator[](size_t index) const { return *m_layers[index]; }
+		inline LayerType& operator[](size_t index) { return *m_layers[index]; }
+
+		inline size_t getLayersCount() const { return m_layers.size(); }
+
+		inline size_t getInputsCount() const { return m_layers.front()->getInputsCount(); }
+		inline size_t getOutputsCount() const { return m_layers.back()->getNeuronsCount(); }
+
+		size_t getNeuronsCount() const
+		{
+			size_t neuronsSum = 0;
+			for (size_t layer = 0; layer < getLayersCount(); ++layer)
+				neuronsSum += (*this)[layer].getNeuronsCount();
+			return neuronsSum;
+		}
+
+		size_t getWeightsCount() const
+		{
+			size_t weightsSum = 0;
+			for (size_t layer = 0; layer < getLayersCount(); ++layer)
+				weightsSum += (*this)[layer].getWeightsCount();
+			return weightsSum;
+		}
+
+		inline const OutputType* getOutputCache() const
+		{
+			return m_layers.back()->getOutputCache();
+		}
+
+		/** Get counts of neurons of the single layers. */
+		LayersSizes getLayersSizes() const
+		{
+			LayersSizes sizes( getLayersCount() );
+			for (size_t layer = 0; layer < getLayersCount(); ++layer)
+				sizes[layer] = (*this)[layer].getNeuronsCount();
+			return sizes;
+		}
+
+		/** Get count of values of all the weights blocks (including the padding),
+		i.e. the size of a snapshot of the weights and of a WeightsBuffer. */
+		size_t getWeightsSize() const
+		{
+			size_t size = 0;
+			for (size_t layer = 0; layer < getLayersCount(); ++layer)
+				size += (*this)[layer].getWeightsBlockSize();
+			return size;
+		}
+
+		/** Copy all the weights to the given array of getWeightsSize() values. */
+		void saveWeights(WeightType snapshot[]) const
+		{
+			if ( hasContiguousWeights() ) {
+				std::memcpy( snapshot, m_layers.front()->getWeights(), getWeightsSize() * sizeof(WeightType) );
+				return;
+			}
+			for (size_t layer = 0; layer < getLayersCount(); ++layer) {
+				const LayerType& l = (*this)[layer];
+				std::memcpy( snapshot, l.getWeights(), l.getWeightsBlockSize() * sizeof(WeightType) );
+				snapshot += l.getWeightsBlockSize();
+			}
+		}
+
+		/** Set all the weights from the given array saved by saveWeights(). */
+		void restoreWeights(const WeightType snapshot[])
+		{
+			notifyWeightsChanged();
+			if ( hasContiguousWeights() ) {
+				std::memcpy( m_layers.front()->getWeights(), snapshot, getWeightsSize() * sizeof(WeightType) );
+				return;
+			}
+			for (size_t layer = 0; layer < getLayersCount(); ++layer) {
+				LayerType& l = (*this)[layer];
+				std::memcpy( l.getWeights(), snapshot, l.getWeightsBlockSize() * sizeof(WeightType) );
+				snapshot += l.getWeightsBlockSize();
+			}
+		}
+
+		/** Copy all the weights to the given buffer (e.g. a WeightsBuffer created
+		for this network). Throw SizeMismatchException if its size doesn't fit. */
+		void saveWeights(LayersBuffer<WeightType>& snapshot) const
+		{
+			checkSnapshotSize( snapshot.getSize() );
+			saveWeights( snapshot.getData() );
+		}
+
+		/** Set all the weights from the given buffer. Throw SizeMismatchException
+		if its size doesn't fit. */
+		void restoreWeights(const LayersBuffer<WeightType>& snapshot)
+		{
+			checkSnapshotSize( snapshot.getSize() );
+			restoreWeights( snapshot.getData() );
+		}
+
+		/** Copy weights of the given network of the same layers sizes. */
+		void copyWeights(const FeedForwardNetwork& other)
+		{
+			checkSnapshotSize( other.getWeightsSize() );
+			notifyWeightsChanged();
+			if ( other.hasContiguousWeights() )
+				restoreWeights( other.m_layers.front()->getWeights() );
+			else {
+				for (size_t layer = 0; layer < getLayersCount(); ++layer)
+					std::memcpy( (*this)[layer].getWeights(), other[layer].getWeights(),
+						other[layer].getWeightsBlockSize() * sizeof(WeightType) );
+			}
+		}
+
+		/** Get version of the weights - it's increased by every method which can
+		change them (e.g. initWeights(), restoreWeights() or the non-const
+		forEach methods used by the updaters). Caches of outputs of the network
+		are valid only for the version they were computed with. */
+		inline size_t getWeightsVersion() const { return m_weightsVersion; }
+
+		/** Increase version of the weights. It has to be called after the weights
+		were changed directly through the layers or neurons. */
+		inline void notifyWeightsChanged() { ++m_weightsVersion; }
+
+		/** Freeze the first given count of layers and unfreeze the others (e.g. to
+		fine-tune only the top layers of a pretrained network). */
+		void freezeLayers(size_t count)
+		{
+			for (size_t layer = 0; layer < getLayersCount(); ++layer)
+				(*this)[layer].setFrozen(layer < count);
+		}
+
+		/** Get count of the frozen layers at the beginning of the network. */
+		size_t getFrozenPrefixLength() const
+		{
+			size_t count = 0;
+			while ( count < getLayersCount() && (*this)[count].isFrozen() )
+				++count;
+			return count;
+		}
+
+		/** Check whether weights of all the layers are stored in one block. */
+		inline bool hasContiguousWeights() const
+		{
+			return m_arenaLayersCount > 0 && m_arenaLayersCount == getLayersCount();
+		}
+
+	protected:
+		/** List of all the layers of the network. */
+		LayersList m_layers;
+
+		/** Block with the first m_arenaLayersCount layers (NULL if there is none). */
+		void *m_arena;
+		size_t m_arenaLayersCount;
+
+		/** Version of the weights (see getWeightsVersion()). */
+		size_t m_weightsVersion;
+
+	protected:
+		void create(size_t inputsCount, const LayersSizes& sizes)
+		{
+			const size_t layersCount = sizes.size();
+
+			// count neurons, weights and outputs - each layer has number of inputs that
+			// is equal to the number of outputs of the previous layer
+			size_t neuronsCount = 0, weightsCount = 0, outputsCount = 0;
+			for (size_t i = 0, inputs = inputsCount; i < layersCount; inputs = sizes[i++] + 1) {
+				neuronsCount += sizes[i];
+				weightsCount += sizes[i] * LayerType::getWeightsStride(inputs);
+				outputsCount += sizes[i] + 1;
+			}
+
+			// cache line aligned sections of the arena
+			const size_t layersOffset = 0;
+			const size_t ptrsOffset = layersOffset + alignSize( layersCount * sizeof(LayerType), CACHE_LINE_SIZE );
+			const size_t neuronsOffset = ptrsOffset + alignSize( neuronsCount * sizeof(NeuronType*), CACHE_LINE_SIZE );
+			const size_t weightsOffset = neuronsOffset + alignSize( neuronsCount * sizeof(NeuronType), CACHE_LINE_SIZE );
+			const size_t outputsOffset = weightsOffset + alignSize( weightsCount * sizeof(WeightType), CACHE_LINE_SIZE );
+			const size_t arenaSize = outputsOffset + outputsCount * sizeof(OutputType);
+
+			m_arena = allocateHugePageFriendly(arenaSize);
+			char *arena = static_cast<char*>(m_arena);
+			LayerType *layers = reinterpret_cast<LayerType*>(arena + layersOffset);
+			NeuronType **ptrs = reinterpret_cast<NeuronType**>(arena + ptrsOffset);
+			char *neurons = arena + neuronsOffset;
+			WeightType *weights = reinterpret_cast<WeightType*>(arena + weightsOffset);
+			OutputType *outputs = reinterpret_cast<OutputType*>(arena + outputsOffset);
+
+			m_layers.reserve(layersCount);
+			for (size_t i = 0, inputs = inputsCount; i < layersCount; inputs = sizes[i++] + 1)
+			{
+				LayerPtr layer = new (layers + i) LayerType(sizes[i], inputs, ptrs, neurons, weights, outputs);
+				++m_arenaLayersCount;
+				pushLayer(layer);
+
+				ptrs += sizes[i];
+				neurons += sizes[i] * sizeof(NeuronType);
+				weights += layer->getWeightsBlockSize();
+				outputs += sizes[i] + 1;
+			}
+		}
+
+		/** Create this (empty) network with the same layers sizes and weights as
+		the given one. */
+		void copy(const FeedForwardNetwork& other)
+		{
+			if (other.getLayersCount() == 0)
+				return;
+			create( other.getInputsCount(), other.getLayersSizes() );
+			copyWeights(other);
+			copyFrozen(other);
+		}
+
+		/** Freeze the same layers as in the given network of the same layers sizes. */
+		void copyFrozen(const FeedForwardNetwork& other)
+		{
+			for (size_t layer = 0; layer < getLayersCount(); ++layer)
+				(*this)[layer].setFrozen( other[layer].isFrozen() );
+		}
+
+		inline void checkSnapshotSize(size_t size) const
+		{
+			if ( size != getWeightsSize() )
+				throw SizeMismatchException( getWeightsSize(), size );
+		}
+
+		void destroy()
+		{
+			for (size_t layer = 0; layer < m_arenaLayersCount; ++layer)
+				m_layers[layer]->~LayerType();
+			deleteRange(m_layers.begin() + m_arenaLayersCount, m_layers.end());
+			m_layers.clear();
+
+			if (m_arena != NULL)
+				freeAligned(m_arena);
+			m_arena = NULL;
+			m_arenaLayersCount = 0;
+		}
+
+	};
+	
+	
+	/** Print all the layers of the network to the given output stream. */
+	template <typename LayerT>
+	std::ostream& operator<<(std::ostream& os, const FeedForwardNetwork<LayerT>& net)
+	{
+		for (size_t layer = 0; layer < net.getLayersCount(); ++layer)
+			os << "Layer " << (layer + 1) << ":\n" << net[layer];
+		return os;
+	}
+
+}
+
 #endif
\ No newline at end of file
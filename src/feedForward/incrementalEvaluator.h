@@ -0,0 +1,212 @@
+#ifndef _INCREMENTAL_EVALUATOR_H_
+#define _INCREMENTAL_EVALUATOR_H_
+
+#include <vector>
+#include <cmath>
+#include "common/sparseVector.h"
+#include "feedForward/networkBufferAllocator.h"
+
+namespace NNLib
+{
+
+	/**
+	Evaluator of a feed-forward network for a stream of inputs where each input
+	differs from the previous one only in a few values. Combinations of all the
+	neurons (dot products of their inputs and weights) are kept so a change of
+	the input is added to them per changed column of weights - the first layer
+	costs O(changed inputs * neurons) instead of a full matrix-vector product.
+	The change is then carried forward only from the neurons whose outputs
+	changed by more than the given tolerance (the outputs of the others are
+	kept, so the stored state stays consistent).
+
+	The neurons have to use a dot product combinator. Rounding errors of the
+	updates accumulate, therefore the network is fully evaluated after the given
+	count of updates and also whenever its weights change (see
+	FeedForwardNetwork::getWeightsVersion()).
+	*/
+	template <typename NetworkT>
+	class IncrementalEvaluator
+	{
+	public:
+		typedef NetworkT NetworkType;
+		typedef typename NetworkType::InputType InputType;
+		typedef typename NetworkType::OutputType OutputType;
+		typedef typename NetworkType::WeightType WeightType;
+
+		/** Default count of updates between two full evaluations. */
+		static const size_t DEF_REFRESH_PERIOD;
+
+		/** Create evaluator of the given network with the current input of zeros. */
+		IncrementalEvaluator(const NetworkType& network, OutputType tolerance = 0,
+			size_t refreshPeriod = DEF_REFRESH_PERIOD) :
+		m_network(network), m_combinations(network),
+		m_outputs( createOutputsBuffer<OutputType>(network) ),
+		m_input( network.getInputsCount() ),
+		m_tolerance(tolerance), m_refreshPeriod(refreshPeriod),
+		m_updatesCount(0), m_weightsVersion( network.getWeightsVersion() ),
+		m_propagatedCount(0)
+		{
+			evalAll();
+		}
+
+		~IncrementalEvaluator()
+		{
+			deleteOutputsBuffer(m_outputs);
+		}
+
+		/** Fully eval the network for the given input and keep it as the current one. */
+		const OutputType* eval(const InputType input[])
+		{
+			std::copy(input, input + m_input.size(), m_input.begin());
+			return evalAll();
+		}
+
+		/** Eval the network for the current input with the given values changed
+		(indices of the changed inputs and their new values). */
+		const OutputType* update(const SparseVector<InputType>& changes)
+		{
+			const bool refresh = ( m_network.getWeightsVersion() != m_weightsVersion ) ||
+				( m_refreshPeriod > 0 && ++m_updatesCount >= m_refreshPeriod );
+
+			// differences of the changed inputs
+			m_changedIndices.clear();
+			m_changedDeltas.clear();
+			for (size_t k = 0; k < changes.count; ++k)
+			{
+				const size_t index = changes.indices[k];
+				const OutputType delta = changes.values[k] - m_input[index];
+				if (delta != 0) {
+					m_input[index] = changes.values[k];
+					m_changedIndices.push_back(index);
+					m_changedDeltas.push_back(delta);
+				}
+			}
+
+			if (refresh)
+				return evalAll();
+
+			// carry the changes forward while some outputs change
+			m_propagatedCount = 0;
+			const size_t layersCount = m_network.getLayersCount();
+			for (size_t layer = 0; layer < layersCount && !m_changedIndices.empty(); ++layer)
+				updateLayer(layer);
+
+			return getOutputs();
+		}
+
+		inline const OutputType* update(const size_t indices[], const InputType values[], size_t count)
+		{
+			return update( SparseVector<InputType>(indices, values, count) );
+		}
+
+		/** Get outputs of the network for the current input. */
+		inline const OutputType* getOutputs() const { return m_outputs[m_network.getLayersCount() - 1]; }
+
+		inline const InputType* getInput() const { return &m_input[0]; }
+
+		/** Get count of the changed values (inputs and outputs of the neurons)
+		carried forward by the last update. */
+		inline size_t getPropagatedCount() const { return m_propagatedCount; }
+
+		inline OutputType getTolerance() const { return m_tolerance; }
+		inline size_t getRefreshPeriod() const { return m_refreshPeriod; }
+
+	protected:
+		const NetworkType& m_network;
+
+		/** Combinations of inputs and weights of all the neurons. */
+		NeuronsBuffer<OutputType> m_combinations;
+
+		/** Outputs of all the layers (including the bias outputs). */
+		OutputType **m_outputs;
+
+		/** Current input of the network. */
+		std::vector<InputType> m_input;
+
+		/** Changes of outputs smaller than this aren't carried forward. */
+		OutputType m_tolerance;
+
+		size_t m_refreshPeriod;
+		size_t m_updatesCount;
+
+		/** Version of the weights the combinations were evaluated with. */
+		size_t m_weightsVersion;
+
+		size_t m_propagatedCount;
+
+		/** Changed inputs of the current layer and their differences. */
+		std::vector<size_t> m_changedIndices;
+		std::vector<OutputType> m_changedDeltas;
+
+		const OutputType* evalAll()
+		{
+			const size_t layersCount = m_network.getLayersCount();
+			const OutputType *input = &m_input[0];
+			for (size_t layer = 0; layer < layersCount; ++layer)
+			{
+				const typename NetworkType::LayerType& l = m_network[layer];
+				OutputType *combinations = m_combinations[layer];
+				OutputType *outputs = m_outputs[layer];
+				for (size_t j = 0; j < l.getNeuronsCount(); ++j) {
+					combinations[j] = l[j].getCombinator().combine( input, l[j].getWeights(), l.getInputsCount() );
+					outputs[j] = l[j].getActivationFunc().function( combinations[j] );
+				}
+				outputs[l.getNeuronsCount()] = 1;
+				input = outputs;
+			}
+
+			m_updatesCount = 0;
+			m_weightsVersion = m_network.getWeightsVersion();
+			m_propagatedCount = m_network.getNeuronsCount();
+			return getOutputs();
+		}
+
+		/** Add the changes of inputs of the given layer to its combinations and
+		replace them by the changes of its outputs. */
+		void updateLayer(size_t layer)
+		{
+			const typename NetworkType::LayerType& l = m_network[layer];
+			const WeightType *weights = l.getWeights();
+			const size_t stride = l.getWeightsStride();
+			const size_t changedCount = m_changedIndices.size();
+			OutputType *combinations = m_combinations[layer];
+			OutputType *outputs = m_outputs[layer];
+
+			m_propagatedCount += changedCount;
+
+			// weighted sum of the changes for every neuron (single row at once)
+			for (size_t j = 0; j < l.getNeuronsCount(); ++j)
+			{
+				const WeightType *row = weights + j * stride;
+				OutputType sum = 0;
+				for (size_t k = 0; k < changedCount; ++k)
+					sum += row[ m_changedIndices[k] ] * m_changedDeltas[k];
+				combinations[j] += sum;
+			}
+
+			// changes of the outputs are the changes of inputs of the next layer
+			m_changedIndices.clear();
+			m_changedDeltas.clear();
+			for (size_t j = 0; j < l.getNeuronsCount(); ++j)
+			{
+				const OutputType output = l[j].getActivationFunc().function( combinations[j] );
+				const OutputType delta = output - outputs[j];
+				if ( std::fabs(delta) > m_tolerance ) {
+					outputs[j] = output;
+					m_changedIndices.push_back(j);
+					m_changedDeltas.push_back(delta);
+				}
+			}
+		}
+
+	private:
+		IncrementalEvaluator(const IncrementalEvaluator&);
+		IncrementalEvaluator& operator=(const IncrementalEvaluator&);
+	};
+
+	template <typename NetworkT>
+	const size_t IncrementalEvaluator<NetworkT>::DEF_REFRESH_PERIOD = 1000;
+
+}
+
+#endif
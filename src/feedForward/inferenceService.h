@@ -0,0 +1,204 @@
+#ifndef _INFERENCE_SERVICE_H_
+#define _INFERENCE_SERVICE_H_
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <chrono>
+#include "common/utils.h"
+#include "feedForward/networkBufferAllocator.h"
+
+namespace NNLib
+{
+
+	/**
+	In-process inference service for concurrent callers of a feed-forward network.
+	Callers submit single inputs and get futures of the outputs. A dispatcher
+	thread collects the requests into batches of at most the given count of
+	inputs - a batch is evaluated as soon as it's full or when the given delay
+	from its first request elapses - and evaluates each of them by one call of
+	FeedForwardNetwork::evalBatch(). Latency of a request is therefore bounded by
+	the delay plus evaluation of one batch.
+
+	The network mustn't change while the service is running (see
+	WeightsPublisher for training while serving).
+	*/
+	template <typename NetworkT>
+	class InferenceService
+	{
+	public:
+		typedef NetworkT NetworkType;
+		typedef typename NetworkType::InputType InputType;
+		typedef typename NetworkType::OutputType OutputType;
+		typedef std::vector<OutputType> OutputVector;
+
+		/** Default maximal count of inputs of one batch. */
+		static const size_t DEF_MAX_BATCH_SIZE;
+
+		/** Default maximal delay of a batch (in microseconds). */
+		static const unsigned DEF_MAX_DELAY;
+
+		/** Start the dispatcher of the given network. */
+		InferenceService(const NetworkType& network, size_t maxBatchSize = DEF_MAX_BATCH_SIZE,
+			unsigned maxDelay = DEF_MAX_DELAY) :
+		m_network(network),
+		m_inputsCount( network.getInputsCount() ), m_outputsCount( network.getOutputsCount() ),
+		m_maxBatchSize( std::max<size_t>(maxBatchSize, 1) ), m_maxDelay(maxDelay),
+		m_running(true), m_batchesCount(0), m_requestsCount(0)
+		{
+			m_dispatcher = std::thread(&InferenceService::dispatch, this);
+		}
+
+		/** Evaluate all the submitted requests and stop the dispatcher. */
+		~InferenceService()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_running = false;
+			}
+			m_requestAdded.notify_one();
+			m_dispatcher.join();
+		}
+
+		/** Submit the given input (it's copied) and get future of its outputs. */
+		std::future<OutputVector> submit(const InputType input[])
+		{
+			Request *request = new Request( input, input + m_inputsCount );
+			std::future<OutputVector> result = request->promise.get_future();
+
+			bool notify;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_requests.push_back(request);
+				notify = (m_requests.size() == 1 || m_requests.size() == m_maxBatchSize);
+			}
+			if (notify)
+				m_requestAdded.notify_one();
+			return result;
+		}
+
+		inline size_t getMaxBatchSize() const { return m_maxBatchSize; }
+		inline unsigned getMaxDelay() const { return m_maxDelay; }
+
+		/** Get count of the evaluated batches. */
+		inline size_t getBatchesCount() const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_batchesCount;
+		}
+
+		/** Get count of the evaluated requests. */
+		inline size_t getRequestsCount() const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_requestsCount;
+		}
+
+	protected:
+		typedef std::chrono::steady_clock Clock;
+
+		/** Input of one caller, promise of its outputs and time of the submit. */
+		struct Request
+		{
+			std::vector<InputType> input;
+			std::promise<OutputVector> promise;
+			Clock::time_point submitted;
+
+			Request(const InputType *begin, const InputType *end) :
+			input(begin, end), submitted( Clock::now() )
+			{ }
+		};
+
+		const NetworkType& m_network;
+		const size_t m_inputsCount, m_outputsCount;
+		const size_t m_maxBatchSize;
+		const unsigned m_maxDelay;
+
+		/** Requests waiting for the dispatcher. */
+		std::deque<Request*> m_requests;
+		mutable std::mutex m_mutex;
+		std::condition_variable m_requestAdded;
+
+		bool m_running;
+		size_t m_batchesCount, m_requestsCount;
+		std::thread m_dispatcher;
+
+		/** Collect and evaluate batches until the service is stopped. */
+		void dispatch()
+		{
+			OutputType **buffer = createOutputsBuffer<OutputType>(m_network, m_maxBatchSize);
+			std::vector<InputType> inputs(m_maxBatchSize * m_inputsCount);
+			std::vector<Request*> batch;
+			batch.reserve(m_maxBatchSize);
+
+			for (;;)
+			{
+				{
+					std::unique_lock<std::mutex> lock(m_mutex);
+					while ( m_running && m_requests.empty() )
+						m_requestAdded.wait(lock);
+					if ( m_requests.empty() )
+						break;
+
+					// wait for a full batch at most the delay from the oldest request
+					const Clock::time_point deadline = m_requests.front()->submitted + std::chrono::microseconds(m_maxDelay);
+					while ( m_running && m_requests.size() < m_maxBatchSize )
+						if ( m_requestAdded.wait_until(lock, deadline) == std::cv_status::timeout )
+							break;
+
+					while ( !m_requests.empty() && batch.size() < m_maxBatchSize ) {
+						batch.push_back( m_requests.front() );
+						m_requests.pop_front();
+					}
+					++m_batchesCount;
+					m_requestsCount += batch.size();
+				}
+
+				evalBatch(batch, inputs, buffer);
+				batch.clear();
+			}
+
+			deleteOutputsBuffer(buffer);
+		}
+
+		/** Evaluate the requests of the batch at once and fulfil their promises.
+		An exception of the evaluation is passed to the callers of the unfulfilled
+		promises, the dispatcher goes on. */
+		void evalBatch(const std::vector<Request*>& batch, std::vector<InputType>& inputs, OutputType **buffer)
+		{
+			size_t fulfilled = 0;
+			try {
+				for (size_t p = 0; p < batch.size(); ++p)
+					std::copy( batch[p]->input.begin(), batch[p]->input.end(), &inputs[p * m_inputsCount] );
+
+				// rows of the outputs include the bias output
+				const OutputType *outputs = m_network.evalBatch(&inputs[0], batch.size(), buffer);
+				for (; fulfilled < batch.size(); ++fulfilled) {
+					const OutputType *output = outputs + fulfilled * (m_outputsCount + 1);
+					batch[fulfilled]->promise.set_value( OutputVector(output, output + m_outputsCount) );
+				}
+			}
+			catch (...) {
+				for (; fulfilled < batch.size(); ++fulfilled)
+					batch[fulfilled]->promise.set_exception( std::current_exception() );
+			}
+			deleteRange( batch.begin(), batch.end() );
+		}
+
+	private:
+		InferenceService(const InferenceService&);
+		InferenceService& operator=(const InferenceService&);
+	};
+
+	template <typename NetworkT>
+	const size_t InferenceService<NetworkT>::DEF_MAX_BATCH_SIZE = 32;
+
+	template <typename NetworkT>
+	const unsigned InferenceService<NetworkT>::DEF_MAX_DELAY = 200;
+
+}
+
+#endif
@@ -1,81 +1,212 @@
-#ifndef _NETWORK_BUFFER_ALLOCATOR_
-#define _NETWORK_BUFFER_ALLOCATOR_
-
-#include "common/utils.h"
-
-namespace NNLib
-{
-
-	/** Create buffers of the same structure as is the structure of the
-	network's neurons. */
-	template <typename T, typename NetworkT>
-	T** createNeuronsBuffer(const NetworkT& network)
-	{
-		const size_t layersCount = network.getLayersCount();
-		const size_t neuronsCount = network.getNeuronsCount();
-
-		T** buff = new T*[layersCount];
-		buff[0] = new T[neuronsCount];
-
-		// pointer from layers array to neurons array
-		size_t neuronsSum = 0;
-		for (size_t layer = 0; layer < layersCount; ++layer) {
-			buff[layer] = buff[0] + neuronsSum;
-			neuronsSum += network[layer].getNeuronsCount();
-		}
-
-		return buff;
-	}
-
-	/** Delete buffer of values of the same structure as is the structure
-	of the network's neurons. */
-	template <typename T>
-	void deleteNeuronsBuffer(T** buff)
-	{
-		delete [] *buff;
-		delete [] buff;
-	}
-
-	/** Create buffers of the same structure as is the structure of the
-	network's weights. */
-	template <typename T, typename NetworkT>
-	T*** createWeightsBuffer(const NetworkT& network)
-	{
-		const size_t layersCount  = network.getLayersCount();
-		const size_t neuronsCount = network.getNeuronsCount();
-		const size_t weightsCount = network.getWeightsCount();
-
-		T*** buff = new T**[layersCount];
-		buff[0] = new T*[neuronsCount];
-		buff[0][0] = new T[weightsCount];
-
-		size_t neuronsSum = 0, weightsSum = 0;
-		for (size_t layer = 0; layer < layersCount; ++layer)
-		{
-			// pointer from layers array to neurons array
-			buff[layer] = buff[0] + neuronsSum;
-			neuronsSum += network[layer].getNeuronsCount();
-
-			// pointers from neurons array to weights array
-			for (size_t neuron = 0; neuron < network[layer].getNeuronsCount(); ++neuron) {
-				buff[layer][neuron] = buff[0][0] + weightsSum;
-				weightsSum += network[layer].getInputsCount();
-			}
-		}
-
-		return buff;
-	}
-
-	/** Delete buffer of values of the same structure as is the structure
-	of the network's weights. */
-	template <typename T>
-	void deleteWeightsBuffer(T*** buff)
-	{
-		delete [] **buff;
-		delete [] *buff;
-		delete [] buff;
-	}
-
-}
-
-#endif
\ No newline at end of file
+#ifndef _NETWORK_BUFFER_ALLOCATOR_
+#define _NETWORK_BUFFER_ALLOCATOR_
+
+#include <vector>
+#include <algorithm>
+#include "common/utils.h"
+#include "common/memory.h"
+
+namespace NNLib
+{
+
+	/**
+	Flat buffer of values for the single layers of a network. All the values
+	are stored in one cache line aligned allocation, a small table holds the
+	offsets of the layers.
+	*/
+	template <typename T>
+	class LayersBuffer
+	{
+	public:
+		typedef T ValueType;
+
+		~LayersBuffer()
+		{
+			freeAligned(m_data);
+		}
+
+		/** Set all the values (including the padding). */
+		void fill(ValueType val)
+		{
+			std::fill(m_data, m_data + m_size, val);
+		}
+
+		/** Copy all the values from a buffer of the same layout. */
+		void copyFrom(const LayersBuffer& other)
+		{
+			std::copy(other.m_data, other.m_data + m_size, m_data);
+		}
+
+		inline ValueType* getData() { return m_data; }
+		inline const ValueType* getData() const { return m_data; }
+
+		/** Get count of all the values (including the padding). */
+		inline size_t getSize() const { return m_size; }
+
+		inline size_t getLayersCount() const { return m_offsets.size() - 1; }
+		inline size_t getLayerOffset(size_t layer) const { return m_offsets[layer]; }
+
+		/** Get values of the given layer. */
+		inline ValueType* operator[](size_t layer) { return m_data + m_offsets[layer]; }
+		inline const ValueType* operator[](size_t layer) const { return m_data + m_offsets[layer]; }
+
+	protected:
+		ValueType *m_data;
+		size_t m_size;
+
+		/** Offsets of the single layers (and the total size at the end). */
+		std::vector<size_t> m_offsets;
+
+		LayersBuffer() :
+		m_data(NULL), m_size(0), m_offsets(1, 0)
+		{ }
+
+		/** Add a layer of the given count of values. */
+		inline void addLayer(size_t size)
+		{
+			m_offsets.push_back(m_offsets.back() + size);
+		}
+
+		/** Allocate the values of all the added layers and set them to zero. */
+		void allocate()
+		{
+			m_size = m_offsets.back();
+			m_data = static_cast<ValueType*>( allocateAligned(
+				std::max<size_t>(m_size, 1) * sizeof(ValueType), CACHE_LINE_SIZE ) );
+			fill( ValueType() );
+		}
+
+	private:
+		LayersBuffer(const LayersBuffer&);
+		LayersBuffer& operator=(const LayersBuffer&);
+	};
+
+
+	/**
+	Buffer of one value per neuron of the network (e.g. deltas). Values of
+	every layer are padded to a whole count of SIMD vectors.
+	*/
+	template <typename T>
+	class NeuronsBuffer :
+		public LayersBuffer<T>
+	{
+	public:
+		template <typename NetworkT>
+		NeuronsBuffer(const NetworkT& network)
+		{
+			LayerAdder adder = { *this };
+			network.forEachLayer(adder);
+			this->allocate();
+		}
+
+	protected:
+		/** Functor adding layers of a network to the buffer. */
+		struct LayerAdder
+		{
+			NeuronsBuffer& buffer;
+
+			template <typename LayerT>
+			inline void operator()(const LayerT& layer, size_t)
+			{
+				buffer.addLayer( getPaddedLength<T>( layer.getNeuronsCount() ) );
+			}
+		};
+	};
+
+
+	/**
+	Buffer of one value per weight of the network (e.g. gradient, learning
+	rates or caches of updaters). It has the same layout as the weights of the
+	network - blocks of the layers one after another, each of them in rows of
+	getStride() values per neuron where the padding is zero - so the flat index
+	of a value is the same as the index given by forEachWeightsBlock().
+	*/
+	template <typename T>
+	class WeightsBuffer :
+		public LayersBuffer<T>
+	{
+	public:
+		typedef T ValueType;
+
+		template <typename NetworkT>
+		WeightsBuffer(const NetworkT& network)
+		{
+			LayerAdder adder = { *this };
+			network.forEachLayer(adder);
+			this->allocate();
+		}
+
+		inline size_t getStride(size_t layer) const { return m_strides[layer]; }
+
+		/** Get values of the given neuron. */
+		inline ValueType* getRow(size_t layer, size_t neuron)
+		{
+			return (*this)[layer] + neuron * m_strides[layer];
+		}
+
+		inline const ValueType* getRow(size_t layer, size_t neuron) const
+		{
+			return (*this)[layer] + neuron * m_strides[layer];
+		}
+
+		/** Get flat index of the given weight. */
+		inline size_t getIndex(size_t layer, size_t neuron, size_t input) const
+		{
+			return this->getLayerOffset(layer) + neuron * m_strides[layer] + input;
+		}
+
+	protected:
+		/** Counts of values per neuron of the single layers. */
+		std::vector<size_t> m_strides;
+
+		/** Functor adding layers of a network to the buffer. */
+		struct LayerAdder
+		{
+			WeightsBuffer& buffer;
+
+			template <typename LayerT>
+			inline void operator()(const LayerT& layer, size_t)
+			{
+				buffer.m_strides.push_back( layer.getWeightsStride() );
+				buffer.addLayer( layer.getWeightsBlockSize() );
+			}
+		};
+	};
+
+
+	/** Create buffers for outputs of all the layers of the network (including
+	their bias outputs) for a batch of the given count of patterns. The buffer
+	has to be deleted by deleteOutputsBuffer(). */
+	template <typename T, typename NetworkT>
+	T** createOutputsBuffer(const NetworkT& network, size_t batchSize = 1)
+	{
+		const size_t layersCount = network.getLayersCount();
+
+		size_t outputsCount = 0;
+		for (size_t layer = 0; layer < layersCount; ++layer)
+			outputsCount += network[layer].getOutputsCount();
+
+		T** buff = new T*[layersCount];
+		buff[0] = new T[outputsCount * batchSize];
+
+		// pointer from layers array to outputs array
+		size_t outputsSum = 0;
+		for (size_t layer = 0; layer < layersCount; ++layer) {
+			buff[layer] = buff[0] + outputsSum;
+			outputsSum += network[layer].getOutputsCount() * batchSize;
+		}
+
+		return buff;
+	}
+
+	/** Delete buffer created by createOutputsBuffer(). */
+	template <typename T>
+	void deleteOutputsBuffer(T** buff)
+	{
+		delete [] *buff;
+		delete [] buff;
+	}
+
+}
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef _SOFTMAX_LAYER_
+#define _SOFTMAX_LAYER_
+
+#include <cmath>
+#include "feedForward/feedForwardLayer.h"
+
+namespace NNLib
+{
+
+	/**
+	Output layer with the softmax activation - outputs of the layer are positive
+	and their sum is one, so they can be used as probabilities of classes.
+	            exp(z_i)
+	y_i = -----------------
+	       sum_j exp(z_j)
+	where z_i is the combination of the input and weights of the i-th neuron
+	(activation functions of the neurons are not used). The maximal combination
+	is subtracted before the exponentials so they never overflow.
+	DeltaGradientEvaluator evaluates deltas of this layer for the cross-entropy
+	error (CrossEntropyDistance) fused with the softmax, i.e. y_i - t_i.
+	*/
+	template <typename NeuronT>
+	class SoftmaxLayer :
+		public FeedForwardLayer<NeuronT>
+	{
+	private:
+		typedef FeedForwardLayer<NeuronT> _LayerBase;
+
+	public:
+		typedef typename _LayerBase::NeuronType NeuronType;
+		typedef typename _LayerBase::NeuronPtr NeuronPtr;
+		typedef typename _LayerBase::InputType InputType;
+		typedef typename _LayerBase::OutputType OutputType;
+		typedef typename _LayerBase::WeightType WeightType;
+
+		SoftmaxLayer(size_t neuronsCount, size_t inputsCount) :
+		_LayerBase(neuronsCount, inputsCount)
+		{ }
+
+		/** Constructor of a layer placed in the given external memory (see
+		FeedForwardLayer). */
+		SoftmaxLayer(size_t neuronsCount, size_t inputsCount, NeuronPtr *neuronPtrs,
+			void *neurons, WeightType *weights, OutputType *outputsCache) :
+		_LayerBase(neuronsCount, inputsCount, neuronPtrs, neurons, weights, outputsCache)
+		{ }
+
+		const OutputType* eval(const InputType input[])
+		{
+			evalSoftmax(input, this->m_outputsCache);
+			return this->m_outputsCache;
+		}
+
+		/** Eval the layer for the given sparse input (see FeedForwardLayer). */
+		const OutputType* eval(const SparseVector<InputType>& input)
+		{
+			evalSoftmax(input, this->m_outputsCache);
+			return this->m_outputsCache;
+		}
+
+		/** Eval the layer for the given input and store its outputs (including
+		the bias output) to the given array instead of the cache. */
+		const OutputType* eval(const InputType input[], OutputType output[]) const
+		{
+			evalSoftmax(input, output);
+			output[this->m_neuronsCount] = 1;
+			return output;
+		}
+
+		/** Eval the layer for a batch of inputs stored in rows one after another
+		(see FeedForwardLayer::evalBatch()). */
+		const OutputType* evalBatch(const InputType inputs[], size_t count, OutputType outputs[]) const
+		{
+			const size_t outputsCount = this->getOutputsCount();
+			for (size_t p = 0; p < count; ++p)
+				eval(inputs + p * this->m_inputsCount, outputs + p * outputsCount);
+			return outputs;
+		}
+
+	protected:
+		inline OutputType combine(const NeuronType& neuron, const InputType input[]) const
+		{
+			return neuron.getCombinator().combine( input, neuron.getWeights(), this->m_inputsCount );
+		}
+
+		inline OutputType combine(const NeuronType& neuron, const SparseVector<InputType>& input) const
+		{
+			return neuron.getCombinator().combine( input, neuron.getWeights() );
+		}
+
+		template <typename InputVectorT>
+		void evalSoftmax(const InputVectorT& input, OutputType output[]) const
+		{
+			const size_t neuronsCount = this->m_neuronsCount;
+
+			// combinations of the input and weights and their maximum
+			OutputType max = 0;
+			for (size_t i = 0; i < neuronsCount; ++i) {
+				output[i] = combine( (*this)[i], input );
+				if (i == 0 || output[i] > max)
+					max = output[i];
+			}
+
+			// shifted exponentials normalized by their sum
+			OutputType sum = 0;
+			for (size_t i = 0; i < neuronsCount; ++i)
+				sum += ( output[i] = std::exp(output[i] - max) );
+			const OutputType sumInv = 1 / sum;
+			for (size_t i = 0; i < neuronsCount; ++i)
+				output[i] *= sumInv;
+		}
+	};
+
+}
+
+#endif
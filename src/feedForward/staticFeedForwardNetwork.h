@@ -0,0 +1,387 @@
+#ifndef _STATIC_FEED_FORWARD_NETWORK_
+#define _STATIC_FEED_FORWARD_NETWORK_
+
+#include <vector>
+#include <type_traits>
+#include "common/exceptions.h"
+#include "common/random.h"
+#include "common/sparseVector.h"
+#include "initializers/randomInitializer.h"
+
+namespace NNLib
+{
+
+	/**
+	Chain of layers of different types stored one in another. Every operation
+	on the layers is unrolled by the compiler so each layer is called directly
+	with its own neuron type (no virtual dispatch). All the layers have to use
+	the same type of weights and outputs.
+	*/
+	template <typename... LayersT>
+	class LayersChain;
+
+	/** Empty end of a chain. */
+	template <>
+	class LayersChain<>
+	{
+	public:
+		typedef void WeightType;
+
+		LayersChain(size_t, const size_t[])
+		{ }
+
+		template <typename T>
+		inline const T* eval(const T input[]) { return input; }
+
+		template <typename Function>
+		inline void forEachLayer(Function&, size_t) { }
+		template <typename Function>
+		inline void forEachLayer(Function&, size_t) const { }
+		template <typename Function>
+		inline void forEachLayerBackward(Function&, size_t) { }
+		template <typename Function>
+		inline void forEachLayerBackward(Function&, size_t) const { }
+	};
+
+	template <typename LayerT, typename... RestT>
+	class LayersChain<LayerT, RestT...>
+	{
+	public:
+		typedef LayerT LayerType;
+		typedef LayersChain<RestT...> RestType;
+		typedef typename LayerType::InputType InputType;
+		typedef typename LayerType::OutputType OutputType;
+		typedef typename LayerType::WeightType WeightType;
+
+		static_assert( std::is_same<WeightType, typename RestType::WeightType>::value ||
+			std::is_void<typename RestType::WeightType>::value,
+			"all the layers have to use the same type of weights" );
+
+		/** Create the layers with the given counts of neurons (one per layer). Each
+		layer has one more input than the previous one has neurons (bias). */
+		LayersChain(size_t inputsCount, const size_t sizes[]) :
+		m_layer(sizes[0], inputsCount), m_rest(sizes[0] + 1, sizes + 1)
+		{ }
+
+		inline const OutputType* eval(const InputType input[])
+		{
+			return m_rest.eval( m_layer.eval(input) );
+		}
+
+		/** Eval the first layer for the given sparse input and the rest as usual. */
+		inline const OutputType* eval(const SparseVector<InputType>& input)
+		{
+			return m_rest.eval( m_layer.eval(input) );
+		}
+
+		/** Perform func(layer, index) on this layer and the following ones. */
+		template <typename Function>
+		inline void forEachLayer(Function& func, size_t index)
+		{
+			func(m_layer, index);
+			m_rest.forEachLayer(func, index + 1);
+		}
+
+		template <typename Function>
+		inline void forEachLayer(Function& func, size_t index) const
+		{
+			func(m_layer, index);
+			m_rest.forEachLayer(func, index + 1);
+		}
+
+		/** Perform func(layer, index) on the following layers and then on this one. */
+		template <typename Function>
+		inline void forEachLayerBackward(Function& func, size_t index)
+		{
+			m_rest.forEachLayerBackward(func, index + 1);
+			func(m_layer, index);
+		}
+
+		template <typename Function>
+		inline void forEachLayerBackward(Function& func, size_t index) const
+		{
+			m_rest.forEachLayerBackward(func, index + 1);
+			func(m_layer, index);
+		}
+
+		inline LayerType& getLayer() { return m_layer; }
+		inline const LayerType& getLayer() const { return m_layer; }
+
+		inline RestType& getRest() { return m_rest; }
+		inline const RestType& getRest() const { return m_rest; }
+
+	protected:
+		LayerType m_layer;
+		RestType m_rest;
+	};
+
+
+	/** Access to the layer of the given index in a chain. */
+	template <size_t INDEX, typename ChainT>
+	struct LayersChainAccess
+	{
+		typedef LayersChainAccess<INDEX - 1, typename ChainT::RestType> _NextAccess;
+		typedef typename _NextAccess::LayerType LayerType;
+
+		static inline LayerType& get(ChainT& chain) { return _NextAccess::get( chain.getRest() ); }
+		static inline const LayerType& get(const ChainT& chain) { return _NextAccess::get( chain.getRest() ); }
+	};
+
+	template <typename ChainT>
+	struct LayersChainAccess<0, ChainT>
+	{
+		typedef typename ChainT::LayerType LayerType;
+
+		static inline LayerType& get(ChainT& chain) { return chain.getLayer(); }
+		static inline const LayerType& get(const ChainT& chain) { return chain.getLayer(); }
+	};
+
+
+	/**
+	Feed-forward neural network whose layers have different types given as the
+	template parameters (e.g. layers of neurons with different activation
+	functions or combinators). The structure is fixed at compile time so eval
+	and all the operations on the layers are unrolled and fully inlined. The
+	network has only the part of the interface of FeedForwardNetwork used by the
+	buffers, gradient evaluators, updaters and BackPropBase, so it can be trained
+	in the same way. It can't be copied and it doesn't save or restore weights,
+	count versions of them or eval with external buffers, so the batch trainers,
+	EvalCache, InferenceService and WeightsPublisher don't work with it. Single
+	layers are accessed by getLayer<INDEX>().
+	*/
+	template <typename... LayersT>
+	class StaticFeedForwardNetwork
+	{
+	public:
+		typedef LayersChain<LayersT...> ChainType;
+		typedef typename ChainType::InputType InputType;
+		typedef typename ChainType::OutputType OutputType;
+		typedef typename ChainType::WeightType WeightType;
+		typedef std::vector<size_t> LayersSizes;
+
+		static const size_t LAYERS_COUNT = sizeof...(LayersT);
+		static_assert(LAYERS_COUNT > 0, "the network has to have at least one layer");
+
+		/** Create the network with the given count of inputs and counts of neurons
+		of the single layers. Throw SizeMismatchException if the count of sizes
+		doesn't match the count of layers. */
+		StaticFeedForwardNetwork(size_t inputsCount, const LayersSizes& sizes) :
+		m_layers( inputsCount, checkSizes(sizes) )
+		{ }
+
+		inline const OutputType* eval(const InputType inputs[])
+		{
+			return m_layers.eval(inputs);
+		}
+
+		/** Eval the network for the given sparse input (see FeedForwardNetwork). */
+		inline const OutputType* eval(const SparseVector<InputType>& inputs)
+		{
+			return m_layers.eval(inputs);
+		}
+
+		void initWeights(const Initializer<WeightType>& initializer)
+		{
+			WeightsInit init = { initializer };
+			forEachLayer(init);
+		}
+
+		void initWeightsUniform(const Range<WeightType>& weightsRange)
+		{
+			RandomUniform<WeightType> random(weightsRange);
+			RandomInitializer<WeightType> init(random);
+			initWeights(init);
+		}
+
+		/** Perform the given function func(layer, index) on every layer from the
+		first one to the last one. */
+		template <typename Function>
+		inline void forEachLayer(Function& func) { m_layers.forEachLayer(func, 0); }
+
+		template <typename Function>
+		inline void forEachLayer(Function& func) const { m_layers.forEachLayer(func, 0); }
+
+		/** Perform the given function func(layer, index) on every layer from the
+		last one to the first one. */
+		template <typename Function>
+		inline void forEachLayerBackward(Function& func) const { m_layers.forEachLayerBackward(func, 0); }
+
+		/** Perform the given function on every input weight of the network. */
+		template <typename Function>
+		inline void forEachWeightForward(Function& func)
+		{
+			WeightsForward<Function> forward = { func };
+			forEachLayer(forward);
+		}
+
+		/** Perform the given function func(weights, index, count) on the block of
+		weights of every layer (see FeedForwardNetwork::forEachWeightsBlock()). */
+		template <typename Function>
+		inline void forEachWeightsBlock(Function& func)
+		{
+			WeightsBlocks<Function> blocks = { func, 0 };
+			forEachLayer(blocks);
+		}
+
+		/** Perform the given function on every neuron of the network. */
+		template <typename Function>
+		inline void forEachNeuronForward(Function& func)
+		{
+			NeuronsForward<Function> forward = { func };
+			forEachLayer(forward);
+		}
+
+		template <size_t INDEX>
+		inline typename LayersChainAccess<INDEX, ChainType>::LayerType& getLayer()
+		{
+			return LayersChainAccess<INDEX, ChainType>::get(m_layers);
+		}
+
+		template <size_t INDEX>
+		inline const typename LayersChainAccess<INDEX, ChainType>::LayerType& getLayer() const
+		{
+			return LayersChainAccess<INDEX, ChainType>::get(m_layers);
+		}
+
+		inline size_t getLayersCount() const { return LAYERS_COUNT; }
+
+		inline size_t getInputsCount() const { return getLayer<0>().getInputsCount(); }
+		inline size_t getOutputsCount() const { return getLayer<LAYERS_COUNT - 1>().getNeuronsCount(); }
+
+		size_t getNeuronsCount() const
+		{
+			LayoutCounter counter = { 0, 0, 0 };
+			forEachLayer(counter);
+			return counter.neurons;
+		}
+
+		size_t getWeightsCount() const
+		{
+			LayoutCounter counter = { 0, 0, 0 };
+			forEachLayer(counter);
+			return counter.weights;
+		}
+
+		/** Get count of values of all the weights blocks (including the padding). */
+		size_t getWeightsSize() const
+		{
+			LayoutCounter counter = { 0, 0, 0 };
+			forEachLayer(counter);
+			return counter.weightsSize;
+		}
+
+		inline const OutputType* getOutputCache() const
+		{
+			return getLayer<LAYERS_COUNT - 1>().getOutputCache();
+		}
+
+		/** Freeze the first given count of layers and unfreeze the others. */
+		void freezeLayers(size_t count)
+		{
+			LayersFreezer freezer = { count };
+			forEachLayer(freezer);
+		}
+
+		/** Get count of the frozen layers at the beginning of the network. */
+		size_t getFrozenPrefixLength() const
+		{
+			FrozenPrefixCounter counter = { 0 };
+			forEachLayer(counter);
+			return counter.count;
+		}
+
+	protected:
+		ChainType m_layers;
+
+		static const size_t* checkSizes(const LayersSizes& sizes)
+		{
+			if (sizes.size() != LAYERS_COUNT)
+				throw SizeMismatchException(LAYERS_COUNT, sizes.size());
+			return &sizes[0];
+		}
+
+		struct WeightsInit
+		{
+			const Initializer<WeightType>& initializer;
+
+			template <typename LayerT>
+			inline void operator()(LayerT& layer, size_t) { layer.initWeights(initializer); }
+		};
+
+		template <typename Function>
+		struct WeightsForward
+		{
+			Function& func;
+
+			template <typename LayerT>
+			inline void operator()(LayerT& layer, size_t) { layer.forEachWeightForward(func); }
+		};
+
+		template <typename Function>
+		struct NeuronsForward
+		{
+			Function& func;
+
+			template <typename LayerT>
+			inline void operator()(LayerT& layer, size_t) { layer.forEachNeuronForward(func); }
+		};
+
+		template <typename Function>
+		struct WeightsBlocks
+		{
+			Function& func;
+			size_t index;
+
+			template <typename LayerT>
+			inline void operator()(LayerT& layer, size_t)
+			{
+				func( layer.getWeights(), index, layer.getWeightsBlockSize() );
+				index += layer.getWeightsBlockSize();
+			}
+		};
+
+		struct LayersFreezer
+		{
+			size_t count;
+
+			template <typename LayerT>
+			inline void operator()(LayerT& layer, size_t index) { layer.setFrozen(index < count); }
+		};
+
+		struct FrozenPrefixCounter
+		{
+			size_t count;
+
+			template <typename LayerT>
+			inline void operator()(const LayerT& layer, size_t index)
+			{
+				if (index == count && layer.isFrozen())
+					++count;
+			}
+		};
+
+		/** Counts of neurons and weights summed over all the layers. */
+		struct LayoutCounter
+		{
+			size_t neurons, weights, weightsSize;
+
+			template <typename LayerT>
+			inline void operator()(const LayerT& layer, size_t)
+			{
+				neurons += layer.getNeuronsCount();
+				weights += layer.getWeightsCount();
+				weightsSize += layer.getWeightsBlockSize();
+			}
+		};
+
+	private:
+		StaticFeedForwardNetwork(const StaticFeedForwardNetwork&);
+		StaticFeedForwardNetwork& operator=(const StaticFeedForwardNetwork&);
+	};
+
+	template <typename... LayersT>
+	const size_t StaticFeedForwardNetwork<LayersT...>::LAYERS_COUNT;
+
+}
+
+#endif
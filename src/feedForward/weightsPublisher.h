@@ -0,0 +1,258 @@
+#ifndef _WEIGHTS_PUBLISHER_H_
+#define _WEIGHTS_PUBLISHER_H_
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include "common/exceptions.h"
+#include "common/utils.h"
+#include "common/memory.h"
+#include "backPropagation/monitor.h"
+
+namespace NNLib
+{
+
+	/**
+	Publisher of weights of a network trained in the same process as it is used
+	for inference (read-copy-update). The trainer works on its own network and
+	from time to time publishes its weights by publish() - they are copied to an
+	immutable snapshot (a copy of the network) which replaces the current one by
+	a single atomic pointer exchange. Readers evaluate the current snapshot by
+	its const methods (e.g. FeedForwardNetwork::eval() with their own buffer)
+	without any locks and they never see weights of two versions at once.
+
+	Every reader thread uses its own Reader which pins the snapshot it works on
+	in a slot (a hazard pointer). Replaced snapshots are reused by the next
+	publish() as soon as no slot pins them, so usually only two copies of the
+	network exist (double buffering).
+	*/
+	template <typename NetworkT>
+	class WeightsPublisher
+	{
+	public:
+		typedef NetworkT NetworkType;
+
+		/** Default maximal count of readers at once. */
+		static const size_t DEF_MAX_READERS;
+
+		/** Immutable published copy of the network. */
+		class Snapshot
+		{
+		public:
+			inline const NetworkType& getNetwork() const { return m_network; }
+
+			/** Get number of the publish() the snapshot was created by (0 for the
+			initial one). */
+			inline size_t getVersion() const { return m_version; }
+
+		protected:
+			friend class WeightsPublisher;
+
+			Snapshot(const NetworkType& network, size_t version) :
+			m_network(network), m_version(version)
+			{ }
+
+			NetworkType m_network;
+			size_t m_version;
+		};
+
+		/**
+		Reader of the published snapshots for one thread. The snapshot returned by
+		acquire() stays valid until release(), the next acquire() or destruction
+		of the reader.
+		*/
+		class Reader
+		{
+		public:
+			/** Take a free slot of the publisher. Throw ReadersLimitException if
+			there is none. */
+			Reader(WeightsPublisher& publisher) :
+			m_publisher(publisher), m_slot( publisher.takeSlot() )
+			{ }
+
+			~Reader()
+			{
+				release();
+				m_slot.taken.store(false, std::memory_order_release);
+			}
+
+			/** Pin and get the latest published snapshot. */
+			const Snapshot& acquire()
+			{
+				Snapshot *snapshot = m_publisher.m_current.load(std::memory_order_acquire);
+				for (;;) {
+					// the snapshot is safe once it's pinned and still published
+					m_slot.snapshot.store(snapshot, std::memory_order_seq_cst);
+					Snapshot *current = m_publisher.m_current.load(std::memory_order_seq_cst);
+					if (current == snapshot)
+						return *snapshot;
+					snapshot = current;
+				}
+			}
+
+			/** Unpin the snapshot so it can be reused by the publisher. */
+			inline void release()
+			{
+				m_slot.snapshot.store(NULL, std::memory_order_release);
+			}
+
+		protected:
+			WeightsPublisher& m_publisher;
+			typename WeightsPublisher::ReaderSlot& m_slot;
+
+		private:
+			Reader(const Reader&);
+			Reader& operator=(const Reader&);
+		};
+
+		/** Publish copy of the given network as the initial snapshot. */
+		WeightsPublisher(const NetworkType& network, size_t maxReaders = DEF_MAX_READERS) :
+		m_slotsCount(maxReaders), m_slots(new ReaderSlot[maxReaders]),
+		m_current( new Snapshot(network, 0) ), m_version(0)
+		{ }
+
+		/** Delete all the snapshots - there mustn't be any readers left. */
+		~WeightsPublisher()
+		{
+			delete m_current.load();
+			deleteRange( m_retired.begin(), m_retired.end() );
+			deleteRange( m_free.begin(), m_free.end() );
+			delete [] m_slots;
+		}
+
+		/** Publish weights of the given network (of the same layers sizes as the
+		published one) as a new snapshot. Readers get it by their next acquire().
+		More trainers can publish at once, they are serialized by a lock. */
+		void publish(const NetworkType& network)
+		{
+			std::lock_guard<std::mutex> lock(m_publishMutex);
+			reclaim();
+
+			// fill a free snapshot (or a new one) with the weights
+			Snapshot *snapshot;
+			if ( m_free.empty() )
+				snapshot = new Snapshot(network, 0);
+			else {
+				snapshot = m_free.back();
+				m_free.pop_back();
+				snapshot->m_network.copyWeights(network);
+			}
+			const size_t version = m_version.load(std::memory_order_relaxed) + 1;
+			snapshot->m_version = version;
+
+			m_retired.push_back( m_current.exchange(snapshot, std::memory_order_seq_cst) );
+			m_version.store(version, std::memory_order_release);
+			reclaim();
+		}
+
+		/** Get version of the latest published snapshot. */
+		inline size_t getVersion() const { return m_version.load(std::memory_order_acquire); }
+
+		inline size_t getMaxReaders() const { return m_slotsCount; }
+
+		/** Get count of the snapshots which still can't be reused. */
+		inline size_t getRetiredCount() const
+		{
+			std::lock_guard<std::mutex> lock(m_publishMutex);
+			return m_retired.size();
+		}
+
+	protected:
+		/** Slot of one reader - each one on its own cache line. */
+		struct alignas(CACHE_LINE_SIZE) ReaderSlot
+		{
+			std::atomic<bool> taken;
+			std::atomic<Snapshot*> snapshot;
+
+			ReaderSlot() :
+			taken(false), snapshot(NULL)
+			{ }
+		};
+
+		const size_t m_slotsCount;
+		ReaderSlot *m_slots;
+
+		/** The latest published snapshot. */
+		std::atomic<Snapshot*> m_current;
+
+		/** Version of the latest published snapshot (it can't be read through
+		m_current without pinning it). */
+		std::atomic<size_t> m_version;
+
+		/** Replaced snapshots which may be still pinned by some readers. */
+		std::vector<Snapshot*> m_retired;
+
+		/** Replaced snapshots which aren't pinned by any reader. */
+		std::vector<Snapshot*> m_free;
+
+		mutable std::mutex m_publishMutex;
+
+		ReaderSlot& takeSlot()
+		{
+			for (size_t i = 0; i < m_slotsCount; ++i) {
+				bool expected = false;
+				if ( m_slots[i].taken.compare_exchange_strong(expected, true, std::memory_order_acquire) )
+					return m_slots[i];
+			}
+			throw ReadersLimitException(m_slotsCount);
+		}
+
+		/** Move the retired snapshots which aren't pinned to the free ones. */
+		void reclaim()
+		{
+			for (size_t i = 0; i < m_retired.size(); )
+			{
+				if ( isPinned(m_retired[i]) )
+					++i;
+				else {
+					m_free.push_back(m_retired[i]);
+					m_retired[i] = m_retired.back();
+					m_retired.pop_back();
+				}
+			}
+		}
+
+		bool isPinned(const Snapshot *snapshot) const
+		{
+			for (size_t i = 0; i < m_slotsCount; ++i)
+				if ( m_slots[i].snapshot.load(std::memory_order_seq_cst) == snapshot )
+					return true;
+			return false;
+		}
+
+	private:
+		WeightsPublisher(const WeightsPublisher&);
+		WeightsPublisher& operator=(const WeightsPublisher&);
+	};
+
+	template <typename NetworkT>
+	const size_t WeightsPublisher<NetworkT>::DEF_MAX_READERS = 64;
+
+
+	/**
+	Monitor publishing weights of the trained network by the given publisher
+	(e.g. every timer-th step of BackPropBase::run()).
+	*/
+	template <typename NetworkT>
+	class PublishingMonitor :
+		public Monitor
+	{
+	public:
+		PublishingMonitor(WeightsPublisher<NetworkT>& publisher, const NetworkT& network,
+			unsigned timer = DEF_TIMER) :
+		Monitor(timer), m_publisher(publisher), m_network(network)
+		{ }
+
+		virtual void execute()
+		{
+			m_publisher.publish(m_network);
+		}
+
+	protected:
+		WeightsPublisher<NetworkT>& m_publisher;
+		const NetworkT& m_network;
+	};
+
+}
+
+#endif
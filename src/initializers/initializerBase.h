@@ -1,19 +1,19 @@
-#ifndef _INITIALIZER_BASE_H_
-#define _INITIALIZER_BASE_H_
-
-namespace NNLib
-{
-
-	/**
-	Base template class for every initializer.
-	*/
-	template <typename T>
-	class InitializerBase
-	{
-	public:
-		typedef T ValueType;
-	};
-
-}
-
+#ifndef _INITIALIZER_BASE_H_
+#define _INITIALIZER_BASE_H_
+
+namespace NNLib
+{
+
+	/**
+	Base template class for every initializer.
+	*/
+	template <typename T>
+	class InitializerBase
+	{
+	public:
+		typedef T ValueType;
+	};
+
+}
+
 #endif
\ No newline at end of file
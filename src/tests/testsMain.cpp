@@ -0,0 +1,675 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <future>
+#include <atomic>
+#include "common/range.h"
+#include "common/cholesky.h"
+#include "activationFunctions/sigmoidFunc.h"
+#include "activationFunctions/reluFunc.h"
+#include "combinators/dotProduct.h"
+#include "initializers/constantInitializer.h"
+#include "neurons/neuronBase.h"
+#include "feedForward/feedForwardLayer.h"
+#include "feedForward/feedForwardNetwork.h"
+#include "feedForward/networkBufferAllocator.h"
+#include "feedForward/staticFeedForwardNetwork.h"
+#include "feedForward/softmaxLayer.h"
+#include "feedForward/inferenceService.h"
+#include "feedForward/evalCache.h"
+#include "feedForward/weightsPublisher.h"
+#include "data/inOutData.h"
+#include "data/iterCycleAccessor.h"
+#include "backPropagation/accumulator.h"
+#include "backPropagation/distance.h"
+#include "backPropagation/backPropBase.h"
+#include "backPropagation/gradientEvaluator.h"
+#include "backPropagation/weightsUpdater.h"
+#include "backPropagation/batchTrainer.h"
+#include "backPropagation/levenbergMarquardt.h"
+
+using namespace NNLib;
+
+/*
+Deterministic checks of the numerical code - the solvers, the batch trainers,
+the fused training, the static network, the quantile sketch, the inference
+service, the weights publisher and the evaluation cache. Usage:
+  tests
+Every check prints its name and result, the exit code is the count of the
+failed checks. Random numbers are seeded by a constant before every check.
+*/
+
+namespace
+{
+	const unsigned SEED = 7;
+
+	typedef InOutData< InOutPair<float> > Data;
+	typedef std::vector< InOutPair<float> > Container;
+
+	typedef FeedForwardNetwork< FeedForwardLayer< NeuronBase<float, SigmoidFunc, DotProduct> > > Network;
+
+	/** Report the failed condition and return false from the check. */
+	#define TEST_CHECK(cond) \
+		do { \
+			if ( !(cond) ) { \
+				std::cerr << "  " << __FILE__ << ":" << __LINE__ << ": " << #cond << std::endl; \
+				return false; \
+			} \
+		} while (0)
+
+	Network::LayersSizes getLayersSizes(size_t first, size_t second, size_t third = 0)
+	{
+		Network::LayersSizes sizes;
+		sizes.push_back(first);
+		sizes.push_back(second);
+		if (third > 0)
+			sizes.push_back(third);
+		return sizes;
+	}
+
+	/** Patterns of the parity problems: outputs are XORs of the neighbouring
+	bits of the input (of the first two bits only if there is one output). */
+	void fillParity(Data& data)
+	{
+		const size_t inputsCount = data.getInputLen(), outputsCount = data.getOutputLen();
+		std::vector<float> in(inputsCount), out(outputsCount);
+		for (size_t p = 0; p < (size_t(1) << inputsCount); ++p) {
+			for (size_t i = 0; i < inputsCount; ++i)
+				in[i] = static_cast<float>( (p >> i) & 1 );
+			for (size_t i = 0; i < outputsCount; ++i)
+				out[i] = static_cast<float>( ((p >> i) & 1) ^ ((p >> (i + 1)) & 1) );
+			data.add(&in[0], &out[0]);
+		}
+	}
+
+	/** Fill the data by the given count of random binary patterns. */
+	void fillRandom(Data& data, size_t patternsCount)
+	{
+		std::vector<float> in( data.getInputLen() ), out( data.getOutputLen() );
+		for (size_t p = 0; p < patternsCount; ++p) {
+			for (size_t i = 0; i < in.size(); ++i)
+				in[i] = static_cast<float>( ::rand() % 2 );
+			for (size_t i = 0; i < out.size(); ++i)
+				out[i] = in[(i * 3) % in.size()];
+			data.add(&in[0], &out[0]);
+		}
+	}
+
+	Container toContainer(const Data& data)
+	{
+		Container container;
+		for (size_t p = 0; p < data.size(); ++p)
+			container.push_back(data[p]);
+		return container;
+	}
+
+
+	/** A x = b for a known matrix with the factor L = [2 0 0; 6 1 0; -8 5 3]. */
+	bool checkCholesky()
+	{
+		const size_t N = 3;
+		double a[N * N] = {
+			4, 12, -16,
+			0, 37, -43,
+			0,  0,  98 };
+		double b[N] = { -20, -43, 192 };
+		const double x[N] = { 1, 2, 3 };
+		const double diagonal[N] = { 2, 1, 3 };
+
+		double factorDiagonal[N];
+		TEST_CHECK( choleskyFactor(a, N, 0.0, factorDiagonal) );
+		for (size_t i = 0; i < N; ++i)
+			TEST_CHECK( std::fabs(factorDiagonal[i] - diagonal[i]) < 1e-12 );
+		TEST_CHECK( std::fabs(a[1 * N + 0] - 6) < 1e-12 && std::fabs(a[2 * N + 1] - 5) < 1e-12 );
+
+		choleskySolve(a, N, factorDiagonal, b);
+		for (size_t i = 0; i < N; ++i)
+			TEST_CHECK( std::fabs(b[i] - x[i]) < 1e-12 );
+
+		// the upper triangle stays for another shift, a negative one breaks the definiteness
+		TEST_CHECK( a[0 * N + 1] == 12 && a[2 * N + 2] == 98 );
+		TEST_CHECK( !choleskyFactor(a, N, -4.0, factorDiagonal) );
+		return true;
+	}
+
+	/** The batch trainer reaches a small error on the given problem. */
+	template <typename TrainerT>
+	bool checkConvergence(TrainerT& trainer, size_t epochsCount, double maxError)
+	{
+		trainer.run(epochsCount);
+		TEST_CHECK( trainer.getError() < maxError );
+		return true;
+	}
+
+	bool checkScaledConjugateGradient()
+	{
+		Network network( 2, getLayersSizes(4, 1) );
+		network.initWeightsUniform( Range<float>(-1, 1) );
+		Data data(2, 1);
+		fillParity(data);
+		Container container = toContainer(data);
+
+		ScaledConjugateGradient<Network, Container> trainer(network, container, 1);
+		return checkConvergence(trainer, 500, 1e-3);
+	}
+
+	bool checkLBFGS()
+	{
+		Network network( 2, getLayersSizes(4, 1) );
+		network.initWeightsUniform( Range<float>(-1, 1) );
+		Data data(2, 1);
+		fillParity(data);
+		Container container = toContainer(data);
+
+		LBFGS<Network, Container> trainer(network, container, 5, 1);
+		return checkConvergence(trainer, 500, 1e-3);
+	}
+
+	/** L-BFGS checking that every stored pair matches its rho = 1 / (s . y). */
+	class CheckedLBFGS :
+		public LBFGS<Network, Container>
+	{
+	public:
+		CheckedLBFGS(Network& network, const Container& data, size_t historySize) :
+		LBFGS<Network, Container>(network, data, historySize, 1)
+		{ }
+
+		bool isHistoryConsistent() const
+		{
+			for (size_t i = 0; i < m_storedCount; ++i) {
+				const size_t k = getStored(i);
+				const double curvature = this->dot(*m_steps[k], *m_changes[k]);
+				if ( std::fabs(m_rhos[k] * curvature - 1) > 1e-6 )
+					return false;
+			}
+			return true;
+		}
+	};
+
+	/** A short history is full most of the time, so the rejected pairs mustn't
+	damage the stored ones. */
+	bool checkLBFGSShortHistory()
+	{
+		Network network( 3, getLayersSizes(4, 3, 2) );
+		network.initWeightsUniform( Range<float>(-1, 1) );
+		Data data(3, 2);
+		fillParity(data);
+		Container container = toContainer(data);
+
+		CheckedLBFGS trainer(network, container, 3);
+		for (size_t epoch = 0; epoch < 500 && trainer.run(1) > 0; ++epoch)
+			TEST_CHECK( trainer.isHistoryConsistent() );
+		TEST_CHECK( trainer.getError() < 1e-3 );
+		return true;
+	}
+
+	bool checkLevenbergMarquardt()
+	{
+		Network network( 2, getLayersSizes(4, 1) );
+		network.initWeightsUniform( Range<float>(-1, 1) );
+		Data data(2, 1);
+		fillParity(data);
+		Container container = toContainer(data);
+
+		LevenbergMarquardt<Network, Container> trainer(network, container, 1);
+		return checkConvergence(trainer, 200, 1e-3);
+	}
+
+	/** Fused gradient and update gives the same weights as the split phases. */
+	template <template <typename> class UpdaterT>
+	bool checkFusedUpdate(size_t frozenLayer)
+	{
+		Network original( 5, getLayersSizes(9, 7, 3) );
+		original.initWeightsUniform( Range<float>(-0.5f, 0.5f) );
+		if (frozenLayer > 0)
+			original[frozenLayer].setFrozen(true);
+		Data data(5, 3);
+		fillRandom(data, 40);
+
+		Network split(original), fused(original);
+		BackPropBase<Network, DeltaGradientEvaluator, UpdaterT> splitBackProp(split), fusedBackProp(fused);
+		fusedBackProp.setFusedUpdate(true);
+		IterCycleAccessor<Data> splitAccessor(data, 1, 5), fusedAccessor(data, 1, 5);
+		splitBackProp.run(splitAccessor);
+		fusedBackProp.run(fusedAccessor);
+
+		WeightsBuffer<float> originalWeights(original), splitWeights(split), fusedWeights(fused);
+		original.saveWeights(originalWeights);
+		split.saveWeights(splitWeights);
+		fused.saveWeights(fusedWeights);
+
+		bool moved = false;
+		for (size_t i = 0; i < splitWeights.getSize(); ++i) {
+			TEST_CHECK( splitWeights.getData()[i] == fusedWeights.getData()[i] );
+			moved = moved || ( splitWeights.getData()[i] != originalWeights.getData()[i] );
+		}
+		TEST_CHECK(moved);
+
+		if (frozenLayer > 0)
+			for (size_t i = 0; i < split[frozenLayer].getWeightsBlockSize(); ++i)
+				TEST_CHECK( fused[frozenLayer].getWeights()[i] == original[frozenLayer].getWeights()[i] );
+		return true;
+	}
+
+	bool checkFusedStandardUpdate() { return checkFusedUpdate<StandardUpdater>(0); }
+	bool checkFusedAdamUpdate() { return checkFusedUpdate<AdamUpdater>(0); }
+	bool checkFusedFrozenUpdate() { return checkFusedUpdate<RpropUpdater>(1); }
+
+	typedef StaticFeedForwardNetwork< FeedForwardLayer< NeuronBase<float, ReLUFunc, DotProduct> >,
+		SoftmaxLayer< NeuronBase<float, SigmoidFunc, DotProduct> > > StaticNetwork;
+
+	/** Copy the weights blocks of a network to the array or back. */
+	struct WeightsBlocksCopier
+	{
+		float *data;
+		bool save;
+
+		void operator()(float weights[], size_t index, size_t count)
+		{
+			if (save)
+				std::copy(weights, weights + count, data + index);
+			else
+				std::copy(data + index, data + index + count, weights);
+		}
+	};
+
+	/** Mean cross-entropy of the network on the data. Return a negative value
+	if any outputs don't sum to one. */
+	double getCrossEntropy(StaticNetwork& network, const Data& data)
+	{
+		CrossEntropyDistance<float> distance;
+		double error = 0;
+		for (size_t p = 0; p < data.size(); ++p) {
+			const float *output = network.eval( data[p].getInput() );
+			const float sum = std::accumulate( output, output + network.getOutputsCount(), 0.0f );
+			if (std::fabs(sum - 1) > 1e-5f)
+				return -1;
+			error += distance( output, data[p].getOutput(), network.getOutputsCount() );
+		}
+		return error / data.size();
+	}
+
+	/** Mixed static network (ReLU hidden layer and softmax outputs) trained by
+	BackPropBase: the outputs are probabilities, the cross-entropy decreases
+	and the fused update gives the same weights as the split phases. */
+	bool checkStaticSoftmaxTraining()
+	{
+		const size_t CLASSES_COUNT = 3;
+		Data data(3, CLASSES_COUNT);
+		for (size_t p = 0; p < 30; ++p) {
+			const float in[] = { static_cast<float>(::rand() % 100) / 50 - 1, static_cast<float>(::rand() % 100) / 50 - 1, 1 };
+			float out[CLASSES_COUNT] = { 0, 0, 0 };
+			out[ in[0] > 0.3f ? 0 : (in[1] > 0 ? 1 : 2) ] = 1;
+			data.add(in, out);
+		}
+
+		StaticNetwork::LayersSizes sizes;
+		sizes.push_back(8);
+		sizes.push_back(CLASSES_COUNT);
+		StaticNetwork split(3, sizes), fused(3, sizes);
+		split.initWeightsUniform( Range<float>(-0.5f, 0.5f) );
+		std::vector<float> weights( split.getWeightsSize() );
+		WeightsBlocksCopier saver = { &weights[0], true }, restorer = { &weights[0], false };
+		split.forEachWeightsBlock(saver);
+		fused.forEachWeightsBlock(restorer);
+
+		const double initialError = getCrossEntropy(split, data);
+		TEST_CHECK(initialError > 0);
+
+		BackPropBase<StaticNetwork, DeltaGradientEvaluator, StandardUpdater> splitBackProp(split), fusedBackProp(fused);
+		splitBackProp.setLearningRate(0.1f);
+		fusedBackProp.setLearningRate(0.1f);
+		fusedBackProp.setFusedUpdate(true);
+		IterCycleAccessor<Data> splitAccessor(data, 1, 100), fusedAccessor(data, 1, 100);
+		splitBackProp.run(splitAccessor);
+		fusedBackProp.run(fusedAccessor);
+
+		const double error = getCrossEntropy(split, data);
+		TEST_CHECK( error >= 0 && error < initialError );
+
+		std::vector<float> fusedWeights( fused.getWeightsSize() );
+		WeightsBlocksCopier fusedSaver = { &fusedWeights[0], true };
+		split.forEachWeightsBlock(saver);
+		fused.forEachWeightsBlock(fusedSaver);
+		TEST_CHECK( weights == fusedWeights );
+		return true;
+	}
+
+	/** Quantiles of 1..1000 (shuffled) within the relative accuracy, merging
+	of the halves and the non-finite values. */
+	bool checkQuantiles()
+	{
+		const size_t COUNT = 1000;
+		const double ACCURACY = 0.01;
+		std::vector<float> values;
+		for (size_t i = 1; i <= COUNT; ++i)
+			values.push_back( static_cast<float>(i) );
+		for (size_t i = COUNT - 1; i > 0; --i)
+			std::swap( values[i], values[ ::rand() % (i + 1) ] );
+
+		QuantileAccumulator<float> all(0.5, ACCURACY), first(0.5, ACCURACY), second(0.5, ACCURACY);
+		for (size_t i = 0; i < COUNT; ++i) {
+			all.accum(values[i]);
+			(i < COUNT / 2 ? first : second).accum(values[i]);
+		}
+		first.merge(second);
+
+		const double FRACTIONS[] = { 0.0, 0.1, 0.5, 0.9, 0.99, 1.0 };
+		for (size_t i = 0; i < sizeof(FRACTIONS) / sizeof(FRACTIONS[0]); ++i) {
+			const double expected = 1 + FRACTIONS[i] * (COUNT - 1);
+			TEST_CHECK( std::fabs(all.getQuantile(FRACTIONS[i]) - expected) <= ACCURACY * expected + 1 );
+			TEST_CHECK( all.getQuantile(FRACTIONS[i]) == first.getQuantile(FRACTIONS[i]) );
+		}
+		TEST_CHECK( first.getCount() == COUNT );
+
+		const float INF = std::numeric_limits<float>::infinity();
+		all.accum(INF);
+		all.accum(-INF);
+		all.accum( std::numeric_limits<float>::quiet_NaN() );
+		TEST_CHECK( all.getCount() == COUNT + 2 && all.getNaNCount() == 1 );
+		TEST_CHECK( all.getQuantile(0) == -INF && all.getQuantile(1) == INF );
+		TEST_CHECK( std::fabs(all.getAccumVal() - 500.5) <= ACCURACY * 500.5 + 1 );
+		return true;
+	}
+
+	/** Network failing the batches which contain a negative input. */
+	class FailingNetwork :
+		public Network
+	{
+	public:
+		FailingNetwork(size_t inputsCount, const LayersSizes& layersSizes) :
+		Network(inputsCount, layersSizes)
+		{ }
+
+		const OutputType* evalBatch(const InputType inputs[], size_t count, OutputType **buffer) const
+		{
+			for (size_t i = 0; i < count * getInputsCount(); ++i)
+				if (inputs[i] < 0)
+					throw std::runtime_error("negative input");
+			return Network::evalBatch(inputs, count, buffer);
+		}
+	};
+
+	typedef InferenceService<FailingNetwork> Service;
+
+	/** The outputs of the service are the ones of FeedForwardNetwork::eval(). */
+	bool isServed(const FailingNetwork& network, const std::vector<float>& input, std::future<Service::OutputVector>& result)
+	{
+		float **buffer = createOutputsBuffer<float>(network);
+		const float *expected = network.eval(&input[0], buffer);
+		const Service::OutputVector outputs = result.get();
+		const bool equal = std::equal( outputs.begin(), outputs.end(), expected ) &&
+			outputs.size() == network.getOutputsCount();
+		deleteOutputsBuffer(buffer);
+		return equal;
+	}
+
+	/** Concurrent submitters get the outputs of their inputs, a failed batch
+	doesn't stop the dispatcher and the destructor evaluates all the queued
+	requests. */
+	bool checkInferenceService()
+	{
+		const size_t THREADS_COUNT = 4, REQUESTS_COUNT = 400, INPUTS_COUNT = 5;
+		FailingNetwork network( INPUTS_COUNT, getLayersSizes(9, 3) );
+		network.initWeightsUniform( Range<float>(-1, 1) );
+
+		std::vector< std::vector<float> > inputs( REQUESTS_COUNT, std::vector<float>(INPUTS_COUNT) );
+		for (size_t r = 0; r < REQUESTS_COUNT; ++r)
+			for (size_t i = 0; i < INPUTS_COUNT; ++i)
+				inputs[r][i] = static_cast<float>( ::rand() ) / RAND_MAX;
+		std::vector< std::future<Service::OutputVector> > results(REQUESTS_COUNT);
+
+		{
+			Service service(network, 8, 100);
+			std::vector<std::thread> submitters;
+			for (size_t t = 0; t < THREADS_COUNT; ++t)
+				submitters.push_back( std::thread( [&, t]() {
+					for (size_t r = t; r < REQUESTS_COUNT; r += THREADS_COUNT)
+						results[r] = service.submit(&inputs[r][0]);
+				} ) );
+			for (size_t t = 0; t < THREADS_COUNT; ++t)
+				submitters[t].join();
+			for (size_t r = 0; r < REQUESTS_COUNT; ++r)
+				TEST_CHECK( isServed(network, inputs[r], results[r]) );
+			TEST_CHECK( service.getRequestsCount() == REQUESTS_COUNT );
+			TEST_CHECK( service.getBatchesCount() >= REQUESTS_COUNT / 8 );
+
+			std::vector<float> negative(INPUTS_COUNT, -1.0f);
+			std::future<Service::OutputVector> failed = service.submit(&negative[0]);
+			bool thrown = false;
+			try {
+				failed.get();
+			}
+			catch (const std::runtime_error&) {
+				thrown = true;
+			}
+			TEST_CHECK(thrown);
+			results[0] = service.submit(&inputs[0][0]);
+			TEST_CHECK( isServed(network, inputs[0], results[0]) );
+		}
+
+		{
+			// a batch would wait far longer than the test
+			Service service(network, REQUESTS_COUNT + 1, 60000000);
+			for (size_t r = 0; r < REQUESTS_COUNT; ++r)
+				results[r] = service.submit(&inputs[r][0]);
+		}
+		for (size_t r = 0; r < REQUESTS_COUNT; ++r) {
+			TEST_CHECK( results[r].wait_for( std::chrono::seconds(0) ) == std::future_status::ready );
+			TEST_CHECK( isServed(network, inputs[r], results[r]) );
+		}
+		return true;
+	}
+
+	/** All the weights of the network (not the padding of their rows) are
+	equal to the given value. */
+	bool isFilledBy(const Network& network, float value)
+	{
+		for (size_t layer = 0; layer < network.getLayersCount(); ++layer) {
+			const Network::LayerType& currLayer = network[layer];
+			for (size_t n = 0; n < currLayer.getNeuronsCount(); ++n) {
+				const float *weights = currLayer.getWeights() + n * currLayer.getWeightsStride();
+				for (size_t i = 0; i < currLayer.getInputsCount(); ++i)
+					if (weights[i] != value)
+						return false;
+			}
+		}
+		return true;
+	}
+
+	/** Readers racing with the publisher see only whole snapshots - every weight
+	equals the version of the snapshot - and the snapshots are reused. */
+	bool checkWeightsPublisher()
+	{
+		const size_t READERS_COUNT = 3, VERSIONS_COUNT = 20000;
+		Network network( 20, getLayersSizes(50, 20) );
+		network.initWeights( ConstantInitializer<float>(0) );
+		WeightsPublisher<Network> publisher(network, READERS_COUNT);
+
+		std::atomic<bool> published(false);
+		std::atomic<size_t> tornCount(0), reversedCount(0);
+		std::vector<std::thread> readers;
+		for (size_t t = 0; t < READERS_COUNT; ++t)
+			readers.push_back( std::thread( [&]() {
+				WeightsPublisher<Network>::Reader reader(publisher);
+				size_t lastVersion = 0;
+				while ( !published.load() ) {
+					const WeightsPublisher<Network>::Snapshot& snapshot = reader.acquire();
+					if ( !isFilledBy( snapshot.getNetwork(), static_cast<float>( snapshot.getVersion() ) ) )
+						++tornCount;
+					if (snapshot.getVersion() < lastVersion)
+						++reversedCount;
+					lastVersion = snapshot.getVersion();
+					reader.release();
+				}
+			} ) );
+
+		for (size_t version = 1; version <= VERSIONS_COUNT; ++version) {
+			network.initWeights( ConstantInitializer<float>( static_cast<float>(version) ) );
+			publisher.publish(network);
+			TEST_CHECK( publisher.getRetiredCount() <= READERS_COUNT );
+		}
+		published.store(true);
+		for (size_t t = 0; t < READERS_COUNT; ++t)
+			readers[t].join();
+
+		TEST_CHECK( tornCount.load() == 0 && reversedCount.load() == 0 );
+		TEST_CHECK( publisher.getVersion() == VERSIONS_COUNT );
+		publisher.publish(network);
+		TEST_CHECK( publisher.getRetiredCount() == 0 );
+		return true;
+	}
+
+	/** Outputs of the random inputs (in rows) evaluated by FeedForwardNetwork::eval(). */
+	std::vector<float> evalInputs(const Network& network, const std::vector<float>& inputs)
+	{
+		const size_t inputsCount = network.getInputsCount(), outputsCount = network.getOutputsCount();
+		const size_t count = inputs.size() / inputsCount;
+		float **buffer = createOutputsBuffer<float>(network);
+		std::vector<float> outputs(count * outputsCount);
+		for (size_t p = 0; p < count; ++p) {
+			const float *output = network.eval(&inputs[p * inputsCount], buffer);
+			std::copy( output, output + outputsCount, &outputs[p * outputsCount] );
+		}
+		deleteOutputsBuffer(buffer);
+		return outputs;
+	}
+
+	std::vector<float> getRandomInputs(size_t count)
+	{
+		std::vector<float> inputs(count);
+		for (size_t i = 0; i < count; ++i)
+			inputs[i] = static_cast<float>( ::rand() ) / RAND_MAX;
+		return inputs;
+	}
+
+	/** A miss is cached and hit next time, changed weights invalidate the
+	cache and a batch evaluates only the missed inputs. */
+	bool checkEvalCache()
+	{
+		const size_t INPUTS_COUNT = 6, OUTPUTS_COUNT = 3, PATTERNS_COUNT = 20;
+		Network network( INPUTS_COUNT, getLayersSizes(10, OUTPUTS_COUNT) );
+		network.initWeightsUniform( Range<float>(-1, 1) );
+		EvalCache<Network> cache(network, 256);
+		float **buffer = createOutputsBuffer<float>(network, PATTERNS_COUNT);
+
+		const std::vector<float> inputs = getRandomInputs(PATTERNS_COUNT * INPUTS_COUNT);
+		std::vector<float> expected = evalInputs(network, inputs);
+		float output[OUTPUTS_COUNT];
+		TEST_CHECK( !cache.find(&inputs[0], output) );
+		TEST_CHECK( !cache.eval(&inputs[0], output, buffer) );
+		TEST_CHECK( std::equal(output, output + OUTPUTS_COUNT, &expected[0]) );
+		std::fill(output, output + OUTPUTS_COUNT, 0.0f);
+		TEST_CHECK( cache.eval(&inputs[0], output, buffer) );
+		TEST_CHECK( std::equal(output, output + OUTPUTS_COUNT, &expected[0]) );
+		TEST_CHECK( cache.getHitsCount() == 1 );
+
+		cache.insert(&inputs[INPUTS_COUNT], &expected[OUTPUTS_COUNT]);
+		TEST_CHECK( cache.find(&inputs[INPUTS_COUNT], output) );
+		TEST_CHECK( std::equal(output, output + OUTPUTS_COUNT, &expected[OUTPUTS_COUNT]) );
+
+		// new weights make all the cached outputs invalid
+		const size_t version = network.getWeightsVersion();
+		network.initWeightsUniform( Range<float>(-1, 1) );
+		TEST_CHECK( network.getWeightsVersion() != version );
+		expected = evalInputs(network, inputs);
+		TEST_CHECK( !cache.find(&inputs[INPUTS_COUNT], output) );
+		TEST_CHECK( !cache.eval(&inputs[0], output, buffer) );
+		TEST_CHECK( std::equal(output, output + OUTPUTS_COUNT, &expected[0]) );
+
+		// the first half is cached, the batch evaluates the rest
+		const size_t HALF = PATTERNS_COUNT / 2;
+		for (size_t p = 1; p < HALF; ++p)
+			cache.eval(&inputs[p * INPUTS_COUNT], output, buffer);
+		std::vector<float> outputs(PATTERNS_COUNT * OUTPUTS_COUNT);
+		TEST_CHECK( cache.evalBatch(&inputs[0], PATTERNS_COUNT, &outputs[0], buffer) == HALF );
+		const float *batchOutputs = network.evalBatch(&inputs[0], PATTERNS_COUNT, buffer);
+		for (size_t p = 0; p < PATTERNS_COUNT; ++p)
+			TEST_CHECK( std::equal( batchOutputs + p * (OUTPUTS_COUNT + 1), batchOutputs + p * (OUTPUTS_COUNT + 1) + OUTPUTS_COUNT,
+				&outputs[p * OUTPUTS_COUNT] ) );
+		TEST_CHECK( cache.evalBatch(&inputs[0], PATTERNS_COUNT, &outputs[0], buffer) == PATTERNS_COUNT );
+
+		deleteOutputsBuffer(buffer);
+		return true;
+	}
+
+	/** Readers racing with an inserting thread over a cache smaller than the
+	inputs get only the outputs of their own inputs. */
+	bool checkEvalCacheConcurrent()
+	{
+		const size_t READERS_COUNT = 3, INPUTS_COUNT = 64, OUTPUTS_COUNT = 32, PATTERNS_COUNT = 512, ROUNDS_COUNT = 200;
+		Network network( INPUTS_COUNT, getLayersSizes(10, OUTPUTS_COUNT) );
+		network.initWeightsUniform( Range<float>(-1, 1) );
+		EvalCache<Network> cache(network, 64, 4);
+
+		const std::vector<float> inputs = getRandomInputs(PATTERNS_COUNT * INPUTS_COUNT);
+		const std::vector<float> expected = evalInputs(network, inputs);
+
+		std::atomic<bool> inserted(false);
+		std::atomic<size_t> wrongCount(0), hitsCount(0);
+		std::vector<std::thread> readers;
+		for (size_t t = 0; t < READERS_COUNT; ++t)
+			readers.push_back( std::thread( [&, t]() {
+				float output[OUTPUTS_COUNT];
+				for (size_t p = t; !inserted.load(); p = (p + 7) % PATTERNS_COUNT)
+					if ( cache.find(&inputs[p * INPUTS_COUNT], output) ) {
+						++hitsCount;
+						if ( !std::equal(output, output + OUTPUTS_COUNT, &expected[p * OUTPUTS_COUNT]) )
+							++wrongCount;
+					}
+			} ) );
+
+		for (size_t round = 0; round < ROUNDS_COUNT; ++round)
+			for (size_t p = 0; p < PATTERNS_COUNT; ++p)
+				cache.insert(&inputs[p * INPUTS_COUNT], &expected[p * OUTPUTS_COUNT]);
+		inserted.store(true);
+		for (size_t t = 0; t < READERS_COUNT; ++t)
+			readers[t].join();
+
+		TEST_CHECK( wrongCount.load() == 0 );
+		TEST_CHECK( hitsCount.load() > 0 );
+		return true;
+	}
+
+	struct Check
+	{
+		const char *name;
+		bool (*func)();
+	};
+
+}
+
+int main(int, char *[])
+{
+	const Check CHECKS[] = {
+		{ "choleskySolve", checkCholesky },
+		{ "ScaledConjugateGradient", checkScaledConjugateGradient },
+		{ "LBFGS", checkLBFGS },
+		{ "LBFGS(short history)", checkLBFGSShortHistory },
+		{ "LevenbergMarquardt", checkLevenbergMarquardt },
+		{ "fused StandardUpdater", checkFusedStandardUpdate },
+		{ "fused AdamUpdater", checkFusedAdamUpdate },
+		{ "fused RpropUpdater(frozen layer)", checkFusedFrozenUpdate },
+		{ "static network with softmax", checkStaticSoftmaxTraining },
+		{ "QuantileAccumulator", checkQuantiles },
+		{ "InferenceService", checkInferenceService },
+		{ "WeightsPublisher", checkWeightsPublisher },
+		{ "EvalCache", checkEvalCache },
+		{ "EvalCache(concurrent)", checkEvalCacheConcurrent }
+	};
+
+	int failedCount = 0;
+	for (size_t i = 0; i < sizeof(CHECKS) / sizeof(CHECKS[0]); ++i) {
+		::srand(SEED);
+		const bool passed = CHECKS[i].func();
+		std::cout << CHECKS[i].name << ": " << (passed ? "OK" : "FAILED") << std::endl;
+		if (!passed)
+			++failedCount;
+	}
+	return failedCount;
+}